@@ -8,8 +8,29 @@
 #include <cstring>
 #include <string>
 #include <sstream>          // need for tostr() function
-#include <cstdio>           // need for popen() function in BlackCore::executeShellCmd()
+#include <cstdio>           // need for rename() function in BlackDiscoveryIndex::saveCacheFile()
+#include <cerrno>
+#include <spawn.h>          // need for posix_spawnp() function in BlackCore::executeCommand()
+#include <sys/wait.h>       // need for waitpid() function in BlackCore::executeCommand()
 #include <dirent.h>         // need for dirent struct in BlackCore::searchDirectory()
+#include <fstream>          // need for slots file access in BlackCore::loadOverlay()
+#include <set>              // need for loaded overlay names in BlackCore::loadOverlay()
+#include <vector>
+#include <unordered_map>    // need for lookup tables of BlackDiscoveryIndex
+#include <mutex>            // need for locking of BlackDiscoveryIndex
+#include <sys/stat.h>       // need for stat() function in BlackDiscoveryIndex::loadCacheFile()
+#include <sys/utsname.h>    // need for uname() function in BlackDiscoveryIndex::makeCacheKey()
+#include <atomic>
+#include <pthread.h>        // need for watcher thread of BlackDiscoveryIndex
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>  // need for kernel uevent socket of BlackDiscoveryIndex
+#include <stdint.h>
+#include <fcntl.h>          // need for open() function in BlackMemoryRegion
+#include <unistd.h>         // need for close() function in BlackMemoryRegion
+#include <sys/mman.h>       // need for mmap() function in BlackMemoryRegion
 
 namespace BlackLib
 {
@@ -31,6 +52,214 @@ namespace BlackLib
 
 
 
+    // ####################################### BLACKDISCOVERYINDEX DECLARATION STARTS ##################################### //
+
+    /*! @brief Process wide cache of directory searches.
+     *
+     *    BlackCore objects find capemgr, ocp and device driver directories by searching directory
+     *    entries. This class reads every searched directory once and holds its entry names. Results of
+     *    searches are held at a hash map, which is keyed by searched directory and searched name; so
+     *    repeated searches don't touch the filesystem. If a name isn't found at held entries, the
+     *    directory is read again once, because device driver directories are created after loading
+     *    overlays. Not found results are not cached.
+     *
+     *    Search results can be saved to a cache file optionally, so new processes don't read the
+     *    directories again. The file is valid only for the kernel and boot which wrote it, and every
+     *    result is checked with a stat() call of its path while loading.
+     *
+     *    An optional watcher thread keeps the held entries up to date. It watches every read directory
+     *    with inotify and listens kernel uevents (sysfs doesn't send inotify events for directories which
+     *    are created by kernel, like pwm_test directories of a new overlay). When a watched directory
+     *    changes, the thread reads it again, resolves its old searches again and increases the generation
+     *    counter. Users of found paths compare the counter with their own copy, which is one atomic read,
+     *    and take their new paths from the index only when it changes.
+     *
+     *    All of the functions are thread safe. There is one object in a process, it is shared by every
+     *    BlackCore derived object.
+     */
+    class BlackDiscoveryIndex
+    {
+        private:
+            std::mutex                                                  indexMutex;     /*!< @brief is used to lock the tables */
+            std::unordered_map<std::string, std::vector<std::string> >  listings;       /*!< @brief is used to hold the entry names of read directories */
+            std::unordered_map<std::string, std::string>                lookups;        /*!< @brief is used to hold the search results */
+            std::string                                                 cacheFilePath;  /*!< @brief is used to hold the cache file path, empty if it isn't used */
+            bool                                                        isCacheLoaded;  /*!< @brief is used to hold the cache file loading status */
+            bool                                                        isCacheWritten; /*!< @brief is used to hold whether cache file is written after loading */
+            bool                                                        isCacheDirty;   /*!< @brief is used to hold whether results are newer than cache file */
+            std::set<std::string>                                       cachedDirectories; /*!< @brief is used to hold searched directories of loaded cache results */
+            std::atomic<uint64_t>                                       generation;     /*!< @brief is used to hold the number of changes of search results */
+            std::unordered_map<int, std::string>                        watches;        /*!< @brief is used to hold the watched directory of inotify watch descriptors */
+            int                                                         inotifyFd;      /*!< @brief is used to hold the inotify descriptor, -1 if watcher isn't running */
+            int                                                         ueventFd;       /*!< @brief is used to hold the kernel uevent socket, -1 if it isn't open */
+            int                                                         stopFd;         /*!< @brief is used to hold the eventfd which stops the watcher */
+            pthread_t                                                   watcherThread;  /*!< @brief is used to hold the watcher thread */
+            std::atomic<bool>                                           isWatching;     /*!< @brief is used to hold whether watcher loop runs, it is cleared when the loop returns */
+
+            /*! @brief Holds descriptors which are given to watcher thread.
+            */
+            struct watcherDescriptors
+            {
+                BlackDiscoveryIndex     *index;         /*!< @brief is used to hold the watching index */
+                int                     inotifyFd;      /*!< @brief is used to hold the inotify descriptor */
+                int                     ueventFd;       /*!< @brief is used to hold the kernel uevent socket, -1 if it isn't open */
+                int                     stopFd;         /*!< @brief is used to hold the eventfd which stops the watcher */
+            };
+
+            /*! @brief Adds inotify watch of directory, if watcher is running.
+            *
+            *  @param [in] searchIn     directory path
+            */
+            void            watchDirectory(const std::string &searchIn);
+
+            /*! @brief Checks whether directory is read or has loaded cache results.
+            *
+            *  @param [in] searchIn     directory path
+            *  @return True if directory is watched and refreshed, else false.
+            */
+            bool            isHeldDirectory(const std::string &searchIn);
+
+            /*! @brief Reads directory again and resolves its searches again.
+            *
+            *  Searches which aren't found anymore are removed. Generation counter is increased.
+            *  @param [in] searchIn     directory path
+            */
+            void            refreshDirectory(const std::string &searchIn);
+
+            /*! @brief Finds held directory of a kernel uevent.
+            *
+            *  @param [in] message      uevent message, like <b> "add@/devices/ocp.3/pwm_test_P8_19.15" </b>
+            *  @return Held directory path of the device's parent, empty string if it isn't held.
+            */
+            std::string     findUeventDirectory(const char *message);
+
+            /*! @brief Waits events of watched directories and refreshes them.
+            *
+            *  The loop returns when stopWatcher() is called or poll() fails with an error other than EINTR.
+            *  Descriptors are own copies of the thread, so stopWatcher() can clear the members before joining.
+            *  @param [in] watcher      descriptors of the watcher
+            */
+            void            watchLoop(const watcherDescriptors &watcher);
+
+            /*! @brief Entry function of watcher thread.
+            *
+            *  @param [in] descriptors  pointer of watcherDescriptors object, it is deleted by the thread
+            */
+            static void     *watcherEntry(void *descriptors);
+
+            /*! @brief Generates identity of running kernel and boot.
+            *
+            *  @return Kernel release, kernel version and boot id at one line.
+            */
+            std::string     makeCacheKey();
+
+            /*! @brief Loads valid search results from cache file.
+            *
+            *  Nothing is loaded if identity line of the file doesn't match makeCacheKey(). A result is
+            *  loaded only if its full path exists. Searched directories of loaded results are recorded,
+            *  so they are watched and refreshed like read directories.
+            */
+            void            loadCacheFile();
+
+            /*! @brief Writes all of the search results to cache file.
+            *
+            *  The file is written to a temporary file first and renamed, so readers never see a half
+            *  written file. It is called at first new result after loading, at refreshes of watcher and
+            *  at destruction if there are unwritten results; not at every new result.
+            */
+            void            saveCacheFile();
+
+            /*! @brief Reads entry names of directory to listings table.
+            *
+            *  @param [in] searchIn     directory path
+            *  @return Reference of the entry name list at listings table.
+            */
+            std::vector<std::string> &scanDirectory(const std::string &searchIn);
+
+            /*! @brief Searches entry list.
+            *
+            *  @param [in] entries      entry names
+            *  @param [in] searchThis   searched name part
+            *  @return First entry which includes @a searchThis if found, else BlackLib::SEARCH_DIR_NOT_FOUND string.
+            */
+            static std::string findEntry(const std::vector<std::string> &entries, const std::string &searchThis);
+
+        public:
+            /*! @brief Exports the process wide object.
+            *
+            *  The object is created at first call.
+            *  @return Reference of the process wide index.
+            */
+            static BlackDiscoveryIndex &instance();
+
+            /*! @brief Constructor of BlackDiscoveryIndex class.
+            *
+            *  Cache file isn't used by default.
+            */
+                            BlackDiscoveryIndex();
+
+            /*! @brief Sets cache file of search results.
+            *
+            *  Results at the file are loaded at next search. New results are written to the file when
+            *  they are found. Empty @a path disables the cache file.
+            *  @param [in] path         cache file path
+            */
+            void            setCacheFile(const std::string &path);
+
+            /*! @brief Searches directory to find entry which includes entered name.
+            *
+            *  @param [in] searchIn     directory path
+            *  @param [in] searchThis   searched name part
+            *  @return Found entry name if successful, else BlackLib::SEARCH_DIR_NOT_FOUND string.
+            */
+            std::string     find(const std::string &searchIn, const std::string &searchThis);
+
+            /*! @brief Removes held entries and search results of directory.
+            *
+            *  @param [in] searchIn     directory path
+            */
+            void            invalidate(const std::string &searchIn);
+
+            /*! @brief Removes all of the held entries and search results.
+            */
+            void            clear();
+
+            /*! @brief Starts watcher thread.
+            *
+            *  Directories which are read already, searched directories of loaded cache results and
+            *  directories which will be read are watched.
+            *  @return True if watcher is running after call, else false.
+            */
+            bool            startWatcher();
+
+            /*! @brief Stops watcher thread and removes all of the watches.
+            *
+            *  The thread is joined by one caller, even if this function is called from several threads.
+            */
+            void            stopWatcher();
+
+            /*! @brief Exports number of changes of search results.
+            *
+            *  It increases when watcher refreshes a directory, or invalidate() or clear() is called.
+            *  @return Generation counter.
+            */
+            uint64_t        getGeneration()
+            {
+                return this->generation.load(std::memory_order_acquire);
+            }
+
+            /*! @brief Destructor of BlackDiscoveryIndex class.
+            *
+            *  This function stops watcher thread and writes unwritten results to cache file.
+            */
+                            ~BlackDiscoveryIndex();
+    };
+    // ######################################## BLACKDISCOVERYINDEX DECLARATION ENDS ###################################### //
+
+
+
+
+
     // ########################################### BLACKCORE DECLARATION STARTS ########################################### //
 
     /*! @brief Base class of the other classes.
@@ -65,17 +294,10 @@ namespace BlackLib
             */
             bool            findOcpName();
 
-            /*! @brief Executes system call.
-            *
-            *  This function executes system commands with using popen() function.
-            *  This example executes "ls" command with argument "la" and saves
-            *  output to returnValue variable. @n @n
-            *  <b> string returnValue = executeCommand("ls -la"); </b>
-            */
-            std::string     executeCommand(std::string command);
-
             /*! @brief Searches specified directory to find specified file/directory.
             *
+            *  Search is done through the process wide BlackDiscoveryIndex, so a directory is read only
+            *  at the first search or when the searched name isn't there yet.
             *  @param[in] searchIn searching directory
             *  @param[in] searchThis search file/directory
             *  @return Full name of searching file/directory.
@@ -86,6 +308,39 @@ namespace BlackLib
             */
             virtual bool    loadDeviceTree() = 0;
 
+            /*! @brief Holds the filesystem root prefix.
+            *
+            *  @return Reference of the process wide root prefix string.
+            *  @sa BlackCore::setFilesystemRoot()
+            */
+            static std::string &filesystemRoot();
+
+            /*! @brief Holds loaded overlay names of slots file.
+            */
+            struct overlayCache
+            {
+                std::mutex              cacheMutex;     /*!< @brief is used to lock the cache across check, slots file write and insert */
+                std::string             slotsPath;      /*!< @brief is used to hold the parsed slots file path, empty if not parsed */
+                std::set<std::string>   loadedNames;    /*!< @brief is used to hold the names of loaded overlays */
+            };
+
+            /*! @brief Holds the process wide overlay cache.
+            *
+            *  @return Reference of the process wide overlay cache.
+            *  @sa BlackCore::loadOverlay()
+            */
+            static overlayCache &loadedOverlays();
+
+            /*! @brief Reads slots file and fills the overlay cache.
+            *
+            *  Every line of slots file looks like <b> " 7: ff:P-O-L Override Board Name,00A0,Override Manuf,am33xx_pwm" </b>.
+            *  Last comma separated field of a line is saved as overlay name, if the flags field
+            *  (@b "P-O-L" at the example) includes @b "L" (loaded) flag. Mutex of the overlay cache must
+            *  be locked by the caller.
+            *  @return True if slots file is read, else false.
+            */
+            bool            parseSlotsFile();
+
 
 
         protected:
@@ -137,6 +392,53 @@ namespace BlackLib
             */
             std::string     getSlotsFilePath();
 
+            /*! @brief Exports devices directory path to derived class.
+            *
+            *  @return Filesystem root prefix + @b "/sys/devices/" string.
+            */
+            std::string     getDevicesPath();
+
+            /*! @brief Executes system call.
+            *
+            *  This function executes a program with using posix_spawnp() function, without shell and
+            *  without fork() of the calling process. Command is split at white spaces; shell syntax like
+            *  pipes, redirections and quotes isn't interpreted. Output of the program is returned after
+            *  the program exits. It is the fallback for operations which don't have an in-process
+            *  function (like readFile() and loadOverlay()).
+            *  This example executes "ls" command with argument "la" and saves
+            *  output to returnValue variable. @n @n
+            *  <b> string returnValue = executeCommand("ls -la"); </b>
+            *  @return Standard output of the program, or @b "ERROR" string if the program can't be started.
+            */
+            std::string     executeCommand(std::string command);
+
+            /*! @brief Reads whole content of a file in process.
+            *
+            *  It replaces <b> executeCommand("cat file") </b> calls for querying sysfs state.
+            *  @param [in] path         file path
+            *  @return File content, or BlackLib::FILE_COULD_NOT_OPEN_STRING if file can't be opened.
+            */
+            std::string     readFile(const std::string &path);
+
+            /*! @brief Reads slots file of capemgr in process.
+            *
+            *  It replaces <b> executeCommand("cat .../slots") </b> calls.
+            *  @return Slots file content, or BlackLib::FILE_COULD_NOT_OPEN_STRING if file can't be opened.
+            */
+            std::string     listSlots();
+
+            /*! @brief Loads device tree overlay, if it isn't loaded.
+            *
+            *  Slots file is read only once in a process and loaded overlay names are cached. If
+            *  @a overlayName is at the cache, nothing is written to slots file. Otherwise the name is
+            *  written to slots file and added to the cache after successful writing. So every overlay
+            *  is loaded once, even if many objects need it. This function is thread safe; the cache is
+            *  locked from the check until the insert.
+            *  @param [in] overlayName  overlay name, like @b "am33xx_pwm"
+            *  @return True if overlay is loaded, else false.
+            */
+            bool            loadOverlay(const std::string &overlayName);
+
 
 
         public:
@@ -154,10 +456,131 @@ namespace BlackLib
             */
             virtual ~BlackCore();
 
+            /*! @brief Changes filesystem root prefix of all BlackLib paths.
+            *
+            *  All sysfs and device paths which are used by BlackLib classes start with this prefix.
+            *  Its default value is empty string, so paths point to real @b "/sys/..." files. It can be
+            *  set to a directory which imitates sysfs tree (for example on tmpfs), for testing and
+            *  benchmarking purposes. It must be called before creating any BlackLib object.
+            *  @param [in] root new root prefix without trailing slash
+            *
+            *  @par Example
+            *  @code{.cpp}
+            *   BlackLib::BlackCore::setFilesystemRoot("/dev/shm/fakeBone");
+            *   BlackLib::BlackPWM  myPwm(BlackLib::P8_19);     // uses "/dev/shm/fakeBone/sys/devices/..."
+            *  @endcode
+            */
+            static void         setFilesystemRoot(std::string root);
+
+            /*! @brief Exports filesystem root prefix.
+            *
+            *  @return Current filesystem root prefix.
+            */
+            static std::string  getFilesystemRoot();
+
+            /*! @brief Sets on-disk cache file of directory searches.
+            *
+            *  Capemgr, ocp and device driver directory names which are found by a process are saved to
+            *  this file, and next processes load them instead of reading the directories. Saved names
+            *  are used only at same kernel and boot, and only if their paths still exist. Cache file
+            *  isn't used by default. It must be called before creating any BlackLib object.
+            *  @param [in] path         cache file path, it must be at a writable directory
+            *
+            *  @par Example
+            *  @code{.cpp}
+            *   BlackLib::BlackCore::setDiscoveryCacheFile("/run/blacklib.cache");
+            *   BlackLib::BlackPWM  myPwm(BlackLib::P8_19);
+            *  @endcode
+            *  @sa BlackDiscoveryIndex
+            */
+            static void         setDiscoveryCacheFile(std::string path);
+
+            /*! @brief Starts background watcher of found device directories.
+            *
+            *  When overlays are loaded or unloaded at runtime, pwm_test and spi directory names can change.
+            *  The watcher finds these names again in background, and BlackPWM objects reopen their files
+            *  at their next call, instead of using old paths. Watcher isn't running by default.
+            *  @return True if watcher is running, else false.
+            *  @sa BlackDiscoveryIndex::startWatcher()
+            */
+            static bool         startDiscoveryWatcher();
+
+            /*! @brief Stops background watcher of found device directories.
+            */
+            static void         stopDiscoveryWatcher();
+
     };
     // ############################################ BLACKCORE DECLARATION ENDS ############################################ //
 
 
+
+
+    // ####################################### BLACKMEMORYREGION DECLARATION STARTS ####################################### //
+
+    /*! @brief Maps a physical register block of the processor to memory.
+     *
+     *    This class maps @a size bytes at @a physical @a address from @b "/dev/mem" file (with filesystem
+     *    root prefix of BlackCore::setFilesystemRoot()). When root prefix points to a test directory,
+     *    @b "dev/mem" can be an ordinary (sparse) file, which stands in for the register window. So the
+     *    register level logic can be verified without the board.
+     */
+    class BlackMemoryRegion
+    {
+        private:
+            uint8_t         *base;                      /*!< @brief is used to hold start address of mapped region */
+            size_t          regionSize;                 /*!< @brief is used to hold size of mapped region */
+
+            /*! @brief Copying is not allowed, because the object owns the mapping.
+            */
+                            BlackMemoryRegion(const BlackMemoryRegion &);
+
+            /*! @brief Copying is not allowed, because the object owns the mapping.
+            */
+            BlackMemoryRegion &operator=(const BlackMemoryRegion &);
+
+        public:
+            /*! @brief Constructor of BlackMemoryRegion class.
+            *
+            * @param [in] address    physical start address of the region, must be page aligned
+            * @param [in] size       size of the region at byte level
+            */
+                            BlackMemoryRegion(uint32_t address, size_t size);
+
+            /*! @brief Destructor of BlackMemoryRegion class.
+            *
+            * This function unmaps the region.
+            */
+            virtual         ~BlackMemoryRegion();
+
+            /*! @brief Checks mapping state.
+            *
+            * @return True if the region is mapped, else false.
+            */
+            bool            isMapped();
+
+            /*! @brief Exports 16 bit register of the region.
+            *
+            * @param [in] offset     byte offset of register from start of the region
+            * @return Pointer of register.
+            */
+            volatile uint16_t *register16(uint32_t offset)
+            {
+                return reinterpret_cast<volatile uint16_t *>(this->base + offset);
+            }
+
+            /*! @brief Exports 32 bit register of the region.
+            *
+            * @param [in] offset     byte offset of register from start of the region
+            * @return Pointer of register.
+            */
+            volatile uint32_t *register32(uint32_t offset)
+            {
+                return reinterpret_cast<volatile uint32_t *>(this->base + offset);
+            }
+    };
+    // ######################################## BLACKMEMORYREGION DECLARATION ENDS ######################################## //
+
+
     // ########################################### BLACKCORE DEFINITION STARTS ########################################### //
     BlackCore::BlackCore()
     {
@@ -165,7 +588,7 @@ namespace BlackLib
 
         this->findCapeMgrName();
         this->findOcpName();
-        this->slotsFilePath = "/sys/devices/" + this->capeMgrName + "/slots";
+        this->slotsFilePath = this->getDevicesPath() + this->capeMgrName + "/slots";
     }
 
     BlackCore::~BlackCore()
@@ -175,59 +598,113 @@ namespace BlackLib
 
     std::string BlackCore::executeCommand(std::string command)
     {
-        FILE* pipe = popen(command.c_str(), "r");
-        if ( pipe==NULL )
+        std::vector<std::string> arguments;
+        std::istringstream words(command);
+        std::string word;
+        while( words >> word )
+        {
+            arguments.push_back(word);
+        }
+
+        if( arguments.empty() )
         {
             return "ERROR";
         }
 
-        char buffer[128];
-        std::string result = "";
+        std::vector<char *> argumentPointers;
+        for( size_t i = 0 ; i < arguments.size() ; i++ )
+        {
+            argumentPointers.push_back( &(arguments[i][0]) );
+        }
+        argumentPointers.push_back(NULL);
+
+        int outputPipe[2];
+        if( pipe2(outputPipe, O_CLOEXEC) != 0 )
+        {
+            return "ERROR";
+        }
+
+        // child gets write end of the pipe as its standard output
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, outputPipe[1], STDOUT_FILENO);
+
+        pid_t child;
+        int spawnStatus = posix_spawnp(&child, argumentPointers[0], &actions, NULL, &argumentPointers[0], environ);
+
+        posix_spawn_file_actions_destroy(&actions);
+        ::close(outputPipe[1]);
 
-        while( !feof(pipe) )
+        if( spawnStatus != 0 )
         {
-            if( fgets(buffer, 128, pipe) != NULL )
+            ::close(outputPipe[0]);
+            return "ERROR";
+        }
+
+        char buffer[4096];
+        std::string result = "";
+        while( true )
+        {
+            ssize_t readSize = ::read(outputPipe[0], buffer, sizeof(buffer));
+            if( readSize > 0 )
+            {
+                result.append(buffer, static_cast<size_t>(readSize));
+            }
+            else if( readSize == 0 or errno != EINTR )
             {
-                result += buffer;
+                break;
             }
         }
 
-        pclose(pipe);
+        ::close(outputPipe[0]);
+
+        // a signal can interrupt the wait before the child is reaped, it would stay as a zombie
+        while( waitpid(child, NULL, 0) < 0 and errno == EINTR )
+        {
+        }
         return result;
     }
 
-    std::string BlackCore::searchDirectory(std::string seachIn, std::string searchThis)
+    std::string BlackCore::readFile(const std::string &path)
     {
-        std::string str;
-        DIR *path;
-        dirent *entry;
+        int fileFd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if( fileFd < 0 )
+        {
+            return FILE_COULD_NOT_OPEN_STRING;
+        }
 
-        path = opendir(seachIn.c_str());
-        if( path != NULL  )
+        char buffer[4096];
+        std::string result = "";
+        while( true )
         {
-            while( (entry = readdir(path)) != NULL)
+            ssize_t readSize = ::read(fileFd, buffer, sizeof(buffer));
+            if( readSize > 0 )
             {
-                if( entry->d_name[0] == '.')
-                {
-                    continue;
-                }
-
-                str = entry->d_name;
-                if(strstr(entry->d_name,searchThis.c_str()) != NULL )
-                {
-                    closedir(path);
-                    return str;
-                }
+                result.append(buffer, static_cast<size_t>(readSize));
+            }
+            else if( readSize == 0 or errno != EINTR )
+            {
+                break;
             }
         }
-        closedir(path);
 
-        return SEARCH_DIR_NOT_FOUND;
+        ::close(fileFd);
+        return result;
+    }
+
+    std::string BlackCore::listSlots()
+    {
+        return this->readFile(this->slotsFilePath);
+    }
+
+    std::string BlackCore::searchDirectory(std::string seachIn, std::string searchThis)
+    {
+        return BlackDiscoveryIndex::instance().find(seachIn, searchThis);
     }
 
     bool        BlackCore::findCapeMgrName()
     {
-        std::string searchResult = this->searchDirectory("/sys/devices/","bone_capemgr.");
+        std::string searchResult = this->searchDirectory(this->getDevicesPath(),"bone_capemgr.");
 
         if(searchResult == SEARCH_DIR_NOT_FOUND)
         {
@@ -245,7 +722,7 @@ namespace BlackLib
 
     bool        BlackCore::findOcpName()
     {
-        std::string searchResult = this->searchDirectory("/sys/devices/","ocp.");
+        std::string searchResult = this->searchDirectory(this->getDevicesPath(),"ocp.");
 
         if(searchResult == SEARCH_DIR_NOT_FOUND)
         {
@@ -267,7 +744,7 @@ namespace BlackLib
     std::string BlackCore::searchDirectoryOcp(BlackCore::ocpSearch searchThis)
     {
         std::string searchResult;
-        std::string searchPath = "/sys/devices/" + this->getOcpName() + "/";
+        std::string searchPath = this->getDevicesPath() + this->getOcpName() + "/";
 
         if( searchThis == this->SPI0 )
         {
@@ -368,7 +845,702 @@ namespace BlackLib
         return this->slotsFilePath;
     }
 
-    // ############################################ BLACKCORE DEFINITION ENDS ############################################ //
+    std::string BlackCore::getDevicesPath()
+    {
+        return (BlackCore::filesystemRoot() + "/sys/devices/");
+    }
+
+    BlackCore::overlayCache &BlackCore::loadedOverlays()
+    {
+        static overlayCache cache;
+        return cache;
+    }
+
+    bool        BlackCore::parseSlotsFile()
+    {
+        overlayCache &cache = BlackCore::loadedOverlays();
+        cache.loadedNames.clear();
+        cache.slotsPath.clear();
+
+        std::ifstream slotsFile(this->slotsFilePath.c_str(), std::ios::in);
+        if( slotsFile.fail() )
+        {
+            return false;
+        }
+
+        std::string line;
+        while( std::getline(slotsFile, line) )
+        {
+            size_t flagsStart   = line.find(':');
+            flagsStart          = (flagsStart == std::string::npos) ? flagsStart : line.find(':', flagsStart + 1);
+            size_t flagsEnd     = (flagsStart == std::string::npos) ? flagsStart : line.find(' ', flagsStart);
+            size_t nameStart    = line.rfind(',');
+
+            if( flagsEnd == std::string::npos or nameStart == std::string::npos or nameStart < flagsEnd )
+            {
+                continue;
+            }
+
+            if( line.find('L', flagsStart) >= flagsEnd )
+            {
+                continue;
+            }
+
+            size_t nameEnd = line.find_last_not_of(" \t\r");
+            if( nameEnd > nameStart )
+            {
+                cache.loadedNames.insert( line.substr(nameStart + 1, nameEnd - nameStart) );
+            }
+        }
+
+        cache.slotsPath = this->slotsFilePath;
+        return true;
+    }
+
+    bool        BlackCore::loadOverlay(const std::string &overlayName)
+    {
+        overlayCache &cache = BlackCore::loadedOverlays();
+        std::lock_guard<std::mutex> lock(cache.cacheMutex);
+
+        if( cache.slotsPath != this->slotsFilePath )
+        {
+            this->parseSlotsFile();
+        }
+
+        if( cache.loadedNames.count(overlayName) != 0 )
+        {
+            return true;
+        }
+
+        std::ofstream slotsFile(this->slotsFilePath.c_str(), std::ios::out);
+        if( slotsFile.fail() )
+        {
+            return false;
+        }
+
+        slotsFile << overlayName;
+        slotsFile.close();
+        if( slotsFile.fail() )
+        {
+            return false;
+        }
+
+        cache.loadedNames.insert(overlayName);
+        return true;
+    }
+
+    std::string &BlackCore::filesystemRoot()
+    {
+        static std::string root = "";
+        return root;
+    }
+
+    void        BlackCore::setFilesystemRoot(std::string root)
+    {
+        BlackCore::filesystemRoot() = root;
+    }
+
+    std::string BlackCore::getFilesystemRoot()
+    {
+        return BlackCore::filesystemRoot();
+    }
+
+    void        BlackCore::setDiscoveryCacheFile(std::string path)
+    {
+        BlackDiscoveryIndex::instance().setCacheFile(path);
+    }
+
+    bool        BlackCore::startDiscoveryWatcher()
+    {
+        return BlackDiscoveryIndex::instance().startWatcher();
+    }
+
+    void        BlackCore::stopDiscoveryWatcher()
+    {
+        BlackDiscoveryIndex::instance().stopWatcher();
+    }
+
+    // ############################################ BLACKCORE DEFINITION ENDS ############################################ //
+
+
+
+
+    // ####################################### BLACKDISCOVERYINDEX DEFINITION STARTS ###################################### //
+    BlackDiscoveryIndex &BlackDiscoveryIndex::instance()
+    {
+        static BlackDiscoveryIndex index;
+        return index;
+    }
+
+    BlackDiscoveryIndex::BlackDiscoveryIndex() : generation(0)
+    {
+        this->isCacheLoaded     = false;
+        this->isCacheWritten    = false;
+        this->isCacheDirty      = false;
+        this->inotifyFd         = -1;
+        this->ueventFd          = -1;
+        this->stopFd            = -1;
+        this->isWatching        = false;
+    }
+
+    BlackDiscoveryIndex::~BlackDiscoveryIndex()
+    {
+        this->stopWatcher();
+
+        std::lock_guard<std::mutex> lock(this->indexMutex);
+        if( this->isCacheDirty and ! this->cacheFilePath.empty() )
+        {
+            this->saveCacheFile();
+        }
+    }
+
+    void        BlackDiscoveryIndex::setCacheFile(const std::string &path)
+    {
+        std::lock_guard<std::mutex> lock(this->indexMutex);
+
+        if( this->isCacheDirty and ! this->cacheFilePath.empty() )
+        {
+            this->saveCacheFile();
+        }
+
+        this->cacheFilePath = path;
+        this->isCacheLoaded = false;
+    }
+
+    std::string BlackDiscoveryIndex::makeCacheKey()
+    {
+        std::string key = "key";
+
+        utsname kernel;
+        if( uname(&kernel) == 0 )
+        {
+            key = key + " " + kernel.release + " " + kernel.version;
+        }
+
+        std::string bootId;
+        std::ifstream bootIdFile((BlackCore::getFilesystemRoot() + "/proc/sys/kernel/random/boot_id").c_str(), std::ios::in);
+        bootIdFile >> bootId;
+
+        return (key + " " + bootId);
+    }
+
+    void        BlackDiscoveryIndex::loadCacheFile()
+    {
+        this->isCacheLoaded     = true;
+        this->isCacheWritten    = false;
+        this->isCacheDirty      = false;
+
+        std::ifstream cacheFile(this->cacheFilePath.c_str(), std::ios::in);
+        std::string line;
+
+        if( ! std::getline(cacheFile, line) or line != this->makeCacheKey() )
+        {
+            return;
+        }
+
+        // every line is "searchIn <tab> searchThis <tab> result"
+        while( std::getline(cacheFile, line) )
+        {
+            size_t firstTab     = line.find('\t');
+            size_t secondTab    = (firstTab == std::string::npos) ? firstTab : line.find('\t', firstTab + 1);
+            if( secondTab == std::string::npos )
+            {
+                continue;
+            }
+
+            std::string searchIn    = line.substr(0, firstTab);
+            std::string result      = line.substr(secondTab + 1);
+            std::string fullPath    = searchIn + ((searchIn.empty() or searchIn[searchIn.size()-1] != '/') ? "/" : "") + result;
+
+            struct stat pathStatus;
+            if( stat(fullPath.c_str(), &pathStatus) == 0 )
+            {
+                std::string key = searchIn + '\0' + line.substr(firstTab + 1, secondTab - firstTab - 1);
+                this->lookups[key] = result;
+                this->cachedDirectories.insert(searchIn);
+                this->watchDirectory(searchIn);
+            }
+        }
+    }
+
+    void        BlackDiscoveryIndex::saveCacheFile()
+    {
+        std::string temporaryPath = this->cacheFilePath + ".tmp";
+        std::ofstream cacheFile(temporaryPath.c_str(), std::ios::out | std::ios::trunc);
+        if( cacheFile.fail() )
+        {
+            return;
+        }
+
+        cacheFile << this->makeCacheKey() << "\n";
+
+        std::unordered_map<std::string, std::string>::iterator lookup = this->lookups.begin();
+        for( ; lookup != this->lookups.end() ; ++lookup )
+        {
+            size_t separator = lookup->first.find('\0');
+            cacheFile << lookup->first.substr(0, separator) << "\t" << lookup->first.substr(separator + 1) << "\t" << lookup->second << "\n";
+        }
+
+        cacheFile.close();
+        if( cacheFile.fail() or std::rename(temporaryPath.c_str(), this->cacheFilePath.c_str()) != 0 )
+        {
+            std::remove(temporaryPath.c_str());
+            return;
+        }
+
+        this->isCacheWritten    = true;
+        this->isCacheDirty      = false;
+    }
+
+    std::vector<std::string> &BlackDiscoveryIndex::scanDirectory(const std::string &searchIn)
+    {
+        std::vector<std::string> &entries = this->listings[searchIn];
+        entries.clear();
+
+        DIR *path = opendir(searchIn.c_str());
+        if( path == NULL )
+        {
+            return entries;
+        }
+
+        dirent *entry;
+        while( (entry = readdir(path)) != NULL )
+        {
+            if( entry->d_name[0] == '.' )
+            {
+                continue;
+            }
+
+            entries.push_back(entry->d_name);
+        }
+
+        closedir(path);
+        this->watchDirectory(searchIn);
+        return entries;
+    }
+
+    std::string BlackDiscoveryIndex::findEntry(const std::vector<std::string> &entries, const std::string &searchThis)
+    {
+        for( size_t i = 0 ; i < entries.size() ; i++ )
+        {
+            if( entries[i].find(searchThis) != std::string::npos )
+            {
+                return entries[i];
+            }
+        }
+
+        return SEARCH_DIR_NOT_FOUND;
+    }
+
+    std::string BlackDiscoveryIndex::find(const std::string &searchIn, const std::string &searchThis)
+    {
+        std::lock_guard<std::mutex> lock(this->indexMutex);
+
+        if( ! this->isCacheLoaded and ! this->cacheFilePath.empty() )
+        {
+            this->loadCacheFile();
+        }
+
+        std::string key = searchIn + '\0' + searchThis;
+        std::unordered_map<std::string, std::string>::iterator lookup = this->lookups.find(key);
+        if( lookup != this->lookups.end() )
+        {
+            return lookup->second;
+        }
+
+        std::unordered_map<std::string, std::vector<std::string> >::iterator listing = this->listings.find(searchIn);
+        std::string result = SEARCH_DIR_NOT_FOUND;
+
+        if( listing != this->listings.end() )
+        {
+            result = BlackDiscoveryIndex::findEntry(listing->second, searchThis);
+        }
+
+        // directory isn't read yet or its held entries are old
+        if( result == SEARCH_DIR_NOT_FOUND )
+        {
+            result = BlackDiscoveryIndex::findEntry(this->scanDirectory(searchIn), searchThis);
+        }
+
+        if( result != SEARCH_DIR_NOT_FOUND )
+        {
+            this->lookups[key] = result;
+
+            // file is written at first new result after loading, later results are written in batches
+            if( ! this->cacheFilePath.empty() )
+            {
+                if( this->isCacheWritten )
+                {
+                    this->isCacheDirty = true;
+                }
+                else
+                {
+                    this->saveCacheFile();
+                }
+            }
+        }
+
+        return result;
+    }
+
+    void        BlackDiscoveryIndex::invalidate(const std::string &searchIn)
+    {
+        std::lock_guard<std::mutex> lock(this->indexMutex);
+        this->generation.fetch_add(1, std::memory_order_release);
+
+        this->listings.erase(searchIn);
+        this->cachedDirectories.erase(searchIn);
+
+        std::string keyPrefix = searchIn + '\0';
+        std::unordered_map<std::string, std::string>::iterator lookup = this->lookups.begin();
+        while( lookup != this->lookups.end() )
+        {
+            if( lookup->first.compare(0, keyPrefix.size(), keyPrefix) == 0 )
+            {
+                lookup = this->lookups.erase(lookup);
+            }
+            else
+            {
+                ++lookup;
+            }
+        }
+    }
+
+    void        BlackDiscoveryIndex::clear()
+    {
+        std::lock_guard<std::mutex> lock(this->indexMutex);
+
+        this->listings.clear();
+        this->lookups.clear();
+        this->cachedDirectories.clear();
+        this->generation.fetch_add(1, std::memory_order_release);
+    }
+
+    void        BlackDiscoveryIndex::watchDirectory(const std::string &searchIn)
+    {
+        if( this->inotifyFd < 0 )
+        {
+            return;
+        }
+
+        int watch = inotify_add_watch(this->inotifyFd, searchIn.c_str(),
+                                      IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF);
+        if( watch >= 0 )
+        {
+            this->watches[watch] = searchIn;
+        }
+    }
+
+    bool        BlackDiscoveryIndex::isHeldDirectory(const std::string &searchIn)
+    {
+        return ( this->listings.find(searchIn) != this->listings.end() or
+                 this->cachedDirectories.find(searchIn) != this->cachedDirectories.end() );
+    }
+
+    void        BlackDiscoveryIndex::refreshDirectory(const std::string &searchIn)
+    {
+        // directories of loaded cache results have no listing yet, they are read here first
+        if( ! this->isHeldDirectory(searchIn) )
+        {
+            return;
+        }
+
+        const std::vector<std::string> &entries = this->scanDirectory(searchIn);
+        std::string keyPrefix = searchIn + '\0';
+
+        std::unordered_map<std::string, std::string>::iterator lookup = this->lookups.begin();
+        while( lookup != this->lookups.end() )
+        {
+            if( lookup->first.compare(0, keyPrefix.size(), keyPrefix) != 0 )
+            {
+                ++lookup;
+                continue;
+            }
+
+            std::string result = BlackDiscoveryIndex::findEntry(entries, lookup->first.substr(keyPrefix.size()));
+            if( result == SEARCH_DIR_NOT_FOUND )
+            {
+                lookup = this->lookups.erase(lookup);
+            }
+            else
+            {
+                lookup->second = result;
+                ++lookup;
+            }
+        }
+
+        if( ! this->cacheFilePath.empty() )
+        {
+            this->saveCacheFile();
+        }
+
+        this->generation.fetch_add(1, std::memory_order_release);
+    }
+
+    std::string BlackDiscoveryIndex::findUeventDirectory(const char *message)
+    {
+        // "action@devpath", parent of devpath is searched at held directories
+        const char *devicePath = strchr(message, '@');
+        const char *lastSlash  = (devicePath == NULL) ? NULL : strrchr(devicePath, '/');
+        if( lastSlash == NULL )
+        {
+            return "";
+        }
+
+        std::string directory = BlackCore::getFilesystemRoot() + "/sys" + std::string(devicePath + 1, lastSlash + 1);
+        if( this->isHeldDirectory(directory) )
+        {
+            return directory;
+        }
+
+        directory.erase(directory.size() - 1);
+        return ( this->isHeldDirectory(directory) ? directory : "" );
+    }
+
+    void        BlackDiscoveryIndex::watchLoop(const watcherDescriptors &watcher)
+    {
+        char buffer[4096] __attribute__((aligned(__alignof__(inotify_event))));
+        pollfd descriptors[3];
+        memset(descriptors, 0, sizeof(descriptors));
+        descriptors[0].fd       = watcher.stopFd;
+        descriptors[0].events   = POLLIN;
+        descriptors[1].fd       = watcher.inotifyFd;
+        descriptors[1].events   = POLLIN;
+        descriptors[2].fd       = watcher.ueventFd;
+        descriptors[2].events   = POLLIN;
+
+        while( true )
+        {
+            if( ::poll(descriptors, (watcher.ueventFd >= 0) ? 3 : 2, -1) < 0 )
+            {
+                // other errors are not transient, watcher is stopped instead of spinning
+                if( errno == EINTR )
+                {
+                    continue;
+                }
+                return;
+            }
+
+            if( descriptors[0].revents != 0 )
+            {
+                return;
+            }
+
+            std::set<std::string> changedDirectories;
+
+            if( descriptors[1].revents & POLLIN )
+            {
+                ssize_t readSize = ::read(watcher.inotifyFd, buffer, sizeof(buffer));
+
+                std::lock_guard<std::mutex> lock(this->indexMutex);
+                for( ssize_t offset = 0 ; offset < readSize ; )
+                {
+                    const inotify_event *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+                    offset += sizeof(inotify_event) + event->len;
+
+                    std::unordered_map<int, std::string>::iterator watch = this->watches.find(event->wd);
+                    if( watch == this->watches.end() )
+                    {
+                        continue;
+                    }
+
+                    changedDirectories.insert(watch->second);
+                    if( event->mask & IN_IGNORED )
+                    {
+                        this->watches.erase(watch);
+                    }
+                }
+            }
+
+            if( watcher.ueventFd >= 0 and (descriptors[2].revents & POLLIN) )
+            {
+                ssize_t readSize = ::recv(watcher.ueventFd, buffer, sizeof(buffer)-1, 0);
+
+                std::lock_guard<std::mutex> lock(this->indexMutex);
+                if( readSize > 0 )
+                {
+                    buffer[readSize] = '\0';
+                    std::string directory = this->findUeventDirectory(buffer);
+                    if( ! directory.empty() )
+                    {
+                        changedDirectories.insert(directory);
+                    }
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(this->indexMutex);
+            std::set<std::string>::iterator directory = changedDirectories.begin();
+            for( ; directory != changedDirectories.end() ; ++directory )
+            {
+                this->refreshDirectory(*directory);
+            }
+        }
+    }
+
+    void        *BlackDiscoveryIndex::watcherEntry(void *descriptors)
+    {
+        watcherDescriptors *watcher = static_cast<watcherDescriptors *>(descriptors);
+        watcher->index->watchLoop(*watcher);
+        watcher->index->isWatching = false;
+        delete watcher;
+        return NULL;
+    }
+
+    bool        BlackDiscoveryIndex::startWatcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->indexMutex);
+            if( this->inotifyFd >= 0 and this->isWatching )
+            {
+                return true;
+            }
+        }
+
+        // a watcher whose loop returned after an error is joined and closed before starting again
+        this->stopWatcher();
+
+        std::lock_guard<std::mutex> lock(this->indexMutex);
+
+        if( this->inotifyFd >= 0 )
+        {
+            return this->isWatching;
+        }
+
+        this->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        this->stopFd    = eventfd(0, EFD_CLOEXEC);
+        if( this->inotifyFd < 0 or this->stopFd < 0 )
+        {
+            if( this->inotifyFd >= 0 )  { ::close(this->inotifyFd); }
+            if( this->stopFd >= 0 )     { ::close(this->stopFd);    }
+            this->inotifyFd = -1;
+            this->stopFd    = -1;
+            return false;
+        }
+
+        // uevents are optional, watcher works with inotify only if socket can't be opened
+        sockaddr_nl address;
+        memset(&address, 0, sizeof(address));
+        address.nl_family   = AF_NETLINK;
+        address.nl_groups   = 1;
+        this->ueventFd      = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+        if( this->ueventFd >= 0 and ::bind(this->ueventFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 )
+        {
+            ::close(this->ueventFd);
+            this->ueventFd = -1;
+        }
+
+        std::unordered_map<std::string, std::vector<std::string> >::iterator listing = this->listings.begin();
+        for( ; listing != this->listings.end() ; ++listing )
+        {
+            this->watchDirectory(listing->first);
+        }
+
+        std::set<std::string>::iterator cached = this->cachedDirectories.begin();
+        for( ; cached != this->cachedDirectories.end() ; ++cached )
+        {
+            this->watchDirectory(*cached);
+        }
+
+        watcherDescriptors *watcher = new watcherDescriptors;
+        watcher->index      = this;
+        watcher->inotifyFd  = this->inotifyFd;
+        watcher->ueventFd   = this->ueventFd;
+        watcher->stopFd     = this->stopFd;
+
+        this->isWatching = true;
+        if( pthread_create(&(this->watcherThread), NULL, &BlackDiscoveryIndex::watcherEntry, watcher) != 0 )
+        {
+            delete watcher;
+            this->isWatching = false;
+            ::close(this->inotifyFd);
+            ::close(this->stopFd);
+            if( this->ueventFd >= 0 ) { ::close(this->ueventFd); }
+            this->inotifyFd = -1;
+            this->ueventFd  = -1;
+            this->stopFd    = -1;
+            this->watches.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    void        BlackDiscoveryIndex::stopWatcher()
+    {
+        pthread_t   thread;
+        int         inotify;
+        int         uevent;
+        int         stop;
+
+        // thread is claimed under the lock, so only one caller joins it
+        {
+            std::lock_guard<std::mutex> lock(this->indexMutex);
+            if( this->inotifyFd < 0 )
+            {
+                return;
+            }
+
+            thread          = this->watcherThread;
+            inotify         = this->inotifyFd;
+            uevent          = this->ueventFd;
+            stop            = this->stopFd;
+            this->inotifyFd = -1;
+            this->ueventFd  = -1;
+            this->stopFd    = -1;
+            this->watches.clear();
+        }
+
+        uint64_t stopValue = 1;
+        ::write(stop, &stopValue, sizeof(stopValue));
+        pthread_join(thread, NULL);
+
+        ::close(inotify);
+        ::close(stop);
+        if( uevent >= 0 )
+        {
+            ::close(uevent);
+        }
+    }
+    // ######################################## BLACKDISCOVERYINDEX DEFINITION ENDS ####################################### //
+
+
+
+
+    // ######################################## BLACKMEMORYREGION DEFINITION STARTS ####################################### //
+    BlackMemoryRegion::BlackMemoryRegion(uint32_t address, size_t size)
+    {
+        this->base          = NULL;
+        this->regionSize    = size;
+
+        std::string memPath = BlackCore::getFilesystemRoot() + "/dev/mem";
+        int memFd = ::open(memPath.c_str(), O_RDWR | O_SYNC);
+        if( memFd < 0 )
+        {
+            return;
+        }
+
+        void *mapped = ::mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, memFd, static_cast<off_t>(address));
+        ::close(memFd);
+
+        if( mapped != MAP_FAILED )
+        {
+            this->base = static_cast<uint8_t *>(mapped);
+        }
+    }
+
+    BlackMemoryRegion::~BlackMemoryRegion()
+    {
+        if( this->base != NULL )
+        {
+            ::munmap(this->base, this->regionSize);
+        }
+    }
+
+    bool        BlackMemoryRegion::isMapped()
+    {
+        return (this->base != NULL);
+    }
+    // ######################################### BLACKMEMORYREGION DEFINITION ENDS ######################################## //
 
 } /* namespace BlackLib */
 
@@ -3,6 +3,7 @@
 
 
 #include <string>
+#include <stdint.h>
 
 namespace BlackLib
 {
@@ -16,6 +17,33 @@ namespace BlackLib
                             };
 
 
+    /*!
+     * This enum is used for setting digital value (like GPIO).
+     */
+    enum digitalValue       {   low                     = 0,
+                                high                    = 1
+                            };
+
+
+    /*!
+     * This enum is used for selecting working mode (like GPIO). At secure mode, readiness of the
+     * device is checked before every access; at fast mode, it isn't checked.
+     */
+    enum workingMode        {   secureMode              = 0,
+                                fastMode                = 1
+                            };
+
+
+    /*!
+     * This enum is used for selecting signal edges which generate events (like GPIO).
+     */
+    enum edgeType           {   noEdge                  = 0,
+                                risingEdge              = 1,
+                                fallingEdge             = 2,
+                                bothEdges               = 3
+                            };
+
+
     /*!
      * This enum is used for setting run state (like PWM).
      */
@@ -35,6 +63,77 @@ namespace BlackLib
                             };
 
 
+    /*! @brief Holds conversion ratio of a time type to nanosecond.
+     *
+     *    Nanosecond equivalent of a value equals to <b> value * multiplier / divisor </b>.
+     */
+    struct timeTypeRatio
+    {
+        timeType    type;                   /*!< @brief time type */
+        uint64_t    multiplier;             /*!< @brief multiplier of conversion to nanosecond */
+        uint64_t    divisor;                /*!< @brief divisor of conversion to nanosecond */
+    };
+
+
+    /*!
+     * This table is used for converting BlackLib::timeType values to nanosecond with integer math.
+     */
+    constexpr timeTypeRatio timeTypeRatioTable[5] = {   { picosecond,   1,          1000    },
+                                                        { nanosecond,   1,          1       },
+                                                        { microsecond,  1000,       1       },
+                                                        { milisecond,   1000000,    1       },
+                                                        { second,       1000000000, 1       }
+                                                    };
+
+
+    /*! @brief Finds conversion ratio of a time type at compile time.
+     *
+     * @param [in] tType    time type
+     * @param [in] index    searching starts from this table index
+     * @return Conversion ratio of @a tType. If @a tType is not in the table, nanosecond ratio.
+     */
+    constexpr timeTypeRatio findTimeTypeRatio(timeType tType, unsigned int index = 0)
+    {
+        return (index >= 5)                                 ? timeTypeRatioTable[1] :
+               (timeTypeRatioTable[index].type == tType)    ? timeTypeRatioTable[index] :
+                                                              findTimeTypeRatio(tType, index + 1);
+    }
+
+
+    /*! @brief Converts a time value to nanosecond with integer math.
+     *
+     * Values smaller than a nanosecond (picosecond inputs) are rounded to nearest nanosecond.
+     * @param [in] value    time value
+     * @param [in] tType    time type of @a value
+     * @param [out] result  nanosecond equivalent of @a value
+     * @return True if conversion is successful, false if the result overflows 64 bit.
+     *
+     * @par Example
+     * @code{.cpp}
+     *   uint64_t ns;
+     *   BlackLib::convertToNanosecond(300000000, BlackLib::picosecond, ns);     // ns = 300000
+     *   BlackLib::convertToNanosecond(700, BlackLib::microsecond, ns);          // ns = 700000
+     * @endcode
+     */
+    inline bool convertToNanosecond(uint64_t value, timeType tType, uint64_t &result)
+    {
+        const timeTypeRatio ratio = findTimeTypeRatio(tType);
+
+        if( value > (UINT64_MAX - ratio.divisor / 2) / ratio.multiplier )
+        {
+            return false;
+        }
+
+        result = (value * ratio.multiplier + ratio.divisor / 2) / ratio.divisor;
+        return true;
+    }
+
+
+    static_assert( findTimeTypeRatio(microsecond).multiplier == 1000,   "time type table is broken" );
+    static_assert( findTimeTypeRatio(second).multiplier == 1000000000,  "time type table is broken" );
+    static_assert( findTimeTypeRatio(picosecond).divisor == 1000,       "time type table is broken" );
+
+
     /*!
      * This enum is used for selecting file open mode.
      */
@@ -66,6 +165,7 @@ namespace BlackLib
     const std::string       FILE_COULD_NOT_OPEN_STRING  = "File Couldn\'t Open";    //!< If file could not open, function returns this string
     const int               FILE_COULD_NOT_OPEN_INT     = -1;                       //!< If file could not open, function returns this integer
     const float             FILE_COULD_NOT_OPEN_FLOAT   = -1.0;                     //!< If file could not open, function returns this float value
+    const uint64_t          PWM_MAX_NANOSECOND          = 1000000000;               //!< Maximum period and duty value of pwm at nanosecond level
 
 } /* namespace BlackLib */
 
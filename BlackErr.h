@@ -221,11 +221,13 @@ namespace BlackLib
 
         /*! @brief @b pwm_test directory finding error.
         *
-        *  Its value can change, when finding @a pwm_test_X.Y name, at@n
+        *  Its value can change, when finding @a pwm_test_X.Y name or exporting pwm from its pwmchip, at@n
         *  @li findPwmTestName()
+        *  @li BlackCorePWM()
         *
-        *  function in BlackCorePWM class.
+        *  functions in BlackCorePWM class.
         *  @sa BlackCorePWM::findPwmTestName()
+        *  @sa BlackCorePWM::exportPwmChannels()
         */
         bool pwmTestError;
 
@@ -290,6 +292,9 @@ namespace BlackLib
         *  @li setPeriodTime()
         *  @li setSpaceRatioTime()
         *  @li setLoadRatioTime()
+        *  @li setLoadTime()
+        *  @li setPeriodAndDuty()
+        *  @li resync()
         *
         *  functions in BlackPWM class.
         *  @sa BlackPWM::getValue()
@@ -299,6 +304,9 @@ namespace BlackLib
         *  @sa BlackPWM::setPeriodTime()
         *  @sa BlackPWM::setSpaceRatioTime()
         *  @sa BlackPWM::setLoadRatioTime()
+        *  @sa BlackPWM::setLoadTime()
+        *  @sa BlackPWM::setPeriodAndDuty()
+        *  @sa BlackPWM::resync()
         */
         bool periodFileError;
 
@@ -311,9 +319,12 @@ namespace BlackLib
         *  @li getDutyValue()
         *  @li getNumericDutyValue()
         *  @li setDutyPercent()
+        *  @li setLoadTime()
         *  @li setPeriodTime()
         *  @li setSpaceRatioTime()
         *  @li setLoadRatioTime()
+        *  @li setPeriodAndDuty()
+        *  @li resync()
         *
         *  functions in BlackPWM class.
         *  @sa BlackPWM::getValue()
@@ -321,9 +332,12 @@ namespace BlackLib
         *  @sa BlackPWM::getDutyValue()
         *  @sa BlackPWM::getNumericDutyValue()
         *  @sa BlackPWM::setDutyPercent()
+        *  @sa BlackPWM::setLoadTime()
         *  @sa BlackPWM::setPeriodTime()
         *  @sa BlackPWM::setSpaceRatioTime()
         *  @sa BlackPWM::setLoadRatioTime()
+        *  @sa BlackPWM::setPeriodAndDuty()
+        *  @sa BlackPWM::resync()
         */
         bool dutyFileError;
 
@@ -335,12 +349,14 @@ namespace BlackLib
         *  @li isRunning()
         *  @li setRunState()
         *  @li toggleRunState()
+        *  @li resync()
         *
         *  functions in BlackPWM class.
         *  @sa BlackPWM::getRunValue()
         *  @sa BlackPWM::isRunning()
         *  @sa BlackPWM::setRunState()
         *  @sa BlackPWM::toggleRunState()
+        *  @sa BlackPWM::resync()
         */
         bool runFileError;
 
@@ -353,6 +369,7 @@ namespace BlackLib
         *  @li isPolarityReverse()
         *  @li setPolarity()
         *  @li tooglePolarity()
+        *  @li resync()
         *
         *  functions in BlackPWM class.
         *  @sa BlackPWM::getPolarityValue()
@@ -360,6 +377,7 @@ namespace BlackLib
         *  @sa BlackPWM::isPolarityReverse()
         *  @sa BlackPWM::setPolarity()
         *  @sa BlackPWM::tooglePolarity()
+        *  @sa BlackPWM::resync()
         */
         bool polarityFileError;
 
@@ -368,15 +386,19 @@ namespace BlackLib
         *
         *  Its value can change, when setting some variables of pwm, at@n
         *  @li setDutyPercent()
+        *  @li setLoadTime()
         *  @li setPeriodTime()
         *  @li setSpaceRatioTime()
         *  @li setLoadRatioTime()
+        *  @li setPeriodAndDuty()
         *
         *  functions in BlackPWM class.
         *  @sa BlackPWM::setDutyPercent()
+        *  @sa BlackPWM::setLoadTime()
         *  @sa BlackPWM::setPeriodTime()
         *  @sa BlackPWM::setSpaceRatioTime()
         *  @sa BlackPWM::setLoadRatioTime()
+        *  @sa BlackPWM::setPeriodAndDuty()
         */
         bool outOfRange;
 
@@ -0,0 +1,2293 @@
+
+#ifndef BLACKGPIO_H_
+#define BLACKGPIO_H_
+
+#include "BlackCore.h"
+
+#include <string>
+#include <stdint.h>
+#include <cstdlib>          // need for atoi() function in BlackCoreGPIO::listExportedPins()
+#include <fcntl.h>          // need for open() function
+#include <unistd.h>         // need for pread(), pwrite() and close() functions
+#include <sys/ioctl.h>      // need for ioctl() function in BlackGPIOChipDevice
+#include <linux/gpio.h>     // need for gpiochip character device interface
+
+namespace BlackLib
+{
+
+    /*!
+    * This enum is used for selecting GPIO pin. Values are kernel GPIO numbers, which equal to
+    * <b> (32 x bank) + bit </b>; only the pins which are at P8 and P9 headers are listed.
+    */
+    enum gpioName           {   GPIO_2                  = 2,
+                                GPIO_3                  = 3,
+                                GPIO_4                  = 4,
+                                GPIO_5                  = 5,
+                                GPIO_7                  = 7,
+                                GPIO_8                  = 8,
+                                GPIO_9                  = 9,
+                                GPIO_10                 = 10,
+                                GPIO_11                 = 11,
+                                GPIO_14                 = 14,
+                                GPIO_15                 = 15,
+                                GPIO_20                 = 20,
+                                GPIO_22                 = 22,
+                                GPIO_23                 = 23,
+                                GPIO_26                 = 26,
+                                GPIO_27                 = 27,
+                                GPIO_30                 = 30,
+                                GPIO_31                 = 31,
+                                GPIO_32                 = 32,
+                                GPIO_33                 = 33,
+                                GPIO_34                 = 34,
+                                GPIO_35                 = 35,
+                                GPIO_36                 = 36,
+                                GPIO_37                 = 37,
+                                GPIO_38                 = 38,
+                                GPIO_39                 = 39,
+                                GPIO_44                 = 44,
+                                GPIO_45                 = 45,
+                                GPIO_46                 = 46,
+                                GPIO_47                 = 47,
+                                GPIO_48                 = 48,
+                                GPIO_49                 = 49,
+                                GPIO_50                 = 50,
+                                GPIO_51                 = 51,
+                                GPIO_60                 = 60,
+                                GPIO_61                 = 61,
+                                GPIO_62                 = 62,
+                                GPIO_63                 = 63,
+                                GPIO_65                 = 65,
+                                GPIO_66                 = 66,
+                                GPIO_67                 = 67,
+                                GPIO_68                 = 68,
+                                GPIO_69                 = 69,
+                                GPIO_70                 = 70,
+                                GPIO_71                 = 71,
+                                GPIO_72                 = 72,
+                                GPIO_73                 = 73,
+                                GPIO_74                 = 74,
+                                GPIO_75                 = 75,
+                                GPIO_76                 = 76,
+                                GPIO_77                 = 77,
+                                GPIO_78                 = 78,
+                                GPIO_79                 = 79,
+                                GPIO_80                 = 80,
+                                GPIO_81                 = 81,
+                                GPIO_86                 = 86,
+                                GPIO_87                 = 87,
+                                GPIO_88                 = 88,
+                                GPIO_89                 = 89,
+                                GPIO_110                = 110,
+                                GPIO_111                = 111,
+                                GPIO_112                = 112,
+                                GPIO_113                = 113,
+                                GPIO_114                = 114,
+                                GPIO_115                = 115,
+                                GPIO_116                = 116,
+                                GPIO_117                = 117
+                            };
+
+
+
+
+    /*!
+    * This enum is used for selecting the way which BlackGPIO accesses to hardware.
+    */
+    enum gpioBackend        {   gpioSysfsBackend        = 0,    /*!< value and direction files at /sys/class/gpio */
+                                gpioRegisterBackend     = 1,    /*!< memory mapped GPIO bank registers */
+                                gpioChipBackend         = 2,    /*!< line requests of /dev/gpiochipN character devices */
+                                gpioAutoBackend         = 3     /*!< gpioChipBackend if /dev/gpiochip0 exists, else gpioSysfsBackend */
+                            };
+
+    /*! @brief Holds one gpio edge event.
+     */
+    struct gpioEvent
+    {
+        unsigned int    id;                 /*!< @brief kernel gpio number of the pin, or id of the descriptor source */
+        int             value;              /*!< @brief value of the source after the edge, 0 or 1 */
+        uint64_t        timestamp;          /*!< @brief CLOCK_MONOTONIC time of the edge (gpiochip) or the wake up (others), at nanosecond level */
+    };
+
+    /*!
+    * This array is used for mapping GPIO bank number (gpio number / 32) to bank physical address.
+    */
+    const uint32_t gpioBankAddressMap[4] = {    0x44E07000,     // GPIO0
+                                                0x4804C000,     // GPIO1
+                                                0x481AC000,     // GPIO2
+                                                0x481AE000      // GPIO3
+                                            };
+
+    /*!
+    * This enum is used for defining GPIO bank register offsets from bank address.
+    */
+    enum gpioRegisterOffset {   gpioOe                  = 0x134,    /*!< output enable, "1" is input */
+                                gpioDataIn              = 0x138,    /*!< sampled pin levels */
+                                gpioDataOut             = 0x13C,    /*!< output levels */
+                                gpioClearDataOut        = 0x190,    /*!< writing "1" clears DATAOUT bit */
+                                gpioSetDataOut          = 0x194     /*!< writing "1" sets DATAOUT bit */
+                            };
+
+
+
+
+    // ######################################### BLACKCOREGPIO DECLARATION STARTS ######################################### //
+
+    /*! @brief Preparation phase of Beaglebone Black, to use GPIO.
+     *
+     *    This class is core of the BlackGPIO class. It exports the pin and sets its direction once,
+     *    and exports file paths and errors to derived class. At gpiochip backend, the pin is not
+     *    exported, because an exported line can not be requested from the character device.
+     */
+    class BlackCoreGPIO : virtual private BlackCore
+    {
+        private:
+            errorCoreGPIO   *gpioCoreErrors;            /*!< @brief is used to hold the errors of BlackCoreGPIO class */
+            std::string     gpioPath;                   /*!< @brief is used to hold the gpioN directory path */
+            gpioName        pinName;                    /*!< @brief is used to hold the selected pin @b number */
+            direction       pinDirection;               /*!< @brief is used to hold the selected pin @b direction */
+            gpioBackend     gpioLayout;                 /*!< @brief is used to hold the selected backend, never gpioAutoBackend */
+
+            /*! @brief Holds sysfs states of pins, which are known by this process.
+            *
+            *  Bit @a n of a word is gpio @a (32 x word + n). States are set by batch export, export and
+            *  direction writes of this process, and they are cleared by batch unexport.
+            */
+            struct pinStateCache
+            {
+                uint32_t    exported[4];                /*!< @brief pins whose gpioN directories exist */
+                uint32_t    directionSet[4];            /*!< @brief pins whose directions are written */
+                uint32_t    outputs[4];                 /*!< @brief written direction is output */
+            };
+
+            /*! @brief Exports process wide pin state cache.
+            *
+            *  @return Reference of the cache.
+            */
+            static pinStateCache &stateCache();
+
+            /*! @brief Writes direction file of a pin, if cached direction is different.
+            *
+            *  @param [in] number       gpio number
+            *  @param [in] pinDirect    direction (enum)
+            *  @return True if direction is set, else false.
+            */
+            static bool     writeDirection(unsigned int number, direction pinDirect);
+
+            /*! @brief Finds exported pins with one read of @b "/sys/class/gpio" directory.
+            *
+            *  @param [out] listed      exported pin bits, in state cache layout
+            *  @return True if the directory is read, else false.
+            */
+            static bool     listExportedPins(uint32_t listed[4]);
+
+            /*! @brief Device tree loading is not needed for GPIO.
+            *
+            *  GPIO pins are exported from @b "/sys/class/gpio/export" file, without overlay.
+            *  @return Always true.
+            */
+            bool            loadDeviceTree();
+
+            /*! @brief Exports pin.
+            *
+            *  This function writes pin number to @b "/sys/class/gpio/export" file, if the pin isn't at
+            *  the state cache and @b "gpioN" directory doesn't exist.
+            *  @return True if pin directory exists after call, else false.
+            */
+            bool            doExport();
+
+            /*! @brief Sets direction of pin.
+            *
+            *  This function writes @b "in" or @b "out" to direction file of the pin, if the state cache
+            *  doesn't hold the same direction.
+            *  @return True if successful, else false.
+            */
+            bool            setDirection();
+
+        protected:
+            /*! @brief Exports pin value file path to derived class.
+            *
+            *  @return Pin value file path.
+            */
+            std::string     getValueFilePath();
+
+            /*! @brief Exports pin direction file path to derived class.
+            *
+            *  @return Pin direction file path.
+            */
+            std::string     getDirectionFilePath();
+
+            /*! @brief Exports errorCoreGPIO struct to derived class.
+            *
+            *  @return errorCoreGPIO struct pointer.
+            */
+            errorCoreGPIO   *getErrorsFromCoreGPIO();
+
+            /*! @brief Exports selected backend to derived class.
+            *
+            *  @return Backend (enum), it is never gpioAutoBackend.
+            */
+            gpioBackend     getLayout();
+
+        public:
+            /*! @brief Constructor of BlackCoreGPIO class.
+            *
+            *  This function initializes errorCoreGPIO struct, exports the pin and sets its direction.
+            *  At gpiochip backend, exporting and direction setting are skipped.
+            *  @param [in] pin          gpio pin name (enum)
+            *  @param [in] pinDirect    gpio pin direction (enum)
+            *  @param [in] backend      hardware access way (enum), gpioAutoBackend is resolved with selectBackend()
+            *  @sa BlackCoreGPIO::doExport()
+            *  @sa BlackCoreGPIO::setDirection()
+            */
+                            BlackCoreGPIO(gpioName pin, direction pinDirect, gpioBackend backend = gpioSysfsBackend);
+
+            /*! @brief Resolves gpioAutoBackend.
+            *
+            *  Detection is done once per process: if @b "/dev/gpiochip0" exists (with filesystem root
+            *  prefix), gpioChipBackend is selected, else gpioSysfsBackend. Other values are returned as is.
+            *  @param [in] backend      requested backend (enum)
+            *  @return Backend which will be used (enum).
+            */
+            static gpioBackend selectBackend(gpioBackend backend);
+
+            /*! @brief Exports pins and sets their directions in one pass.
+            *
+            *  This function reads @b "/sys/class/gpio" directory once and finds exported pins from
+            *  @b "gpioN" entries. Only the missing pins are written to export file, which is opened once
+            *  for all of them; a pin which is exported by another process meanwhile (EBUSY) is counted
+            *  as exported. Then directions are written, except the ones which the state cache already
+            *  holds. Later BlackGPIO objects of these pins use the state cache and skip both steps.
+            *  @param [in] pins         gpio pin names (enum array)
+            *  @param [in] count        size of @a pins array
+            *  @param [in] directions   direction of each pin (enum array), NULL means directions aren't set
+            *  @return True if all of the pins are exported and their directions are set, else false.
+            *
+            *  @par Example
+            *  @code{.cpp}
+            *   BlackLib::gpioName  pins[3]         = { BlackLib::GPIO_60, BlackLib::GPIO_48, BlackLib::GPIO_49 };
+            *   BlackLib::direction directions[3]   = { BlackLib::output, BlackLib::input, BlackLib::input };
+            *
+            *   BlackLib::BlackCoreGPIO::exportPins(pins, 3, directions);
+            *   BlackLib::BlackGPIO led(BlackLib::GPIO_60, BlackLib::output);    // no export or direction write
+            *  @endcode
+            */
+            static bool     exportPins(const gpioName *pins, unsigned int count, const direction *directions = NULL);
+
+            /*! @brief Unexports pins in one pass.
+            *
+            *  This function reads @b "/sys/class/gpio" directory once, and writes only the exported pins
+            *  to unexport file, which is opened once. States of the pins are cleared from state cache.
+            *  @param [in] pins         gpio pin names (enum array)
+            *  @param [in] count        size of @a pins array
+            *  @return True if all of the writes are successful, else false.
+            */
+            static bool     unexportPins(const gpioName *pins, unsigned int count);
+
+            /*! @brief Destructor of BlackCoreGPIO class.
+            *
+            *  This function deletes errorCoreGPIO struct pointer.
+            */
+            virtual         ~BlackCoreGPIO();
+
+            /*! @brief First declaration of this function.
+            */
+            virtual std::string getValue() = 0;
+    };
+    // ########################################## BLACKCOREGPIO DECLARATION ENDS ########################################## //
+
+
+
+
+
+    // ########################################## BLACKGPIOCHIP DECLARATION STARTS ######################################## //
+
+    /*! @brief Opens gpiochip character devices and issues their ioctl requests.
+     *
+     *    All of the gpiochip accesses of BlackLib pass through the process wide device object, which
+     *    uses open() and ioctl() by default. A test can derive from this class, override openChip() and
+     *    lineIoctl(), and install its fake with setDevice(); the fake can return any readable descriptor
+     *    (like a pipe) as line request descriptor, and write gpio_v2_line_event records to it.
+     */
+    class BlackGPIOChipDevice
+    {
+        public:
+            /*! @brief Destructor of BlackGPIOChipDevice class.
+            */
+            virtual         ~BlackGPIOChipDevice() {}
+
+            /*! @brief Opens a gpiochip character device.
+            *
+            *  @param [in] path         device path, like @b "/dev/gpiochip1"
+            *  @return Descriptor of the device, or -1 if opening fails.
+            */
+            virtual int     openChip(const std::string &path);
+
+            /*! @brief Issues a gpiochip or line request ioctl.
+            *
+            *  @param [in] fd           chip or line request descriptor
+            *  @param [in] request      ioctl request, like GPIO_V2_GET_LINE_IOCTL
+            *  @param [in,out] argument request argument
+            *  @return 0 if successful, else -1.
+            */
+            virtual int     lineIoctl(int fd, unsigned long request, void *argument);
+
+            /*! @brief Installs process wide device object.
+            *
+            *  @param [in] device       new device object, NULL installs the default object
+            */
+            static void     setDevice(BlackGPIOChipDevice *device);
+
+            /*! @brief Exports process wide device object.
+            *
+            *  @return Reference of installed device object.
+            */
+            static BlackGPIOChipDevice &getDevice();
+
+        private:
+            /*! @brief Holds installed device object.
+            */
+            static BlackGPIOChipDevice *&installedDevice();
+    };
+
+
+
+    /*! @brief Requests several lines of one gpiochip together (gpio v2 uAPI).
+     *
+     *    All lines of the request have the same direction. Values of the lines are read or written
+     *    with one ioctl as bits of a word: bit i is the line at index i of @a offsets. Input lines
+     *    can generate kernel timestamped edge events and can use hardware debouncing. At BeagleBone
+     *    Black, gpio number N is line <b> N % 32 </b> of @b "/dev/gpiochip<N / 32>".
+     *
+     * @par Example
+     * @code{.cpp}
+     *   unsigned int offsets[3] = { 12, 13, 14 };                     // GPIO_44, GPIO_45, GPIO_46
+     *   BlackLib::BlackGPIOChipLines outputs(1, offsets, 3, BlackLib::output);
+     *   outputs.setValues(0x5);                                       // one ioctl
+     *
+     *   unsigned int buttons[2] = { 16, 17 };                         // GPIO_48, GPIO_49
+     *   BlackLib::BlackGPIOChipLines inputs(1, buttons, 2, BlackLib::input, BlackLib::bothEdges, 5000);
+     *
+     *   BlackLib::gpioEvent events[16];
+     *   int count = inputs.readEvents(events, 16);                    // one read()
+     * @endcode
+     */
+    class BlackGPIOChipLines
+    {
+        private:
+            int             lineFd;                     /*!< @brief is used to hold the line request descriptor */
+            unsigned int    chipNumber;                 /*!< @brief is used to hold the gpiochip number */
+            unsigned int    lineCount;                  /*!< @brief is used to hold number of requested lines */
+            unsigned int    lineOffsets[GPIO_V2_LINES_MAX]; /*!< @brief is used to hold line offsets at the chip */
+            uint64_t        lineFlags;                  /*!< @brief is used to hold direction and edge flags of the request */
+            uint64_t        allLinesMask;               /*!< @brief is used to hold word bits which have a line */
+
+            /*! @brief Copying is not allowed, because the object owns the line request.
+            */
+                            BlackGPIOChipLines(const BlackGPIOChipLines &);
+
+            /*! @brief Copying is not allowed, because the object owns the line request.
+            */
+            BlackGPIOChipLines &operator=(const BlackGPIOChipLines &);
+
+            /*! @brief Fills line configuration of the request.
+            *
+            *  @param [out] config      configuration
+            *  @param [in] debouncePeriod debounce period at microsecond level, 0 means no debouncing
+            */
+            void            fillConfig(gpio_v2_line_config &config, unsigned int debouncePeriod);
+
+        public:
+            /*! @brief Constructor of BlackGPIOChipLines class.
+            *
+            *  This function requests lines from @b "/dev/gpiochip<chip>" with one ioctl. Maximum
+            *  GPIO_V2_LINES_MAX (64) lines can be requested; the rest of the offsets are ignored.
+            *  @param [in] chip         gpiochip number
+            *  @param [in] offsets      line offsets at the chip
+            *  @param [in] count        number of offsets
+            *  @param [in] pinDirect    direction of all lines (enum)
+            *  @param [in] edge         edges which generate events, only for input lines (enum)
+            *  @param [in] debouncePeriod debounce period at microsecond level, only for input lines
+            */
+                            BlackGPIOChipLines(unsigned int chip, const unsigned int *offsets, unsigned int count,
+                                               direction pinDirect, edgeType edge = noEdge, unsigned int debouncePeriod = 0);
+
+            /*! @brief Destructor of BlackGPIOChipLines class.
+            *
+            *  This function releases the lines.
+            */
+            virtual         ~BlackGPIOChipLines();
+
+            /*! @brief Checks the line request.
+            *
+            *  @return True if lines are requested, else false.
+            */
+            bool            isRequested();
+
+            /*! @brief Exports number of requested lines.
+            *
+            *  @return Number of lines.
+            */
+            unsigned int    getLineCount();
+
+            /*! @brief Exports line request descriptor, which can be polled for edge events.
+            *
+            *  @return Descriptor, or -1 if lines are not requested.
+            */
+            int             getFd();
+
+            /*! @brief Reads values of the lines with one ioctl.
+            *
+            *  @param [out] bits        bit i is the value of line i
+            *  @param [in] mask         lines which will be read, default value is all of the lines
+            *  @return True if reading is successful, else false.
+            */
+            bool            getValues(uint64_t &bits, uint64_t mask = ~0ULL);
+
+            /*! @brief Writes values of the lines with one ioctl.
+            *
+            *  @param [in] bits         bit i is the new value of line i
+            *  @param [in] mask         lines which will be written, default value is all of the lines
+            *  @return True if writing is successful, else false.
+            */
+            bool            setValues(uint64_t bits, uint64_t mask = ~0ULL);
+
+            /*! @brief Changes hardware debounce period of all lines.
+            *
+            *  @param [in] debouncePeriod debounce period at microsecond level, 0 disables debouncing
+            *  @return True if changing is successful, else false.
+            */
+            bool            setDebounce(unsigned int debouncePeriod);
+
+            /*! @brief Reads waiting edge events with one read() call.
+            *
+            *  This function doesn't wait; if there is no event, it returns 0. Event id is the gpio
+            *  number of the line (chip x 32 + offset), value is 1 for rising and 0 for falling edge,
+            *  timestamp is taken by the kernel at the interrupt.
+            *  @param [out] events      event array
+            *  @param [in] maxCount     size of @a events array
+            *  @return Number of read events, or -1 if reading fails.
+            */
+            int             readEvents(gpioEvent *events, unsigned int maxCount);
+    };
+    // ########################################### BLACKGPIOCHIP DECLARATION ENDS ######################################### //
+
+
+
+
+
+    // ######################################## BLACKGPIOBACKEND DECLARATION STARTS ###################################### //
+
+    /*! @brief Hardware access interface of BlackGPIO.
+     */
+    class BlackGPIOBackend
+    {
+        public:
+            /*! @brief Destructor of BlackGPIOBackend class.
+            */
+            virtual         ~BlackGPIOBackend() {}
+
+            /*! @brief Reads value of pin.
+            *
+            *  @param [out] value       read value, 0 or 1
+            *  @return True if reading is successful, else false.
+            */
+            virtual bool    readValue(int &value) = 0;
+
+            /*! @brief Writes value of pin.
+            *
+            *  @param [in] value        new value (enum)
+            *  @return True if writing is successful, else false.
+            */
+            virtual bool    writeValue(digitalValue value) = 0;
+
+            /*! @brief Checks that pin can be accessed.
+            *
+            *  @return True if pin is accessible, else false.
+            */
+            virtual bool    isExported() = 0;
+
+            /*! @brief Checks direction of pin.
+            *
+            *  @param [in] pinDirect    expected direction (enum)
+            *  @return True if pin direction is @a pinDirect, else false.
+            */
+            virtual bool    isDirectionSet(direction pinDirect) = 0;
+
+            /*! @brief Exports backend type.
+            *
+            *  @return Backend type (enum).
+            */
+            virtual gpioBackend getType() = 0;
+    };
+
+
+
+    /*! @brief Accesses pin through value and direction files of /sys/class/gpio.
+     *
+     *    Files are opened once and held open; every access is one pread() or pwrite() call at offset 0.
+     */
+    class BlackGPIOSysfsBackend : public BlackGPIOBackend
+    {
+        private:
+            int             valueFd;                    /*!< @brief is used to hold the @a value file descriptor */
+            int             directionFd;                /*!< @brief is used to hold the @a direction file descriptor */
+
+        public:
+            /*! @brief Constructor of BlackGPIOSysfsBackend class.
+            *
+            *  @param [in] valuePath        value file path
+            *  @param [in] directionPath    direction file path
+            *  @param [in] pinDirect        pin direction (enum), value file of input pin is opened read only
+            */
+                            BlackGPIOSysfsBackend(const std::string &valuePath, const std::string &directionPath, direction pinDirect);
+
+            /*! @brief Destructor of BlackGPIOSysfsBackend class.
+            *
+            *  This function closes value and direction files.
+            */
+            virtual         ~BlackGPIOSysfsBackend();
+
+            /*! @sa BlackGPIOBackend::readValue() */
+            bool            readValue(int &value);
+
+            /*! @sa BlackGPIOBackend::writeValue() */
+            bool            writeValue(digitalValue value);
+
+            /*! @brief Checks that value file can be read.
+            *  @sa BlackGPIOBackend::isExported()
+            */
+            bool            isExported();
+
+            /*! @brief Compares content of direction file with @a pinDirect.
+            *  @sa BlackGPIOBackend::isDirectionSet()
+            */
+            bool            isDirectionSet(direction pinDirect);
+
+            /*! @sa BlackGPIOBackend::getType() */
+            gpioBackend     getType();
+    };
+
+
+
+    /*! @brief Accesses pin through memory mapped GPIO bank registers.
+     *
+     *    This backend maps the GPIO bank of the pin (bank = gpio number / 32, bit = gpio number % 32)
+     *    and uses its registers directly: writing a value is one store of the pin mask to SETDATAOUT or
+     *    CLEARDATAOUT register, reading is one load of DATAIN (input) or DATAOUT (output) register.
+     *    Direction is set and checked at OE register, where "1" means input.
+     *
+     *    Bank clock and pinmux are prepared by the kernel, because BlackCoreGPIO exports the pin for
+     *    both of the backends.
+     */
+    class BlackGPIORegisterBackend : public BlackGPIOBackend
+    {
+        private:
+            BlackMemoryRegion   *region;                /*!< @brief is used to hold mapped GPIO bank */
+            uint32_t            pinMask;                /*!< @brief is used to hold the bit of pin at bank registers */
+            volatile uint32_t   *setRegister;           /*!< @brief is used to hold the SETDATAOUT register address */
+            volatile uint32_t   *clearRegister;         /*!< @brief is used to hold the CLEARDATAOUT register address */
+            volatile uint32_t   *readRegister;          /*!< @brief is used to hold the DATAIN or DATAOUT register address */
+
+            /*! @brief Copying is not allowed, because the object owns the mapping.
+            */
+                            BlackGPIORegisterBackend(const BlackGPIORegisterBackend &);
+
+            /*! @brief Copying is not allowed, because the object owns the mapping.
+            */
+            BlackGPIORegisterBackend &operator=(const BlackGPIORegisterBackend &);
+
+        public:
+            /*! @brief Constructor of BlackGPIORegisterBackend class.
+            *
+            *  This function maps the GPIO bank of @a pin and sets OE bit of the pin for @a pinDirect.
+            *  @param [in] pin          gpio pin name (enum)
+            *  @param [in] pinDirect    pin direction (enum)
+            */
+                            BlackGPIORegisterBackend(gpioName pin, direction pinDirect);
+
+            /*! @brief Destructor of BlackGPIORegisterBackend class.
+            *
+            *  This function unmaps the bank.
+            */
+            virtual         ~BlackGPIORegisterBackend();
+
+            /*! @sa BlackGPIOBackend::readValue() */
+            bool            readValue(int &value);
+
+            /*! @sa BlackGPIOBackend::writeValue() */
+            bool            writeValue(digitalValue value);
+
+            /*! @brief Checks that bank is mapped.
+            *  @sa BlackGPIOBackend::isExported()
+            */
+            bool            isExported();
+
+            /*! @brief Compares OE bit of pin with @a pinDirect.
+            *  @sa BlackGPIOBackend::isDirectionSet()
+            */
+            bool            isDirectionSet(direction pinDirect);
+
+            /*! @sa BlackGPIOBackend::getType() */
+            gpioBackend     getType();
+    };
+
+
+
+    /*! @brief Accesses pin through a line request of gpiochip character device.
+     *
+     *    The backend either requests its own line, or uses one line of a shared BlackGPIOChipLines
+     *    object (like the requests of BlackGPIOPort), which must live longer than the backend.
+     */
+    class BlackGPIOChipBackend : public BlackGPIOBackend
+    {
+        private:
+            BlackGPIOChipLines  *lines;                 /*!< @brief is used to hold the line request */
+            uint64_t            lineMask;               /*!< @brief is used to hold the bit of pin at the line request */
+            direction           lineDirection;          /*!< @brief is used to hold the requested direction */
+            bool                isOwner;                /*!< @brief is used to hold whether @a lines is deleted by the backend */
+
+            /*! @brief Copying is not allowed, because the object can own the line request.
+            */
+                            BlackGPIOChipBackend(const BlackGPIOChipBackend &);
+
+            /*! @brief Copying is not allowed, because the object can own the line request.
+            */
+            BlackGPIOChipBackend &operator=(const BlackGPIOChipBackend &);
+
+        public:
+            /*! @brief Constructor of BlackGPIOChipBackend class, which requests its own line.
+            *
+            *  @param [in] pin          gpio pin name (enum)
+            *  @param [in] pinDirect    pin direction (enum)
+            */
+                            BlackGPIOChipBackend(gpioName pin, direction pinDirect);
+
+            /*! @brief Constructor of BlackGPIOChipBackend class, which uses a shared line request.
+            *
+            *  @param [in] sharedLines  line request which includes the pin
+            *  @param [in] index        index of the pin at @a sharedLines
+            *  @param [in] pinDirect    direction of @a sharedLines (enum)
+            */
+                            BlackGPIOChipBackend(BlackGPIOChipLines *sharedLines, unsigned int index, direction pinDirect);
+
+            /*! @brief Destructor of BlackGPIOChipBackend class.
+            *
+            *  This function releases the line, if it is requested by the backend.
+            */
+            virtual         ~BlackGPIOChipBackend();
+
+            /*! @sa BlackGPIOBackend::readValue() */
+            bool            readValue(int &value);
+
+            /*! @sa BlackGPIOBackend::writeValue() */
+            bool            writeValue(digitalValue value);
+
+            /*! @brief Checks that line is requested.
+            *  @sa BlackGPIOBackend::isExported()
+            */
+            bool            isExported();
+
+            /*! @brief Compares requested direction with @a pinDirect.
+            *  @sa BlackGPIOBackend::isDirectionSet()
+            */
+            bool            isDirectionSet(direction pinDirect);
+
+            /*! @sa BlackGPIOBackend::getType() */
+            gpioBackend     getType();
+    };
+    // ######################################### BLACKGPIOBACKEND DECLARATION ENDS ####################################### //
+
+
+
+
+
+    // ########################################### BLACKGPIO DECLARATION STARTS ########################################### //
+
+    /*! @brief Interacts with end user, to use GPIO.
+     *
+     *    This class is end node to use GPIO. End users read and write GPIO pins from this class.
+     *    With sysfs backend, value and direction files of the pin are opened once at construction and
+     *    held open; every read or write is one pread() or pwrite() call at offset 0 of these
+     *    descriptors. With register backend, GPIO bank registers are used directly. With gpiochip
+     *    backend, the line is requested from @b "/dev/gpiochipN" and every access is one ioctl. By
+     *    default, gpiochip backend is used when the character device exists, else sysfs backend.
+     *    Errors are reported through errorGPIO and errorCoreGPIO structs.
+     *
+     * @par Example
+     * @code{.cpp}
+     *  #include <iostream>
+     *  #include "BlackGPIO.h"
+     *
+     *  int main()
+     *  {
+     *      BlackLib::BlackGPIO  led(BlackLib::GPIO_60, BlackLib::output, BlackLib::fastMode);
+     *      BlackLib::BlackGPIO  button(BlackLib::GPIO_48, BlackLib::input);
+     *      BlackLib::BlackGPIO  clock(BlackLib::GPIO_49, BlackLib::output, BlackLib::fastMode, BlackLib::gpioRegisterBackend);
+     *
+     *      led.setValue(BlackLib::high);
+     *      std::cout << "Button: " << button.getValue() << std::endl;
+     *
+     *      return 0;
+     *  }
+     * @endcode
+     */
+    class BlackGPIO : virtual private BlackCoreGPIO
+    {
+        private:
+            errorGPIO       *gpioErrors;                /*!< @brief is used to hold the errors of BlackGPIO class */
+            std::string     valuePath;                  /*!< @brief is used to hold the @a value file path */
+            std::string     directionPath;              /*!< @brief is used to hold the @a direction file path */
+            BlackGPIOBackend *backend;                  /*!< @brief is used to hold the hardware access backend */
+            gpioName        pinName;                    /*!< @brief is used to hold the selected pin @b number */
+            direction       pinDirection;               /*!< @brief is used to hold the selected pin @b direction */
+            workingMode     workMode;                   /*!< @brief is used to hold the working mode */
+
+            /*! @brief Reads value file.
+            *
+            *  @param [out] value       read value, 0 or 1
+            *  @return True if reading is successful, else false.
+            */
+            bool            readValue(int &value);
+
+            /*! @brief Writes value file.
+            *
+            *  @param [in] value        new value
+            *  @return True if writing is successful, else false.
+            */
+            bool            writeValue(digitalValue value);
+
+        public:
+            /*!
+            * This enum is used to define GPIO debugging flags.
+            */
+            enum flags      {   exportErr       = 0,    /*!< enumeration for @a errorGPIO::exportError status */
+                                directionErr    = 1,    /*!< enumeration for @a errorGPIO::directionError status */
+                                readErr         = 2,    /*!< enumeration for @a errorGPIO::readError status */
+                                writeErr        = 3,    /*!< enumeration for @a errorGPIO::writeError status */
+                                forcingErr      = 4,    /*!< enumeration for @a errorGPIO::forcingError status */
+                                exportFileErr   = 5,    /*!< enumeration for @a errorCoreGPIO::exportFileError status */
+                                directionFileErr= 6     /*!< enumeration for @a errorCoreGPIO::directionFileError status */
+                            };
+
+            /*! @brief Constructor of BlackGPIO class.
+            *
+            * This function initializes BlackCoreGPIO class, which exports the pin and sets its
+            * direction, and errorGPIO struct. Then it creates the selected backend. Sysfs backend opens
+            * value and direction files of the pin and holds them open until destruction of the object;
+            * register backend maps GPIO bank of the pin; gpiochip backend requests the line instead.
+            * @param [in] pin        gpio pin name (enum)
+            * @param [in] pinDirect  gpio pin direction (enum), BlackLib::input or BlackLib::output
+            * @param [in] runMode    working mode (enum), default value is secureMode
+            * @param [in] backend    hardware access way (enum), default value is gpioAutoBackend
+            *
+            * @sa gpioName
+            * @sa direction
+            * @sa workingMode
+            * @sa gpioBackend
+            * @sa BlackCoreGPIO::selectBackend()
+            */
+                            BlackGPIO(gpioName pin, direction pinDirect, workingMode runMode = secureMode,
+                                      gpioBackend backend = gpioAutoBackend);
+
+            /*! @brief Constructor of BlackGPIO class, which uses a ready backend.
+            *
+            * The pin is prepared for the type of @a customBackend (see BlackCoreGPIO()), and the object
+            * deletes @a customBackend at destruction.
+            * @param [in] pin            gpio pin name (enum)
+            * @param [in] pinDirect      gpio pin direction (enum)
+            * @param [in] runMode        working mode (enum)
+            * @param [in] customBackend  backend object, like a BlackGPIOChipBackend which uses shared lines
+            */
+                            BlackGPIO(gpioName pin, direction pinDirect, workingMode runMode, BlackGPIOBackend *customBackend);
+
+            /*! @brief Destructor of BlackGPIO class.
+            *
+            * This function deletes backend, which closes files or unmaps registers, and deletes
+            * errorGPIO struct pointer.
+            */
+            virtual         ~BlackGPIO();
+
+            /*! @brief Reads value of gpio pin as string.
+            *
+            * At secure mode, readiness of pin is checked firstly.
+            * @return @b "0" or @b "1" if reading is successful. If pin isn't ready, it returns
+            * BlackLib::GPIO_PIN_NOT_READY_STRING; if reading fails, BlackLib::FILE_COULD_NOT_OPEN_STRING.
+            */
+            std::string     getValue();
+
+            /*! @brief Reads value of gpio pin as integer.
+            *
+            * At secure mode, readiness of pin is checked firstly.
+            * @return 0 or 1 if reading is successful. If pin isn't ready, it returns
+            * BlackLib::GPIO_PIN_NOT_READY_INT; if reading fails, BlackLib::FILE_COULD_NOT_OPEN_INT.
+            */
+            int             getNumericValue();
+
+            /*! @brief Exports pin name.
+            *
+            * @return Pin name (enum).
+            */
+            gpioName        getName();
+
+            /*! @brief Exports pin direction.
+            *
+            * @return Pin direction (enum).
+            */
+            direction       getDirection();
+
+            /*! @brief Exports used backend.
+            *
+            * @return Backend type (enum), it is never gpioAutoBackend.
+            */
+            gpioBackend     getBackend();
+
+            /*! @brief Sets value of gpio pin.
+            *
+            * Input pins can't be written, errorGPIO::forcingError is set in this case. At secure mode,
+            * readiness of pin is checked firstly.
+            * @param [in] status     new value (enum)
+            * @return True if writing is successful, else false.
+            *
+            * @par Example
+            * @code{.cpp}
+            *   BlackLib::BlackGPIO led(BlackLib::GPIO_60, BlackLib::output);
+            *
+            *   led.setValue(BlackLib::high);
+            *   led.setValue(BlackLib::low);
+            * @endcode
+            */
+            bool            setValue(digitalValue status);
+
+            /*! @brief Checks value of gpio pin.
+            *
+            * @return True if pin value is 1, else false.
+            */
+            bool            isHigh();
+
+            /*! @brief Toggles value of output pin.
+            *
+            * Current value is read and its inverse is written.
+            */
+            void            toggleValue();
+
+            /*! @brief Checks export status of gpio pin.
+            *
+            * Pin is exported if its value file descriptor is open and it can be read (sysfs backend),
+            * or its bank is mapped (register backend).
+            * @return True if pin is exported, else false.
+            */
+            bool            isExported();
+
+            /*! @brief Checks direction of gpio pin.
+            *
+            * Direction file is read from its held descriptor (sysfs backend) or OE register is read
+            * (register backend), and compared with selected direction.
+            * @return True if pin direction is same with selected direction, else false.
+            */
+            bool            isDirectionSet();
+
+            /*! @brief Checks export and direction status of gpio pin.
+            *
+            * @return True if pin is exported and its direction is set, else false.
+            */
+            bool            isReady();
+
+            /*! @brief Is used for general debugging.
+            *
+            * @return True if any error occured, else false.
+            */
+            bool            fail();
+
+            /*! @brief Is used for specific debugging.
+            *
+            * @param [in] f          specific error type (enum)
+            * @return Value of @a f argument's mapped error.
+            */
+            bool            fail(BlackGPIO::flags f);
+
+            /*! @brief Reads value of gpio pin as string with ">>" operator.
+            *
+            * @param [out] readToThis    read value
+            * @return Reference of the object.
+            * @sa getValue()
+            */
+            BlackGPIO       &operator>>(std::string &readToThis);
+
+            /*! @brief Reads value of gpio pin as integer with ">>" operator.
+            *
+            * @param [out] readToThis    read value
+            * @return Reference of the object.
+            * @sa getNumericValue()
+            */
+            BlackGPIO       &operator>>(int &readToThis);
+
+            /*! @brief Sets value of gpio pin with "<<" operator.
+            *
+            * @param [in] value          new value (enum)
+            * @return Reference of the object.
+            * @sa setValue()
+            */
+            BlackGPIO       &operator<<(digitalValue value);
+    };
+    // ############################################ BLACKGPIO DECLARATION ENDS ############################################ //
+
+
+
+
+
+    // ########################################### BLACKGPIOPORT DECLARATION STARTS ######################################## //
+
+    /*! @brief Reads and writes several gpio pins together.
+     *
+     *    This class owns one BlackGPIO object per member pin and handles the members as bits of one
+     *    word: bit i of the word is the member which is at index i of the constructor parameter.
+     *    Bank of every member and bank masks of the port are computed once at construction.
+     *
+     *    With register backend, a write is one SETDATAOUT store for members which go high and one
+     *    CLEARDATAOUT store for members which go low, at each used bank. These stores are atomic
+     *    against other writers of the bank, so rising members of a bank change in the same cycle, and
+     *    falling members change a few cycles later. With setSameCycleWrite(), mixed levels of a bank
+     *    are written with one read-modify-write store of DATAOUT register instead. A read is one load
+     *    per used bank. With gpiochip backend, members of each bank are
+     *    requested together as lines of one BlackGPIOChipLines object, so a write or a read is one
+     *    ioctl per used bank, and the kernel changes the lines of a bank together. With sysfs backend,
+     *    members are written and read one by one through their held value files.
+     *
+     * @par Example
+     * @code{.cpp}
+     *   BlackLib::gpioName busPins[4] = { BlackLib::GPIO_44, BlackLib::GPIO_45, BlackLib::GPIO_46, BlackLib::GPIO_47 };
+     *   BlackLib::BlackGPIOPort bus(busPins, 4, BlackLib::output, BlackLib::gpioRegisterBackend);
+     *
+     *   bus.setValues(0x5);        // GPIO_44 and GPIO_46 high, GPIO_45 and GPIO_47 low
+     *   bus.setBits(0x2);          // GPIO_45 high, others are not changed
+     *   bus.clearBits(0x1);        // GPIO_44 low, others are not changed
+     *
+     *   uint32_t states = bus.getValues();
+     * @endcode
+     */
+    class BlackGPIOPort
+    {
+        private:
+            BlackGPIO           *members[32];           /*!< @brief is used to hold member gpio objects */
+            unsigned int        memberCount;            /*!< @brief is used to hold number of member gpio objects */
+            uint32_t            memberBitsMask;         /*!< @brief is used to hold word bits which have a member */
+            direction           portDirection;          /*!< @brief is used to hold direction of the members */
+            gpioBackend         portBackend;            /*!< @brief is used to hold hardware access way of the port, never gpioAutoBackend */
+            bool                portError;              /*!< @brief is used to hold failure of the last port access */
+            bool                isSameCycleWrite;       /*!< @brief is used to hold DATAOUT read-modify-write mode of mixed levels (register backend) */
+
+            unsigned int        memberBank[32];         /*!< @brief is used to hold bank number of each member */
+            uint32_t            memberPinMask[32];      /*!< @brief is used to hold bank register bit of each member */
+            uint32_t            bankMask[4];            /*!< @brief is used to hold bank register bits of all members at each bank */
+            BlackMemoryRegion   *banks[4];              /*!< @brief is used to hold mapped banks which have a member (register backend) */
+            BlackGPIOChipLines  *chipLines[4];          /*!< @brief is used to hold line requests of banks which have a member (gpiochip backend) */
+            unsigned int        memberLine[32];         /*!< @brief is used to hold line index of each member at its bank request (gpiochip backend) */
+
+            /*! @brief Copying is not allowed, because members are owned by the port.
+            */
+                                BlackGPIOPort(const BlackGPIOPort &);
+
+            /*! @brief Copying is not allowed, because members are owned by the port.
+            */
+            BlackGPIOPort       &operator=(const BlackGPIOPort &);
+
+            /*! @brief Drives selected members high and low.
+            *
+            * @param [in] setBits    word bits of the members which will be high
+            * @param [in] clearBits  word bits of the members which will be low
+            * @return True if all of the writes are successful, else false.
+            */
+            bool                applyBits(uint32_t setBits, uint32_t clearBits);
+
+        public:
+            /*! @brief Constructor of BlackGPIOPort class.
+            *
+            * This function creates one BlackGPIO object for each entered pin name, with the same
+            * direction and backend. Maximum 32 members can be used; the rest of the entered names are
+            * ignored. With register backend, every bank which has a member is mapped once. With gpiochip
+            * backend, members of every bank are requested with one line request, which is shared by
+            * member objects.
+            * @param [in] pins       gpio pin names (enum array)
+            * @param [in] count      number of entered pin names
+            * @param [in] pinDirect  direction of all members (enum)
+            * @param [in] backend    hardware access way (enum), default value is gpioAutoBackend
+            *
+            * @sa gpioName
+            * @sa gpioBackend
+            */
+                                BlackGPIOPort(const gpioName *pins, unsigned int count, direction pinDirect,
+                                              gpioBackend backend = gpioAutoBackend);
+
+            /*! @brief Destructor of BlackGPIOPort class.
+            *
+            * This function deletes member BlackGPIO objects, then unmaps the banks and releases the
+            * line requests.
+            */
+            virtual             ~BlackGPIOPort();
+
+            /*! @brief Exports number of members.
+            *
+            * @return Number of member gpio objects.
+            */
+            unsigned int        getPinCount();
+
+            /*! @brief Exports member gpio object.
+            *
+            * @param [in] index      member index, order of the constructor parameter
+            * @return Reference of member BlackGPIO object.
+            */
+            BlackGPIO           &getPin(unsigned int index);
+
+            /*! @brief Sets values of all members.
+            *
+            * @param [in] states     bit i is the new value of member i
+            * @return True if writing is successful, else false. Writing to input port fails.
+            */
+            bool                setValues(uint32_t states);
+
+            /*! @brief Drives selected members high.
+            *
+            * @param [in] bits       bit i selects member i, members which are not selected are not changed
+            * @return True if writing is successful, else false. Writing to input port fails.
+            */
+            bool                setBits(uint32_t bits);
+
+            /*! @brief Drives selected members low.
+            *
+            * @param [in] bits       bit i selects member i, members which are not selected are not changed
+            * @return True if writing is successful, else false. Writing to input port fails.
+            */
+            bool                clearBits(uint32_t bits);
+
+            /*! @brief Sets write way of mixed levels at register backend.
+            *
+            * By default, members of a bank which go high and low are written with a SETDATAOUT store
+            * and a CLEARDATAOUT store. If @a isEnabled is true, they are written with one read-modify-write
+            * store of DATAOUT register, so all changed members of the bank switch in the same cycle.
+            * @param [in] isEnabled  new write way, default value of the port is false
+            * @warning The read-modify-write isn't atomic. A write of another writer of the same bank
+            * (another port, another BlackGPIO object, BlackSoftPWM thread or another process), which
+            * lands between the load and the store, is silently reverted. Enable it only if the port is
+            * the only writer of its banks.
+            */
+            void                setSameCycleWrite(bool isEnabled);
+
+            /*! @brief Reads values of all members.
+            *
+            * @return Packed values, bit i is the value of member i. Failed members are read as 0.
+            */
+            uint32_t            getValues();
+
+            /*! @brief Is used for general debugging.
+            *
+            * @return True if the last port access or any member failed, else false.
+            * @sa BlackGPIO::fail()
+            */
+            bool                fail();
+    };
+    // ############################################ BLACKGPIOPORT DECLARATION ENDS ######################################### //
+
+
+
+
+
+    // ########################################## BLACKCOREGPIO DEFINITION STARTS ######################################### //
+    BlackCoreGPIO::BlackCoreGPIO(gpioName pin, direction pinDirect, gpioBackend backend)
+    {
+        this->pinName           = pin;
+        this->pinDirection      = pinDirect;
+        this->gpioLayout        = BlackCoreGPIO::selectBackend(backend);
+        this->gpioCoreErrors    = new errorCoreGPIO( this->getErrorsFromCore() );
+        this->gpioPath          = BlackCore::getFilesystemRoot() + "/sys/class/gpio/gpio" + tostr(static_cast<int>(pin));
+
+        if( this->gpioLayout != gpioChipBackend and this->doExport() )
+        {
+            this->setDirection();
+        }
+    }
+
+    gpioBackend BlackCoreGPIO::selectBackend(gpioBackend backend)
+    {
+        if( backend != gpioAutoBackend )
+        {
+            return backend;
+        }
+
+        static gpioBackend detectedBackend = gpioAutoBackend;
+
+        if( detectedBackend == gpioAutoBackend )
+        {
+            std::string chipPath = BlackCore::getFilesystemRoot() + "/dev/gpiochip0";
+            detectedBackend = ( ::access(chipPath.c_str(), F_OK) == 0 ) ? gpioChipBackend : gpioSysfsBackend;
+        }
+
+        return detectedBackend;
+    }
+
+    BlackCoreGPIO::~BlackCoreGPIO()
+    {
+        delete this->gpioCoreErrors;
+    }
+
+    bool        BlackCoreGPIO::loadDeviceTree()
+    {
+        return true;
+    }
+
+    BlackCoreGPIO::pinStateCache &BlackCoreGPIO::stateCache()
+    {
+        static pinStateCache cache = { { 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 0, 0, 0, 0 } };
+        return cache;
+    }
+
+    bool        BlackCoreGPIO::writeDirection(unsigned int number, direction pinDirect)
+    {
+        pinStateCache &cache    = BlackCoreGPIO::stateCache();
+        unsigned int word       = (number / 32) % 4;
+        uint32_t bit            = (1u << (number % 32));
+        uint32_t outputBit      = (pinDirect == output) ? bit : 0;
+
+        if( (cache.directionSet[word] & bit) and (cache.outputs[word] & bit) == outputBit )
+        {
+            return true;
+        }
+
+        std::string directionPath = BlackCore::getFilesystemRoot() + "/sys/class/gpio/gpio" + tostr(static_cast<int>(number)) + "/direction";
+        int directionFd = ::open(directionPath.c_str(), O_WRONLY);
+        if( directionFd < 0 )
+        {
+            return false;
+        }
+
+        const char *text    = (pinDirect == output) ? "out\n" : "in\n";
+        size_t textSize     = strlen(text);
+        ssize_t writeSize   = ::pwrite(directionFd, text, textSize, 0);
+        ::close(directionFd);
+
+        if( writeSize != static_cast<ssize_t>(textSize) )
+        {
+            cache.directionSet[word] &= ~bit;
+            return false;
+        }
+
+        cache.directionSet[word]    |= bit;
+        cache.outputs[word]         = (cache.outputs[word] & ~bit) | outputBit;
+        return true;
+    }
+
+    bool        BlackCoreGPIO::listExportedPins(uint32_t listed[4])
+    {
+        std::string classPath = BlackCore::getFilesystemRoot() + "/sys/class/gpio";
+
+        DIR *path = opendir(classPath.c_str());
+        if( path == NULL )
+        {
+            return false;
+        }
+
+        listed[0] = listed[1] = listed[2] = listed[3] = 0;
+
+        dirent *entry;
+        while( (entry = readdir(path)) != NULL )
+        {
+            // gpioN entries, not gpiochipN
+            if( strncmp(entry->d_name, "gpio", 4) != 0 or entry->d_name[4] < '0' or entry->d_name[4] > '9' )
+            {
+                continue;
+            }
+
+            unsigned int number = static_cast<unsigned int>( atoi(entry->d_name + 4) );
+            if( number < 128 )
+            {
+                listed[number / 32] |= (1u << (number % 32));
+            }
+        }
+
+        closedir(path);
+        return true;
+    }
+
+    bool        BlackCoreGPIO::exportPins(const gpioName *pins, unsigned int count, const direction *directions)
+    {
+        pinStateCache &cache    = BlackCoreGPIO::stateCache();
+        std::string classPath   = BlackCore::getFilesystemRoot() + "/sys/class/gpio";
+        uint32_t isListed[4];
+
+        // one directory read finds all of the exported pins
+        if( ! BlackCoreGPIO::listExportedPins(isListed) )
+        {
+            return false;
+        }
+
+        bool isSuccess  = true;
+        int exportFd    = -1;
+
+        for( unsigned int i = 0 ; i < count ; i++ )
+        {
+            unsigned int number = static_cast<unsigned int>(pins[i]);
+            unsigned int word   = (number / 32) % 4;
+            uint32_t bit        = (1u << (number % 32));
+
+            if( (isListed[word] & bit) == 0 )
+            {
+                if( exportFd < 0 )
+                {
+                    exportFd = ::open((classPath + "/export").c_str(), O_WRONLY);
+                }
+
+                std::string text    = tostr(static_cast<int>(number)) + "\n";
+                ssize_t writeSize   = (exportFd < 0) ? -1 : ::write(exportFd, text.c_str(), text.size());
+
+                if( writeSize != static_cast<ssize_t>(text.size()) and errno != EBUSY )
+                {
+                    cache.exported[word] &= ~bit;
+                    isSuccess = false;
+                    continue;
+                }
+
+                // a new gpioN directory has no direction of this process
+                cache.directionSet[word] &= ~bit;
+            }
+
+            isListed[word]          |= bit;
+            cache.exported[word]    |= bit;
+
+            if( directions != NULL and ! BlackCoreGPIO::writeDirection(number, directions[i]) )
+            {
+                isSuccess = false;
+            }
+        }
+
+        if( exportFd >= 0 )
+        {
+            ::close(exportFd);
+        }
+
+        return isSuccess;
+    }
+
+    bool        BlackCoreGPIO::unexportPins(const gpioName *pins, unsigned int count)
+    {
+        pinStateCache &cache    = BlackCoreGPIO::stateCache();
+        std::string classPath   = BlackCore::getFilesystemRoot() + "/sys/class/gpio";
+        uint32_t isListed[4];
+
+        if( ! BlackCoreGPIO::listExportedPins(isListed) )
+        {
+            return false;
+        }
+
+        bool isSuccess  = true;
+        int unexportFd  = -1;
+
+        for( unsigned int i = 0 ; i < count ; i++ )
+        {
+            unsigned int number = static_cast<unsigned int>(pins[i]);
+            unsigned int word   = (number / 32) % 4;
+            uint32_t bit        = (1u << (number % 32));
+
+            cache.exported[word]        &= ~bit;
+            cache.directionSet[word]    &= ~bit;
+
+            if( (isListed[word] & bit) == 0 )
+            {
+                continue;
+            }
+
+            if( unexportFd < 0 )
+            {
+                unexportFd = ::open((classPath + "/unexport").c_str(), O_WRONLY);
+            }
+
+            std::string text    = tostr(static_cast<int>(number)) + "\n";
+            ssize_t writeSize   = (unexportFd < 0) ? -1 : ::write(unexportFd, text.c_str(), text.size());
+            isListed[word]     &= ~bit;
+
+            if( writeSize != static_cast<ssize_t>(text.size()) )
+            {
+                isSuccess = false;
+            }
+        }
+
+        if( unexportFd >= 0 )
+        {
+            ::close(unexportFd);
+        }
+
+        return isSuccess;
+    }
+
+    bool        BlackCoreGPIO::doExport()
+    {
+        pinStateCache &cache    = BlackCoreGPIO::stateCache();
+        unsigned int pinNumber  = static_cast<unsigned int>(this->pinName);
+
+        if( (cache.exported[(pinNumber / 32) % 4] & (1u << (pinNumber % 32))) or ::access(this->gpioPath.c_str(), F_OK) == 0 )
+        {
+            this->gpioCoreErrors->exportFileError = false;
+            return true;
+        }
+
+        std::string exportPath = BlackCore::getFilesystemRoot() + "/sys/class/gpio/export";
+        int exportFd = ::open(exportPath.c_str(), O_WRONLY);
+        if( exportFd < 0 )
+        {
+            this->gpioCoreErrors->exportFileError = true;
+            return false;
+        }
+
+        std::string number = tostr(static_cast<int>(this->pinName)) + "\n";
+        ssize_t writeSize  = ::write(exportFd, number.c_str(), number.size());
+        ::close(exportFd);
+
+        this->gpioCoreErrors->exportFileError = ( writeSize != static_cast<ssize_t>(number.size()) or
+                                                  ::access(this->gpioPath.c_str(), F_OK) != 0 );
+        if( ! this->gpioCoreErrors->exportFileError )
+        {
+            cache.exported[(pinNumber / 32) % 4] |= (1u << (pinNumber % 32));
+        }
+        return ( ! this->gpioCoreErrors->exportFileError );
+    }
+
+    bool        BlackCoreGPIO::setDirection()
+    {
+        this->gpioCoreErrors->directionFileError = ! BlackCoreGPIO::writeDirection(static_cast<unsigned int>(this->pinName), this->pinDirection);
+        return ( ! this->gpioCoreErrors->directionFileError );
+    }
+
+    std::string BlackCoreGPIO::getValueFilePath()
+    {
+        return (this->gpioPath + "/value");
+    }
+
+    std::string BlackCoreGPIO::getDirectionFilePath()
+    {
+        return (this->gpioPath + "/direction");
+    }
+
+    errorCoreGPIO *BlackCoreGPIO::getErrorsFromCoreGPIO()
+    {
+        return (this->gpioCoreErrors);
+    }
+
+    gpioBackend BlackCoreGPIO::getLayout()
+    {
+        return this->gpioLayout;
+    }
+    // ########################################### BLACKCOREGPIO DEFINITION ENDS ########################################## //
+
+
+
+
+
+    // ########################################### BLACKGPIOCHIP DEFINITION STARTS ######################################## //
+    int         BlackGPIOChipDevice::openChip(const std::string &path)
+    {
+        return ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    }
+
+    int         BlackGPIOChipDevice::lineIoctl(int fd, unsigned long request, void *argument)
+    {
+        return ::ioctl(fd, request, argument);
+    }
+
+    BlackGPIOChipDevice *&BlackGPIOChipDevice::installedDevice()
+    {
+        static BlackGPIOChipDevice *device = NULL;
+        return device;
+    }
+
+    void        BlackGPIOChipDevice::setDevice(BlackGPIOChipDevice *device)
+    {
+        BlackGPIOChipDevice::installedDevice() = device;
+    }
+
+    BlackGPIOChipDevice &BlackGPIOChipDevice::getDevice()
+    {
+        static BlackGPIOChipDevice defaultDevice;
+        BlackGPIOChipDevice *device = BlackGPIOChipDevice::installedDevice();
+        return (device == NULL) ? defaultDevice : *device;
+    }
+
+
+
+
+    BlackGPIOChipLines::BlackGPIOChipLines(unsigned int chip, const unsigned int *offsets, unsigned int count,
+                                           direction pinDirect, edgeType edge, unsigned int debouncePeriod)
+    {
+        this->lineFd        = -1;
+        this->chipNumber    = chip;
+        this->lineCount     = (count > GPIO_V2_LINES_MAX) ? GPIO_V2_LINES_MAX : count;
+        this->allLinesMask  = (this->lineCount == 64) ? ~0ULL : ((1ULL << this->lineCount) - 1);
+
+        if( pinDirect == output )
+        {
+            this->lineFlags = GPIO_V2_LINE_FLAG_OUTPUT;
+        }
+        else
+        {
+            this->lineFlags = GPIO_V2_LINE_FLAG_INPUT;
+            this->lineFlags |= (edge & risingEdge)  ? GPIO_V2_LINE_FLAG_EDGE_RISING  : 0;
+            this->lineFlags |= (edge & fallingEdge) ? GPIO_V2_LINE_FLAG_EDGE_FALLING : 0;
+        }
+
+        gpio_v2_line_request request;
+        memset(&request, 0, sizeof(request));
+
+        for( unsigned int i = 0 ; i < this->lineCount ; i++ )
+        {
+            this->lineOffsets[i]    = offsets[i];
+            request.offsets[i]      = offsets[i];
+        }
+        request.num_lines = this->lineCount;
+        strncpy(request.consumer, "BlackLib", GPIO_MAX_NAME_SIZE - 1);
+        this->fillConfig(request.config, (pinDirect == input) ? debouncePeriod : 0);
+
+        BlackGPIOChipDevice &device = BlackGPIOChipDevice::getDevice();
+        int chipFd = device.openChip( BlackCore::getFilesystemRoot() + "/dev/gpiochip" + tostr(static_cast<int>(chip)) );
+        if( chipFd < 0 )
+        {
+            return;
+        }
+
+        if( this->lineCount > 0 and device.lineIoctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &request) == 0 and request.fd >= 0 )
+        {
+            this->lineFd = request.fd;
+
+            // events are read without waiting, the descriptor is polled for waiting
+            ::fcntl(this->lineFd, F_SETFL, ::fcntl(this->lineFd, F_GETFL) | O_NONBLOCK);
+        }
+
+        // line request stays valid after the chip is closed
+        ::close(chipFd);
+    }
+
+    BlackGPIOChipLines::~BlackGPIOChipLines()
+    {
+        if( this->lineFd >= 0 )
+        {
+            ::close(this->lineFd);
+        }
+    }
+
+    void        BlackGPIOChipLines::fillConfig(gpio_v2_line_config &config, unsigned int debouncePeriod)
+    {
+        memset(&config, 0, sizeof(config));
+        config.flags = this->lineFlags;
+
+        if( debouncePeriod > 0 )
+        {
+            config.num_attrs                        = 1;
+            config.attrs[0].attr.id                 = GPIO_V2_LINE_ATTR_ID_DEBOUNCE;
+            config.attrs[0].attr.debounce_period_us = debouncePeriod;
+            config.attrs[0].mask                    = this->allLinesMask;
+        }
+    }
+
+    bool        BlackGPIOChipLines::isRequested()
+    {
+        return ( this->lineFd >= 0 );
+    }
+
+    unsigned int BlackGPIOChipLines::getLineCount()
+    {
+        return this->lineCount;
+    }
+
+    int         BlackGPIOChipLines::getFd()
+    {
+        return this->lineFd;
+    }
+
+    bool        BlackGPIOChipLines::getValues(uint64_t &bits, uint64_t mask)
+    {
+        gpio_v2_line_values values;
+        values.bits = 0;
+        values.mask = mask & this->allLinesMask;
+
+        if( this->lineFd < 0 or BlackGPIOChipDevice::getDevice().lineIoctl(this->lineFd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) != 0 )
+        {
+            return false;
+        }
+
+        bits = values.bits & values.mask;
+        return true;
+    }
+
+    bool        BlackGPIOChipLines::setValues(uint64_t bits, uint64_t mask)
+    {
+        gpio_v2_line_values values;
+        values.bits = bits;
+        values.mask = mask & this->allLinesMask;
+
+        return ( this->lineFd >= 0 and BlackGPIOChipDevice::getDevice().lineIoctl(this->lineFd, GPIO_V2_LINE_SET_VALUES_IOCTL, &values) == 0 );
+    }
+
+    bool        BlackGPIOChipLines::setDebounce(unsigned int debouncePeriod)
+    {
+        if( this->lineFd < 0 or (this->lineFlags & GPIO_V2_LINE_FLAG_INPUT) == 0 )
+        {
+            return false;
+        }
+
+        gpio_v2_line_config config;
+        this->fillConfig(config, debouncePeriod);
+
+        return ( BlackGPIOChipDevice::getDevice().lineIoctl(this->lineFd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) == 0 );
+    }
+
+    int         BlackGPIOChipLines::readEvents(gpioEvent *events, unsigned int maxCount)
+    {
+        if( this->lineFd < 0 )
+        {
+            return -1;
+        }
+
+        gpio_v2_line_event records[16];
+        unsigned int recordCount = (maxCount > 16) ? 16 : maxCount;
+
+        ssize_t readSize = ::read(this->lineFd, records, recordCount * sizeof(gpio_v2_line_event));
+        if( readSize < 0 )
+        {
+            return (errno == EAGAIN) ? 0 : -1;
+        }
+
+        int eventCount = static_cast<int>(readSize / sizeof(gpio_v2_line_event));
+        for( int i = 0 ; i < eventCount ; i++ )
+        {
+            events[i].id        = this->chipNumber * 32 + records[i].offset;
+            events[i].value     = (records[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE) ? 1 : 0;
+            events[i].timestamp = records[i].timestamp_ns;
+        }
+
+        return eventCount;
+    }
+    // ############################################ BLACKGPIOCHIP DEFINITION ENDS ######################################### //
+
+
+
+
+
+    // ########################################## BLACKGPIOBACKEND DEFINITION STARTS ##################################### //
+    BlackGPIOSysfsBackend::BlackGPIOSysfsBackend(const std::string &valuePath, const std::string &directionPath, direction pinDirect)
+    {
+        // input pins are opened read only, sysfs value file of input pin rejects writing anyway
+        this->valueFd       = ::open(valuePath.c_str(), (pinDirect == output) ? O_RDWR : O_RDONLY);
+        this->directionFd   = ::open(directionPath.c_str(), O_RDONLY);
+    }
+
+    BlackGPIOSysfsBackend::~BlackGPIOSysfsBackend()
+    {
+        if( this->valueFd >= 0 )
+        {
+            ::close(this->valueFd);
+        }
+
+        if( this->directionFd >= 0 )
+        {
+            ::close(this->directionFd);
+        }
+    }
+
+    bool        BlackGPIOSysfsBackend::readValue(int &value)
+    {
+        char readChar;
+        if( this->valueFd < 0 or ::pread(this->valueFd, &readChar, 1, 0) != 1 )
+        {
+            return false;
+        }
+
+        value = (readChar == '0') ? 0 : 1;
+        return true;
+    }
+
+    bool        BlackGPIOSysfsBackend::writeValue(digitalValue value)
+    {
+        const char *text = (value == high) ? "1\n" : "0\n";
+        return ( this->valueFd >= 0 and ::pwrite(this->valueFd, text, 2, 0) == 2 );
+    }
+
+    bool        BlackGPIOSysfsBackend::isExported()
+    {
+        char readChar;
+        return ( this->valueFd >= 0 and ::pread(this->valueFd, &readChar, 1, 0) == 1 );
+    }
+
+    bool        BlackGPIOSysfsBackend::isDirectionSet(direction pinDirect)
+    {
+        char buffer[4];
+        ssize_t readSize = (this->directionFd < 0) ? -1 : ::pread(this->directionFd, buffer, sizeof(buffer), 0);
+
+        bool isOutput = ( readSize >= 3 and strncmp(buffer, "out", 3) == 0 );
+        bool isInput  = ( readSize >= 2 and strncmp(buffer, "in", 2) == 0 );
+
+        return ( (pinDirect == output) ? isOutput : isInput );
+    }
+
+    gpioBackend BlackGPIOSysfsBackend::getType()
+    {
+        return gpioSysfsBackend;
+    }
+
+
+
+
+    BlackGPIORegisterBackend::BlackGPIORegisterBackend(gpioName pin, direction pinDirect)
+    {
+        unsigned int number = static_cast<unsigned int>(pin);
+
+        this->pinMask       = (1u << (number % 32));
+        this->region        = new BlackMemoryRegion(gpioBankAddressMap[number / 32], 0x1000);
+        this->setRegister   = NULL;
+        this->clearRegister = NULL;
+        this->readRegister  = NULL;
+
+        if( ! this->region->isMapped() )
+        {
+            return;
+        }
+
+        this->setRegister   = this->region->register32(gpioSetDataOut);
+        this->clearRegister = this->region->register32(gpioClearDataOut);
+        this->readRegister  = this->region->register32( (pinDirect == output) ? gpioDataOut : gpioDataIn );
+
+        volatile uint32_t *oe = this->region->register32(gpioOe);
+        if( pinDirect == output )
+        {
+            *oe = *oe & ~(this->pinMask);
+        }
+        else
+        {
+            *oe = *oe | this->pinMask;
+        }
+    }
+
+    BlackGPIORegisterBackend::~BlackGPIORegisterBackend()
+    {
+        delete this->region;
+    }
+
+    bool        BlackGPIORegisterBackend::readValue(int &value)
+    {
+        if( this->readRegister == NULL )
+        {
+            return false;
+        }
+
+        value = ((*this->readRegister & this->pinMask) != 0) ? 1 : 0;
+        return true;
+    }
+
+    bool        BlackGPIORegisterBackend::writeValue(digitalValue value)
+    {
+        if( this->setRegister == NULL )
+        {
+            return false;
+        }
+
+        *( (value == high) ? this->setRegister : this->clearRegister ) = this->pinMask;
+        return true;
+    }
+
+    bool        BlackGPIORegisterBackend::isExported()
+    {
+        return this->region->isMapped();
+    }
+
+    bool        BlackGPIORegisterBackend::isDirectionSet(direction pinDirect)
+    {
+        if( ! this->region->isMapped() )
+        {
+            return false;
+        }
+
+        bool isInput = ( (*this->region->register32(gpioOe) & this->pinMask) != 0 );
+        return ( (pinDirect == input) ? isInput : ! isInput );
+    }
+
+    gpioBackend BlackGPIORegisterBackend::getType()
+    {
+        return gpioRegisterBackend;
+    }
+
+
+
+
+    BlackGPIOChipBackend::BlackGPIOChipBackend(gpioName pin, direction pinDirect)
+    {
+        unsigned int number = static_cast<unsigned int>(pin);
+        unsigned int offset = number % 32;
+
+        this->lines         = new BlackGPIOChipLines(number / 32, &offset, 1, pinDirect);
+        this->lineMask      = 1;
+        this->lineDirection = pinDirect;
+        this->isOwner       = true;
+    }
+
+    BlackGPIOChipBackend::BlackGPIOChipBackend(BlackGPIOChipLines *sharedLines, unsigned int index, direction pinDirect)
+    {
+        this->lines         = sharedLines;
+        this->lineMask      = (1ULL << index);
+        this->lineDirection = pinDirect;
+        this->isOwner       = false;
+    }
+
+    BlackGPIOChipBackend::~BlackGPIOChipBackend()
+    {
+        if( this->isOwner )
+        {
+            delete this->lines;
+        }
+    }
+
+    bool        BlackGPIOChipBackend::readValue(int &value)
+    {
+        uint64_t bits;
+        if( ! this->lines->getValues(bits, this->lineMask) )
+        {
+            return false;
+        }
+
+        value = (bits != 0) ? 1 : 0;
+        return true;
+    }
+
+    bool        BlackGPIOChipBackend::writeValue(digitalValue value)
+    {
+        return this->lines->setValues( (value == high) ? this->lineMask : 0, this->lineMask );
+    }
+
+    bool        BlackGPIOChipBackend::isExported()
+    {
+        return this->lines->isRequested();
+    }
+
+    bool        BlackGPIOChipBackend::isDirectionSet(direction pinDirect)
+    {
+        return ( this->lines->isRequested() and this->lineDirection == pinDirect );
+    }
+
+    gpioBackend BlackGPIOChipBackend::getType()
+    {
+        return gpioChipBackend;
+    }
+    // ########################################### BLACKGPIOBACKEND DEFINITION ENDS ###################################### //
+
+
+
+
+
+    // ############################################ BLACKGPIO DEFINITION STARTS ########################################### //
+    BlackGPIO::BlackGPIO(gpioName pin, direction pinDirect, workingMode runMode, gpioBackend backend)
+        : BlackCoreGPIO(pin, pinDirect, backend)
+    {
+        this->pinName       = pin;
+        this->pinDirection  = pinDirect;
+        this->workMode      = runMode;
+        this->gpioErrors    = new errorGPIO( this->getErrorsFromCoreGPIO() );
+
+        this->valuePath     = this->getValueFilePath();
+        this->directionPath = this->getDirectionFilePath();
+
+        if( this->getLayout() == gpioRegisterBackend )
+        {
+            this->backend   = new BlackGPIORegisterBackend(pin, pinDirect);
+        }
+        else if( this->getLayout() == gpioChipBackend )
+        {
+            this->backend   = new BlackGPIOChipBackend(pin, pinDirect);
+        }
+        else
+        {
+            this->backend   = new BlackGPIOSysfsBackend(this->valuePath, this->directionPath, pinDirect);
+        }
+    }
+
+    BlackGPIO::BlackGPIO(gpioName pin, direction pinDirect, workingMode runMode, BlackGPIOBackend *customBackend)
+        : BlackCoreGPIO(pin, pinDirect, customBackend->getType())
+    {
+        this->pinName       = pin;
+        this->pinDirection  = pinDirect;
+        this->workMode      = runMode;
+        this->gpioErrors    = new errorGPIO( this->getErrorsFromCoreGPIO() );
+
+        this->valuePath     = this->getValueFilePath();
+        this->directionPath = this->getDirectionFilePath();
+        this->backend       = customBackend;
+    }
+
+    BlackGPIO::~BlackGPIO()
+    {
+        delete this->backend;
+        delete this->gpioErrors;
+    }
+
+    bool        BlackGPIO::readValue(int &value)
+    {
+        this->gpioErrors->readError = ! this->backend->readValue(value);
+        return ( ! this->gpioErrors->readError );
+    }
+
+    bool        BlackGPIO::writeValue(digitalValue value)
+    {
+        this->gpioErrors->writeError = ! this->backend->writeValue(value);
+        return ( ! this->gpioErrors->writeError );
+    }
+
+    std::string BlackGPIO::getValue()
+    {
+        int value = this->getNumericValue();
+
+        if( value == GPIO_PIN_NOT_READY_INT )
+        {
+            return GPIO_PIN_NOT_READY_STRING;
+        }
+
+        if( value == FILE_COULD_NOT_OPEN_INT )
+        {
+            return FILE_COULD_NOT_OPEN_STRING;
+        }
+
+        return ( (value == 1) ? "1" : "0" );
+    }
+
+    int         BlackGPIO::getNumericValue()
+    {
+        if( this->workMode == secureMode and ! this->isReady() )
+        {
+            return GPIO_PIN_NOT_READY_INT;
+        }
+
+        int value;
+        if( ! this->readValue(value) )
+        {
+            return FILE_COULD_NOT_OPEN_INT;
+        }
+
+        return value;
+    }
+
+    gpioName    BlackGPIO::getName()
+    {
+        return this->pinName;
+    }
+
+    direction   BlackGPIO::getDirection()
+    {
+        return this->pinDirection;
+    }
+
+    gpioBackend BlackGPIO::getBackend()
+    {
+        return this->backend->getType();
+    }
+
+    bool        BlackGPIO::setValue(digitalValue status)
+    {
+        if( this->pinDirection == input )
+        {
+            this->gpioErrors->forcingError = true;
+            return false;
+        }
+
+        this->gpioErrors->forcingError = false;
+
+        if( this->workMode == secureMode and ! this->isReady() )
+        {
+            return false;
+        }
+
+        return this->writeValue(status);
+    }
+
+    bool        BlackGPIO::isHigh()
+    {
+        return ( this->getNumericValue() == 1 );
+    }
+
+    void        BlackGPIO::toggleValue()
+    {
+        int value = this->getNumericValue();
+
+        if( value == 0 or value == 1 )
+        {
+            this->setValue( (value == 0) ? high : low );
+        }
+    }
+
+    bool        BlackGPIO::isExported()
+    {
+        this->gpioErrors->exportError = ! this->backend->isExported();
+        return ( ! this->gpioErrors->exportError );
+    }
+
+    bool        BlackGPIO::isDirectionSet()
+    {
+        this->gpioErrors->directionError = ! this->backend->isDirectionSet(this->pinDirection);
+        return ( ! this->gpioErrors->directionError );
+    }
+
+    bool        BlackGPIO::isReady()
+    {
+        return ( this->isExported() and this->isDirectionSet() );
+    }
+
+    bool        BlackGPIO::fail()
+    {
+        return (this->gpioErrors->exportError or
+                this->gpioErrors->directionError or
+                this->gpioErrors->readError or
+                this->gpioErrors->writeError or
+                this->gpioErrors->forcingError or
+                this->gpioErrors->gpioCoreErrors->exportFileError or
+                this->gpioErrors->gpioCoreErrors->directionFileError
+                );
+    }
+
+    bool        BlackGPIO::fail(BlackGPIO::flags f)
+    {
+        if(f==exportErr)        { return this->gpioErrors->exportError;                         }
+        if(f==directionErr)     { return this->gpioErrors->directionError;                      }
+        if(f==readErr)          { return this->gpioErrors->readError;                           }
+        if(f==writeErr)         { return this->gpioErrors->writeError;                          }
+        if(f==forcingErr)       { return this->gpioErrors->forcingError;                        }
+        if(f==exportFileErr)    { return this->gpioErrors->gpioCoreErrors->exportFileError;     }
+        if(f==directionFileErr) { return this->gpioErrors->gpioCoreErrors->directionFileError;  }
+
+        return true;
+    }
+
+    BlackGPIO   &BlackGPIO::operator>>(std::string &readToThis)
+    {
+        readToThis = this->getValue();
+        return *this;
+    }
+
+    BlackGPIO   &BlackGPIO::operator>>(int &readToThis)
+    {
+        readToThis = this->getNumericValue();
+        return *this;
+    }
+
+    BlackGPIO   &BlackGPIO::operator<<(digitalValue value)
+    {
+        this->setValue(value);
+        return *this;
+    }
+    // ############################################# BLACKGPIO DEFINITION ENDS ############################################ //
+
+
+
+
+
+    // ########################################### BLACKGPIOPORT DEFINITION STARTS ######################################### //
+    BlackGPIOPort::BlackGPIOPort(const gpioName *pins, unsigned int count, direction pinDirect, gpioBackend backend)
+    {
+        this->memberCount       = (count > 32) ? 32 : count;
+        this->memberBitsMask    = (this->memberCount == 32) ? 0xFFFFFFFF : ((1u << this->memberCount) - 1);
+        this->portDirection     = pinDirect;
+        this->portBackend       = BlackCoreGPIO::selectBackend(backend);
+        this->portError         = false;
+        this->isSameCycleWrite  = false;
+
+        for( unsigned int bank = 0 ; bank < 4 ; bank++ )
+        {
+            this->bankMask[bank]    = 0;
+            this->banks[bank]       = NULL;
+            this->chipLines[bank]   = NULL;
+        }
+
+        unsigned int bankOffsets[4][32];
+        unsigned int bankLineCount[4] = { 0, 0, 0, 0 };
+
+        for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+        {
+            unsigned int number     = static_cast<unsigned int>(pins[i]);
+
+            this->memberBank[i]     = number / 32;
+            this->memberPinMask[i]  = (1u << (number % 32));
+            this->bankMask[number / 32] |= this->memberPinMask[i];
+
+            this->memberLine[i]     = bankLineCount[number / 32]++;
+            bankOffsets[number / 32][ this->memberLine[i] ] = number % 32;
+        }
+
+        if( this->portBackend == gpioChipBackend )
+        {
+            for( unsigned int bank = 0 ; bank < 4 ; bank++ )
+            {
+                if( bankLineCount[bank] > 0 )
+                {
+                    this->chipLines[bank] = new BlackGPIOChipLines(bank, bankOffsets[bank], bankLineCount[bank], pinDirect);
+                }
+            }
+        }
+
+        for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+        {
+            if( this->portBackend == gpioChipBackend )
+            {
+                BlackGPIOChipBackend *lineBackend = new BlackGPIOChipBackend(this->chipLines[ this->memberBank[i] ], this->memberLine[i], pinDirect);
+                this->members[i]    = new BlackGPIO(pins[i], pinDirect, fastMode, lineBackend);
+            }
+            else
+            {
+                this->members[i]    = new BlackGPIO(pins[i], pinDirect, fastMode, this->portBackend);
+            }
+        }
+
+        if( backend == gpioRegisterBackend )
+        {
+            for( unsigned int bank = 0 ; bank < 4 ; bank++ )
+            {
+                if( this->bankMask[bank] != 0 )
+                {
+                    this->banks[bank] = new BlackMemoryRegion(gpioBankAddressMap[bank], 0x1000);
+                }
+            }
+        }
+    }
+
+    BlackGPIOPort::~BlackGPIOPort()
+    {
+        for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+        {
+            delete this->members[i];
+        }
+
+        for( unsigned int bank = 0 ; bank < 4 ; bank++ )
+        {
+            delete this->banks[bank];
+            delete this->chipLines[bank];
+        }
+    }
+
+    bool        BlackGPIOPort::applyBits(uint32_t setBits, uint32_t clearBits)
+    {
+        if( this->portDirection != output )
+        {
+            this->portError = true;
+            return false;
+        }
+
+        setBits   &= this->memberBitsMask;
+        clearBits &= this->memberBitsMask & ~setBits;
+
+        if( this->portBackend == gpioChipBackend )
+        {
+            uint64_t lineBits[4] = { 0, 0, 0, 0 };
+            uint64_t lineMask[4] = { 0, 0, 0, 0 };
+
+            for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+            {
+                if( (setBits | clearBits) & (1u << i) )
+                {
+                    lineMask[ this->memberBank[i] ] |= (1ULL << this->memberLine[i]);
+                    lineBits[ this->memberBank[i] ] |= (setBits & (1u << i)) ? (1ULL << this->memberLine[i]) : 0;
+                }
+            }
+
+            bool isSuccess = true;
+            for( unsigned int bank = 0 ; bank < 4 ; bank++ )
+            {
+                if( lineMask[bank] != 0 )
+                {
+                    isSuccess &= this->chipLines[bank]->setValues(lineBits[bank], lineMask[bank]);
+                }
+            }
+
+            this->portError = ! isSuccess;
+            return isSuccess;
+        }
+
+        if( this->portBackend != gpioRegisterBackend )
+        {
+            bool isSuccess = true;
+            for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+            {
+                if( (setBits | clearBits) & (1u << i) )
+                {
+                    isSuccess &= this->members[i]->setValue( (setBits & (1u << i)) ? high : low );
+                }
+            }
+
+            this->portError = ! isSuccess;
+            return isSuccess;
+        }
+
+        uint32_t setMasks[4]    = { 0, 0, 0, 0 };
+        uint32_t clearMasks[4]  = { 0, 0, 0, 0 };
+
+        for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+        {
+            if( setBits & (1u << i) )
+            {
+                setMasks[ this->memberBank[i] ]   |= this->memberPinMask[i];
+            }
+            else if( clearBits & (1u << i) )
+            {
+                clearMasks[ this->memberBank[i] ] |= this->memberPinMask[i];
+            }
+        }
+
+        bool isSuccess = true;
+        for( unsigned int bank = 0 ; bank < 4 ; bank++ )
+        {
+            if( (setMasks[bank] | clearMasks[bank]) == 0 )
+            {
+                continue;
+            }
+
+            if( this->banks[bank] == NULL or ! this->banks[bank]->isMapped() )
+            {
+                isSuccess = false;
+                continue;
+            }
+
+            if( this->isSameCycleWrite and setMasks[bank] != 0 and clearMasks[bank] != 0 )
+            {
+                // opt-in: one store switches all changed members together, but it isn't atomic
+                volatile uint32_t *dataOut = this->banks[bank]->register32(gpioDataOut);
+                *dataOut = (*dataOut & ~(setMasks[bank] | clearMasks[bank])) | setMasks[bank];
+                continue;
+            }
+
+            if( setMasks[bank] != 0 )
+            {
+                *(this->banks[bank]->register32(gpioSetDataOut))    = setMasks[bank];
+            }
+            if( clearMasks[bank] != 0 )
+            {
+                *(this->banks[bank]->register32(gpioClearDataOut))  = clearMasks[bank];
+            }
+        }
+
+        this->portError = ! isSuccess;
+        return isSuccess;
+    }
+
+    void        BlackGPIOPort::setSameCycleWrite(bool isEnabled)
+    {
+        this->isSameCycleWrite = isEnabled;
+    }
+
+    unsigned int BlackGPIOPort::getPinCount()
+    {
+        return this->memberCount;
+    }
+
+    BlackGPIO   &BlackGPIOPort::getPin(unsigned int index)
+    {
+        return *(this->members[index]);
+    }
+
+    bool        BlackGPIOPort::setValues(uint32_t states)
+    {
+        return this->applyBits(states, ~states);
+    }
+
+    bool        BlackGPIOPort::setBits(uint32_t bits)
+    {
+        return this->applyBits(bits, 0);
+    }
+
+    bool        BlackGPIOPort::clearBits(uint32_t bits)
+    {
+        return this->applyBits(0, bits);
+    }
+
+    uint32_t    BlackGPIOPort::getValues()
+    {
+        uint32_t states = 0;
+
+        if( this->portBackend == gpioChipBackend )
+        {
+            bool isSuccess = true;
+            uint64_t lineBits[4] = { 0, 0, 0, 0 };
+
+            for( unsigned int bank = 0 ; bank < 4 ; bank++ )
+            {
+                if( this->chipLines[bank] != NULL )
+                {
+                    isSuccess &= this->chipLines[bank]->getValues(lineBits[bank]);
+                }
+            }
+
+            for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+            {
+                if( lineBits[ this->memberBank[i] ] & (1ULL << this->memberLine[i]) )
+                {
+                    states |= (1u << i);
+                }
+            }
+
+            this->portError = ! isSuccess;
+            return states;
+        }
+
+        if( this->portBackend != gpioRegisterBackend )
+        {
+            bool isSuccess = true;
+            for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+            {
+                int value = this->members[i]->getNumericValue();
+                isSuccess &= ( value >= 0 );
+
+                if( value == 1 )
+                {
+                    states |= (1u << i);
+                }
+            }
+
+            this->portError = ! isSuccess;
+            return states;
+        }
+
+        uint32_t bankValues[4]  = { 0, 0, 0, 0 };
+        uint32_t readOffset     = (this->portDirection == output) ? gpioDataOut : gpioDataIn;
+        bool isSuccess          = true;
+
+        for( unsigned int bank = 0 ; bank < 4 ; bank++ )
+        {
+            if( this->bankMask[bank] == 0 )
+            {
+                continue;
+            }
+
+            if( this->banks[bank] == NULL or ! this->banks[bank]->isMapped() )
+            {
+                isSuccess = false;
+                continue;
+            }
+
+            bankValues[bank] = *(this->banks[bank]->register32(readOffset));
+        }
+
+        for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+        {
+            if( bankValues[ this->memberBank[i] ] & this->memberPinMask[i] )
+            {
+                states |= (1u << i);
+            }
+        }
+
+        this->portError = ! isSuccess;
+        return states;
+    }
+
+    bool        BlackGPIOPort::fail()
+    {
+        bool isFailed = this->portError;
+        for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+        {
+            isFailed |= this->members[i]->fail();
+        }
+
+        return isFailed;
+    }
+    // ############################################ BLACKGPIOPORT DEFINITION ENDS ########################################## //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKGPIO_H_ */
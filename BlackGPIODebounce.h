@@ -0,0 +1,451 @@
+
+#ifndef BLACKGPIODEBOUNCE_H_
+#define BLACKGPIODEBOUNCE_H_
+
+#include "BlackGPIO.h"
+
+#include <vector>
+#include <stdint.h>
+
+namespace BlackLib
+{
+
+    /*!
+    * Number of bit planes of debounce counters, so the longest stable time is 2^16 - 1 ticks.
+    */
+    const unsigned int      DEBOUNCE_COUNTER_BITS       = 16;
+
+
+
+    // ###################################### BLACKGPIODEBOUNCER DECLARATION STARTS ####################################### //
+
+    /*! @brief Debounces many gpio inputs together, 64 inputs per machine word.
+     *
+     *    Every input is a lane: lane i is bit (i % 64) of word (i / 64). States of all lanes are held in
+     *    structure of arrays form: debounced levels, and debounce counters which are sliced into
+     *    DEBOUNCE_COUNTER_BITS bit planes (plane j holds bit j of the counters of all lanes). Stable
+     *    times of the lanes are sliced in the same way, so every lane can have its own stable time.
+     *
+     *    At every sample tick, update() counts the ticks which the raw sample differs from the
+     *    debounced level, with a bit sliced increment, and clears the counters of the lanes whose sample
+     *    equals to the debounced level. A lane changes when its counter reaches its stable time. All of
+     *    these are bitwise operations on whole words; loops walk over words at the inner level, so the
+     *    compiler can use vector instructions when there are several words. A tick at which all of the
+     *    samples equal to the debounced levels skips the counter planes.
+     *
+     *    Samples can be given directly, or read from BlackGPIOPort objects with sample(). Only clean
+     *    transitions are reported, as rising and falling masks and as gpioEvent records.
+     *
+     * @par Example
+     * @code{.cpp}
+     *   BlackLib::gpioName keys[4] = { BlackLib::GPIO_44, BlackLib::GPIO_45, BlackLib::GPIO_46, BlackLib::GPIO_47 };
+     *   BlackLib::BlackGPIOPort       keypad(keys, 4, BlackLib::input, BlackLib::gpioRegisterBackend);
+     *   BlackLib::BlackGPIODebouncer  debouncer(4);
+     *
+     *   debouncer.addPort(keypad);
+     *   debouncer.setStableTimes(50);                  // 5 ms at 10 kHz tick
+     *   debouncer.setStableTime(3, 200);               // slow limit switch, 20 ms
+     *
+     *   BlackLib::gpioEvent events[8];
+     *   while( true )                                   // every 100 us
+     *   {
+     *       if( debouncer.sample() > 0 )
+     *       {
+     *           unsigned int count = debouncer.getTransitions(events, 8, now());
+     *           ...
+     *       }
+     *   }
+     * @endcode
+     */
+    class BlackGPIODebouncer
+    {
+        private:
+            unsigned int                laneCount;          /*!< @brief is used to hold number of inputs */
+            unsigned int                wordCount;          /*!< @brief is used to hold number of 64 lane words */
+            uint64_t                    lastWordMask;       /*!< @brief is used to hold valid lanes of the last word */
+            std::vector<uint64_t>       levels;             /*!< @brief is used to hold debounced levels */
+            std::vector<uint64_t>       risingEdges;        /*!< @brief is used to hold lanes which rose at the last tick */
+            std::vector<uint64_t>       fallingEdges;       /*!< @brief is used to hold lanes which fell at the last tick */
+            std::vector<uint64_t>       counters;           /*!< @brief is used to hold counter planes, plane j of word w is at [j * wordCount + w] */
+            std::vector<uint64_t>       stableTimes;        /*!< @brief is used to hold stable time planes, same layout as counters */
+            std::vector<uint64_t>       carries;            /*!< @brief is used to hold increment carries while updating */
+            std::vector<uint64_t>       matches;            /*!< @brief is used to hold counter/stable time equality while updating */
+            std::vector<uint64_t>       samples;            /*!< @brief is used to hold samples which are read by sample() */
+            std::vector<unsigned int>   laneIds;            /*!< @brief is used to hold gpioEvent::id of each lane */
+            std::vector<BlackGPIOPort *> ports;             /*!< @brief is used to hold ports which are read by sample() */
+            std::vector<unsigned int>   portLanes;          /*!< @brief is used to hold first lane of each port */
+            bool                        isCounting;         /*!< @brief is used to hold whether any counter can be non zero */
+
+            /*! @brief Writes the bits of a value to a lane of sliced planes.
+            *
+            *  @param [in,out] planes   sliced planes
+            *  @param [in] lane         lane number
+            *  @param [in] value        new value of the lane
+            */
+            void                        writeLane(std::vector<uint64_t> &planes, unsigned int lane, unsigned int value);
+
+        public:
+            /*! @brief Constructor of BlackGPIODebouncer class.
+            *
+            *  This function allocates all of the state; no memory is allocated at sample ticks. Every
+            *  lane starts at low level with stable time 1 tick, and its id is its lane number.
+            *  @param [in] inputCount   number of inputs
+            */
+                                        BlackGPIODebouncer(unsigned int inputCount);
+
+            /*! @brief Destructor of BlackGPIODebouncer class.
+            */
+            virtual                     ~BlackGPIODebouncer();
+
+            /*! @brief Sets stable time of one input.
+            *
+            *  @param [in] input        lane number
+            *  @param [in] ticks        number of successive ticks which a new level must be kept (1 - 65535)
+            *  @return True if setting is successful, else false.
+            */
+            bool                        setStableTime(unsigned int input, unsigned int ticks);
+
+            /*! @brief Sets stable time of all inputs.
+            *
+            *  @param [in] ticks        number of successive ticks which a new level must be kept (1 - 65535)
+            *  @return True if setting is successful, else false.
+            */
+            bool                        setStableTimes(unsigned int ticks);
+
+            /*! @brief Sets id of an input, which is reported at gpioEvent::id.
+            *
+            *  @param [in] input        lane number
+            *  @param [in] id           new id
+            */
+            void                        setInputId(unsigned int input, unsigned int id);
+
+            /*! @brief Adds a port, which will be read at each sample().
+            *
+            *  Members of the port take the next free lanes, and their ids are their gpio numbers. The
+            *  port must live longer than the debouncer.
+            *  @param [in] port         input port
+            *  @return First lane of the port, or -1 if there aren't enough free lanes.
+            */
+            int                         addPort(BlackGPIOPort &port);
+
+            /*! @brief Sets debounced levels without reporting transitions, and clears the counters.
+            *
+            *  @param [in] newLevels    packed levels, one word per 64 lanes, bits above input count are ignored
+            */
+            void                        reset(const uint64_t *newLevels);
+
+            /*! @brief Processes one sample tick.
+            *
+            *  @param [in] newSamples   packed raw levels, one word per 64 lanes, bits above input count are ignored
+            *  @return Number of clean transitions at this tick.
+            */
+            unsigned int                update(const uint64_t *newSamples);
+
+            /*! @brief Reads all of the added ports and processes one sample tick.
+            *
+            *  @return Number of clean transitions at this tick.
+            */
+            unsigned int                sample();
+
+            /*! @brief Exports debounced levels.
+            *
+            *  @return Packed levels, one word per 64 lanes.
+            */
+            const uint64_t              *getLevels();
+
+            /*! @brief Exports lanes which rose at the last tick.
+            *
+            *  @return Packed masks, one word per 64 lanes.
+            */
+            const uint64_t              *getRisingEdges();
+
+            /*! @brief Exports lanes which fell at the last tick.
+            *
+            *  @return Packed masks, one word per 64 lanes.
+            */
+            const uint64_t              *getFallingEdges();
+
+            /*! @brief Exports transitions of the last tick as events.
+            *
+            *  @param [out] events      event array
+            *  @param [in] maxCount     size of @a events array
+            *  @param [in] timestamp    timestamp of the tick, which is copied to all of the events
+            *  @return Number of written events.
+            */
+            unsigned int                getTransitions(gpioEvent *events, unsigned int maxCount, uint64_t timestamp);
+
+            /*! @brief Exports number of inputs.
+            *
+            *  @return Number of inputs.
+            */
+            unsigned int                getInputCount();
+    };
+    // ####################################### BLACKGPIODEBOUNCER DECLARATION ENDS ######################################## //
+
+
+
+
+
+    // ####################################### BLACKGPIODEBOUNCER DEFINITION STARTS ####################################### //
+    BlackGPIODebouncer::BlackGPIODebouncer(unsigned int inputCount)
+    {
+        this->laneCount = inputCount;
+        this->wordCount = (inputCount + 63) / 64;
+        this->lastWordMask = (inputCount % 64 == 0) ? ~0ULL : ((1ULL << (inputCount % 64)) - 1);
+
+        this->levels.assign(this->wordCount, 0);
+        this->risingEdges.assign(this->wordCount, 0);
+        this->fallingEdges.assign(this->wordCount, 0);
+        this->carries.assign(this->wordCount, 0);
+        this->matches.assign(this->wordCount, 0);
+        this->samples.assign(this->wordCount, 0);
+        this->counters.assign(DEBOUNCE_COUNTER_BITS * this->wordCount, 0);
+        this->stableTimes.assign(DEBOUNCE_COUNTER_BITS * this->wordCount, 0);
+        this->laneIds.resize(inputCount);
+        this->isCounting = false;
+
+        for( unsigned int lane = 0 ; lane < inputCount ; lane++ )
+        {
+            this->laneIds[lane] = lane;
+        }
+
+        this->setStableTimes(1);
+    }
+
+    BlackGPIODebouncer::~BlackGPIODebouncer()
+    {
+    }
+
+    void        BlackGPIODebouncer::writeLane(std::vector<uint64_t> &planes, unsigned int lane, unsigned int value)
+    {
+        uint64_t laneMask = (1ULL << (lane % 64));
+
+        for( unsigned int plane = 0 ; plane < DEBOUNCE_COUNTER_BITS ; plane++ )
+        {
+            uint64_t &word = planes[plane * this->wordCount + lane / 64];
+            word = ( (value >> plane) & 1 ) ? (word | laneMask) : (word & ~laneMask);
+        }
+    }
+
+    bool        BlackGPIODebouncer::setStableTime(unsigned int input, unsigned int ticks)
+    {
+        if( input >= this->laneCount or ticks == 0 or ticks >= (1u << DEBOUNCE_COUNTER_BITS) )
+        {
+            return false;
+        }
+
+        this->writeLane(this->stableTimes, input, ticks);
+        this->writeLane(this->counters, input, 0);
+        return true;
+    }
+
+    bool        BlackGPIODebouncer::setStableTimes(unsigned int ticks)
+    {
+        if( ticks == 0 or ticks >= (1u << DEBOUNCE_COUNTER_BITS) )
+        {
+            return false;
+        }
+
+        for( unsigned int plane = 0 ; plane < DEBOUNCE_COUNTER_BITS ; plane++ )
+        {
+            for( unsigned int word = 0 ; word < this->wordCount ; word++ )
+            {
+                this->stableTimes[plane * this->wordCount + word] = ( (ticks >> plane) & 1 ) ? ~0ULL : 0;
+                this->counters[plane * this->wordCount + word]    = 0;
+            }
+        }
+
+        return true;
+    }
+
+    void        BlackGPIODebouncer::setInputId(unsigned int input, unsigned int id)
+    {
+        if( input < this->laneCount )
+        {
+            this->laneIds[input] = id;
+        }
+    }
+
+    int         BlackGPIODebouncer::addPort(BlackGPIOPort &port)
+    {
+        unsigned int firstLane = this->ports.empty() ? 0 : this->portLanes.back() + this->ports.back()->getPinCount();
+        if( firstLane + port.getPinCount() > this->laneCount )
+        {
+            return -1;
+        }
+
+        for( unsigned int i = 0 ; i < port.getPinCount() ; i++ )
+        {
+            this->laneIds[firstLane + i] = static_cast<unsigned int>( port.getPin(i).getName() );
+        }
+
+        this->ports.push_back(&port);
+        this->portLanes.push_back(firstLane);
+        return static_cast<int>(firstLane);
+    }
+
+    void        BlackGPIODebouncer::reset(const uint64_t *newLevels)
+    {
+        for( unsigned int word = 0 ; word < this->wordCount ; word++ )
+        {
+            this->levels[word]          = newLevels[word] & ( (word + 1 == this->wordCount) ? this->lastWordMask : ~0ULL );
+            this->risingEdges[word]     = 0;
+            this->fallingEdges[word]    = 0;
+        }
+
+        for( unsigned int i = 0 ; i < this->counters.size() ; i++ )
+        {
+            this->counters[i] = 0;
+        }
+
+        this->isCounting = false;
+    }
+
+    unsigned int BlackGPIODebouncer::update(const uint64_t *newSamples)
+    {
+        const unsigned int words = this->wordCount;
+        uint64_t *counter   = &(this->counters[0]);
+        uint64_t *stable    = &(this->stableTimes[0]);
+        uint64_t *carry     = &(this->carries[0]);
+        uint64_t *match     = &(this->matches[0]);
+
+        // lanes which differ from debounced level are counted, the others restart from zero. Lanes above
+        // input count never get a carry or a match, so their counters stay zero and they never flip.
+        uint64_t anyDiffers = 0;
+        for( unsigned int word = 0 ; word < words ; word++ )
+        {
+            uint64_t validLanes = (word + 1 == words) ? this->lastWordMask : ~0ULL;
+
+            carry[word] = (newSamples[word] ^ this->levels[word]) & validLanes;
+            match[word] = validLanes;
+            anyDiffers |= carry[word];
+
+            this->risingEdges[word]     = 0;
+            this->fallingEdges[word]    = 0;
+        }
+
+        // stable inputs: counters are cleared once, then nothing is done until a sample differs
+        if( anyDiffers == 0 )
+        {
+            if( this->isCounting )
+            {
+                for( unsigned int i = 0 ; i < DEBOUNCE_COUNTER_BITS * words ; i++ )
+                {
+                    counter[i] = 0;
+                }
+                this->isCounting = false;
+            }
+            return 0;
+        }
+
+        this->isCounting = true;
+
+        for( unsigned int plane = 0 ; plane < DEBOUNCE_COUNTER_BITS ; plane++ )
+        {
+            uint64_t *counterPlane  = counter + plane * words;
+            uint64_t *stablePlane   = stable  + plane * words;
+
+            for( unsigned int word = 0 ; word < words ; word++ )
+            {
+                uint64_t differs    = newSamples[word] ^ this->levels[word];
+                uint64_t sum        = (counterPlane[word] ^ carry[word]) & differs;
+
+                carry[word]         = counterPlane[word] & carry[word];
+                counterPlane[word]  = sum;
+                match[word]        &= ~(sum ^ stablePlane[word]);
+            }
+        }
+
+        unsigned int transitionCount = 0;
+
+        for( unsigned int word = 0 ; word < words ; word++ )
+        {
+            uint64_t flips              = match[word] & (newSamples[word] ^ this->levels[word]);
+
+            this->levels[word]         ^= flips;
+            this->risingEdges[word]     = flips & this->levels[word];
+            this->fallingEdges[word]    = flips & ~(this->levels[word]);
+            transitionCount            += static_cast<unsigned int>( __builtin_popcountll(flips) );
+
+            // flipped lanes start counting again from their new level
+            if( flips != 0 )
+            {
+                for( unsigned int plane = 0 ; plane < DEBOUNCE_COUNTER_BITS ; plane++ )
+                {
+                    counter[plane * words + word] &= ~flips;
+                }
+            }
+        }
+
+        return transitionCount;
+    }
+
+    unsigned int BlackGPIODebouncer::sample()
+    {
+        for( unsigned int i = 0 ; i < this->ports.size() ; i++ )
+        {
+            uint64_t     values = this->ports[i]->getValues();
+            unsigned int lane   = this->portLanes[i];
+            unsigned int word   = lane / 64;
+            unsigned int shift  = lane % 64;
+            uint64_t     mask   = ( this->ports[i]->getPinCount() >= 32 ) ? 0xFFFFFFFFULL : ((1ULL << this->ports[i]->getPinCount()) - 1);
+
+            this->samples[word] = (this->samples[word] & ~(mask << shift)) | (values << shift);
+
+            // port can cross a word border
+            if( shift > 32 and word + 1 < this->wordCount )
+            {
+                this->samples[word + 1] = (this->samples[word + 1] & ~(mask >> (64 - shift))) | (values >> (64 - shift));
+            }
+        }
+
+        return this->update( &(this->samples[0]) );
+    }
+
+    const uint64_t *BlackGPIODebouncer::getLevels()
+    {
+        return &(this->levels[0]);
+    }
+
+    const uint64_t *BlackGPIODebouncer::getRisingEdges()
+    {
+        return &(this->risingEdges[0]);
+    }
+
+    const uint64_t *BlackGPIODebouncer::getFallingEdges()
+    {
+        return &(this->fallingEdges[0]);
+    }
+
+    unsigned int BlackGPIODebouncer::getTransitions(gpioEvent *events, unsigned int maxCount, uint64_t timestamp)
+    {
+        unsigned int eventCount = 0;
+
+        for( unsigned int word = 0 ; word < this->wordCount ; word++ )
+        {
+            uint64_t flips = this->risingEdges[word] | this->fallingEdges[word];
+
+            while( flips != 0 and eventCount < maxCount )
+            {
+                unsigned int bit    = static_cast<unsigned int>( __builtin_ctzll(flips) );
+                flips              &= flips - 1;
+
+                events[eventCount].id        = this->laneIds[word * 64 + bit];
+                events[eventCount].value     = ( (this->levels[word] >> bit) & 1 ) ? 1 : 0;
+                events[eventCount].timestamp = timestamp;
+                eventCount++;
+            }
+        }
+
+        return eventCount;
+    }
+
+    unsigned int BlackGPIODebouncer::getInputCount()
+    {
+        return this->laneCount;
+    }
+    // ######################################## BLACKGPIODEBOUNCER DEFINITION ENDS ######################################## //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKGPIODEBOUNCE_H_ */
@@ -0,0 +1,330 @@
+#ifndef BLACKGPIOENCODER_H_
+#define BLACKGPIOENCODER_H_
+
+#include "BlackGPIOEvent.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <time.h>           // need for clock_gettime() function
+
+namespace BlackLib
+{
+
+    /*!
+    * This table is used for decoding quadrature transitions at 4x resolution. Index is
+    * <b> (old state << 2) | new state </b>, and a state is <b> (A << 1) | B </b>. Values are count
+    * changes; 0 means no change (same state) or illegal transition (both channels changed).
+    */
+    constexpr int quadratureTable[16] = {    0, -1, +1,  0,
+                                            +1,  0,  0, -1,
+                                            -1,  0,  0, +1,
+                                             0, +1, -1,  0 };
+
+    static_assert( quadratureTable[(0 << 2) | 2] == +1 and quadratureTable[(2 << 2) | 3] == +1 and
+                   quadratureTable[(3 << 2) | 1] == +1 and quadratureTable[(1 << 2) | 0] == +1,     "quadrature table is broken" );
+    static_assert( quadratureTable[(2 << 2) | 0] == -1 and quadratureTable[(0 << 2) | 1] == -1,     "quadrature table is broken" );
+    static_assert( quadratureTable[(0 << 2) | 3] == 0 and quadratureTable[(1 << 2) | 2] == 0,       "quadrature table is broken" );
+
+
+
+    // ######################################## BLACKGPIOENCODER DECLARATION STARTS ####################################### //
+
+    /*! @brief Decodes a quadrature encoder which is connected to two gpio inputs.
+     *
+     *    Both channels are added to a BlackGPIOEventEngine with both edges, as one pin group (see
+     *    BlackGPIOEventEngine::addPinGroup()). Decoding needs the edges in occurrence order: at gpiochip,
+     *    channels of the same bank come from one line request, and edges of channels at different banks
+     *    are merged by kernel timestamp at every wake up. At sysfs, all edges of a wake up get the same
+     *    timestamp and can't be ordered, so the encoder isn't added and fail() returns true.
+     *
+     *    Every edge updates the 2 bit state of the encoder. Count change of the edge is taken from
+     *    quadratureTable, so every edge of both channels is counted (4x decoding). An edge which
+     *    doesn't change its channel (a lost edge pair) or a transition which changes both channels is
+     *    counted as error.
+     *
+     *    Only the thread which dispatches the engine writes the counters, so position is updated with
+     *    a relaxed atomic store, without read-modify-write and without locks. Position, velocity and
+     *    error count can be read from any thread.
+     *
+     *    Velocity is calculated from edge timestamps: when a count comes at least velocity window time
+     *    after the start of the current measurement, velocity is <b> counts / elapsed time </b>, and a
+     *    new measurement starts. Kernel timestamps of the edges are used, so the velocity
+     *    doesn't depend on dispatch latency. Velocity reads as zero when no count comes for two
+     *    windows (or two count intervals, whichever is longer).
+     *
+     *    The engine must be stopped before the encoder is destroyed, because the encoder removes its
+     *    pins from the engine at its destructor.
+     *
+     * @par Example
+     * @code{.cpp}
+     *   BlackLib::BlackGPIOEventEngine engine;
+     *   BlackLib::BlackGPIOEncoder     wheel(engine, BlackLib::GPIO_44, BlackLib::GPIO_45);
+     *   engine.start(90);
+     *
+     *   int64_t counts  = wheel.getPosition();                 // from any thread
+     *   double  speed   = wheel.getVelocity() / 2048.0;        // turn/s with a 512 line encoder
+     *   engine.stop();
+     * @endcode
+     */
+    class BlackGPIOEncoder
+    {
+        private:
+            BlackGPIOEventEngine        *engine;            /*!< @brief is used to hold the engine of the channels */
+            unsigned int                idA;                /*!< @brief is used to hold gpio number of channel A */
+            unsigned int                idB;                /*!< @brief is used to hold gpio number of channel B */
+            bool                        isReady;            /*!< @brief is used to hold adding result of the channels */
+            unsigned int                state;              /*!< @brief is used to hold current state, (A << 1) | B */
+            unsigned int                knownChannels;      /*!< @brief is used to hold channels whose level is known, same bits with state */
+            uint64_t                    velocityWindow;     /*!< @brief is used to hold minimum velocity measurement time */
+            uint64_t                    velocityStart;      /*!< @brief is used to hold timestamp of measurement start */
+            int64_t                     velocityStartCount; /*!< @brief is used to hold position at measurement start */
+            uint64_t                    lastCountTime;      /*!< @brief is used to hold timestamp of last count */
+
+            std::atomic<int64_t>        position;           /*!< @brief is used to hold raw position */
+            std::atomic<int64_t>        zeroPosition;       /*!< @brief is used to hold raw position of last resetPosition() */
+            std::atomic<uint64_t>       errors;             /*!< @brief is used to hold number of illegal transitions */
+            std::atomic<uint64_t>       edges;              /*!< @brief is used to hold number of handled edges */
+            std::atomic<double>         velocity;           /*!< @brief is used to hold last velocity, counts per second */
+            std::atomic<uint64_t>       lastCountEdge;      /*!< @brief is used to hold lastCountTime for readers */
+            std::atomic<uint64_t>       countInterval;      /*!< @brief is used to hold time between last two counts */
+
+            /*! @brief Copying is not allowed, because the engine holds pointer of the object.
+            */
+                                        BlackGPIOEncoder(const BlackGPIOEncoder &);
+
+            /*! @brief Copying is not allowed, because the engine holds pointer of the object.
+            */
+            BlackGPIOEncoder            &operator=(const BlackGPIOEncoder &);
+
+            /*! @brief Engine callback of the channels.
+            *
+            *  @param [in] event        edge
+            *  @param [in] userData     encoder object
+            */
+            static void                 eventCallback(const gpioEvent &event, void *userData);
+
+        public:
+            /*! @brief Constructor of BlackGPIOEncoder class.
+            *
+            *  This function adds both channels to the engine. Initial state is taken from the first
+            *  edge of each channel, so the first edges are not counted.
+            *  @param [in] eventEngine    engine which dispatches edges of the channels
+            *  @param [in] pinA           gpio pin name of channel A (enum)
+            *  @param [in] pinB           gpio pin name of channel B (enum)
+            *  @param [in] debouncePeriod hardware debounce period at microsecond level, it is used only at gpiochip
+            *  @param [in] window         velocity window at nanosecond level, default value is 10 milliseconds
+            */
+                                        BlackGPIOEncoder(BlackGPIOEventEngine &eventEngine, gpioName pinA, gpioName pinB,
+                                                         unsigned int debouncePeriod = 0, uint64_t window = 10000000);
+
+            /*! @brief Destructor of BlackGPIOEncoder class.
+            *
+            *  This function removes the channels from the engine.
+            */
+            virtual                     ~BlackGPIOEncoder();
+
+            /*! @brief Decodes an edge.
+            *
+            *  Engine calls this function for every edge of the channels. It can be used for edges which
+            *  aren't dispatched by the engine (like edges of a capture buffer), from the thread which
+            *  dispatches the engine, or while the engine isn't running.
+            *  @param [in] event        edge of channel A or B
+            *  @return True if the edge belongs to this encoder, else false.
+            */
+            bool                        handleEvent(const gpioEvent &event);
+
+            /*! @brief Exports position.
+            *
+            *  This function is lock free.
+            *  @return Counts since construction or last resetPosition(), 4 counts per encoder line.
+            */
+            int64_t                     getPosition();
+
+            /*! @brief Sets current position as zero.
+            */
+            void                        resetPosition();
+
+            /*! @brief Exports velocity.
+            *
+            *  This function is lock free.
+            *  @return Counts per second, negative at reverse direction.
+            */
+            double                      getVelocity();
+
+            /*! @brief Exports number of illegal transitions.
+            *
+            *  @return Number of edges which didn't change their channel, and transitions which changed both channels.
+            */
+            uint64_t                    getErrorCount();
+
+            /*! @brief Exports number of handled edges.
+            *
+            *  @return Number of edges.
+            */
+            uint64_t                    getEdgeCount();
+
+            /*! @brief Is used for general debugging.
+            *
+            *  @return True if gpiochip backend isn't available or any channel couldn't be added to the engine, else false.
+            */
+            bool                        fail();
+    };
+    // ######################################### BLACKGPIOENCODER DECLARATION ENDS ######################################## //
+
+
+
+
+
+    // ######################################### BLACKGPIOENCODER DEFINITION STARTS ####################################### //
+    BlackGPIOEncoder::BlackGPIOEncoder(BlackGPIOEventEngine &eventEngine, gpioName pinA, gpioName pinB,
+                                       unsigned int debouncePeriod, uint64_t window)
+    {
+        this->engine                = &eventEngine;
+        this->idA                   = static_cast<unsigned int>(pinA);
+        this->idB                   = static_cast<unsigned int>(pinB);
+        this->state                 = 0;
+        this->knownChannels         = 0;
+        this->velocityWindow        = (window == 0) ? 1 : window;
+        this->velocityStart         = 0;
+        this->velocityStartCount    = 0;
+        this->lastCountTime         = 0;
+
+        this->position              = 0;
+        this->zeroPosition          = 0;
+        this->errors                = 0;
+        this->edges                 = 0;
+        this->velocity              = 0.0;
+        this->lastCountEdge         = 0;
+        this->countInterval         = 0;
+
+        // sysfs can't order edges of both channels which come at the same wake up
+        if( BlackCoreGPIO::selectBackend(gpioAutoBackend) != gpioChipBackend )
+        {
+            this->isReady = false;
+            return;
+        }
+
+        const gpioName channels[2] = { pinA, pinB };
+        this->isReady = this->engine->addPinGroup(channels, 2, bothEdges, &BlackGPIOEncoder::eventCallback, this, debouncePeriod);
+    }
+
+    BlackGPIOEncoder::~BlackGPIOEncoder()
+    {
+        // channel B is a separate source only if it isn't at the request of channel A
+        this->engine->remove(this->idA);
+        this->engine->remove(this->idB);
+    }
+
+    void        BlackGPIOEncoder::eventCallback(const gpioEvent &event, void *userData)
+    {
+        static_cast<BlackGPIOEncoder *>(userData)->handleEvent(event);
+    }
+
+    bool        BlackGPIOEncoder::handleEvent(const gpioEvent &event)
+    {
+        unsigned int channelBit;
+        if( event.id == this->idA )
+        {
+            channelBit = 2;
+        }
+        else if( event.id == this->idB )
+        {
+            channelBit = 1;
+        }
+        else
+        {
+            return false;
+        }
+
+        unsigned int newState   = (event.value != 0) ? (this->state | channelBit) : (this->state & ~channelBit);
+        uint64_t edgeCount      = this->edges.load(std::memory_order_relaxed) + 1;
+        this->edges.store(edgeCount, std::memory_order_relaxed);
+
+        // until both channels have an edge, edges only set the state
+        if( this->knownChannels != 3 )
+        {
+            this->knownChannels |= channelBit;
+            this->state         = newState;
+            this->velocityStart = event.timestamp;
+            return true;
+        }
+
+        int change = quadratureTable[(this->state << 2) | newState];
+        if( change == 0 )
+        {
+            this->errors.store( this->errors.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed );
+            this->state = newState;
+            return true;
+        }
+
+        this->state = newState;
+
+        int64_t count = this->position.load(std::memory_order_relaxed) + change;
+        this->position.store(count, std::memory_order_relaxed);
+
+        if( this->lastCountTime != 0 )
+        {
+            this->countInterval.store(event.timestamp - this->lastCountTime, std::memory_order_relaxed);
+        }
+        this->lastCountTime = event.timestamp;
+        this->lastCountEdge.store(event.timestamp, std::memory_order_relaxed);
+
+        if( event.timestamp - this->velocityStart >= this->velocityWindow )
+        {
+            double elapsed = static_cast<double>(event.timestamp - this->velocityStart);
+            this->velocity.store( (count - this->velocityStartCount) * 1e9 / elapsed, std::memory_order_relaxed );
+
+            this->velocityStart         = event.timestamp;
+            this->velocityStartCount    = count;
+        }
+
+        return true;
+    }
+
+    int64_t     BlackGPIOEncoder::getPosition()
+    {
+        return this->position.load(std::memory_order_relaxed) - this->zeroPosition.load(std::memory_order_relaxed);
+    }
+
+    void        BlackGPIOEncoder::resetPosition()
+    {
+        this->zeroPosition.store( this->position.load(std::memory_order_relaxed), std::memory_order_relaxed );
+    }
+
+    double      BlackGPIOEncoder::getVelocity()
+    {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        uint64_t nowTime    = static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+        uint64_t lastCount  = this->lastCountEdge.load(std::memory_order_relaxed);
+        uint64_t interval   = this->countInterval.load(std::memory_order_relaxed);
+        uint64_t timeout    = 2 * ( (interval > this->velocityWindow) ? interval : this->velocityWindow );
+
+        // no count for a long time, the shaft is stopped
+        if( nowTime > lastCount and nowTime - lastCount > timeout )
+        {
+            return 0.0;
+        }
+
+        return this->velocity.load(std::memory_order_relaxed);
+    }
+
+    uint64_t    BlackGPIOEncoder::getErrorCount()
+    {
+        return this->errors.load(std::memory_order_relaxed);
+    }
+
+    uint64_t    BlackGPIOEncoder::getEdgeCount()
+    {
+        return this->edges.load(std::memory_order_relaxed);
+    }
+
+    bool        BlackGPIOEncoder::fail()
+    {
+        return ( ! this->isReady );
+    }
+    // ########################################## BLACKGPIOENCODER DEFINITION ENDS ######################################## //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKGPIOENCODER_H_ */
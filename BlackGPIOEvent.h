@@ -0,0 +1,1020 @@
+
+#ifndef BLACKGPIOEVENT_H_
+#define BLACKGPIOEVENT_H_
+
+#include "BlackGPIO.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+#include <time.h>           // need for clock_gettime() function
+#include <pthread.h>        // need for event thread
+#include <sys/epoll.h>      // need for epoll_create1(), epoll_ctl() and epoll_wait() functions
+#include <sys/eventfd.h>    // need for stopping event thread
+#include <sched.h>          // need for SCHED_FIFO scheduling policy
+
+namespace BlackLib
+{
+
+    /*!
+    * This type is used for event callbacks. Callbacks are called from the thread which dispatches
+    * events, so they must not block for long time. The event queue isn't locked while a callback
+    * runs, so getEvent() can be called from it.
+    */
+    typedef void (*gpioEventCallback)(const gpioEvent &event, void *userData);
+
+
+
+    // ##################################### BLACKGPIOCAPTUREBUFFER DECLARATION STARTS #################################### //
+
+    /*! @brief Holds read position and lost record count of one BlackGPIOCaptureBuffer consumer.
+     */
+    struct captureCursor
+    {
+        uint64_t    position;               /*!< @brief index of the next record which will be read */
+        uint64_t    overruns;               /*!< @brief number of records which were overwritten before this consumer read them */
+    };
+
+    /*! @brief Lock free single producer/multi consumer ring buffer of timestamped gpio edges.
+     *
+     *    All of the slots are allocated at construction; push() and pop() never allocate and never
+     *    block. The producer never waits for consumers: when the ring is full, the oldest records are
+     *    overwritten. Every consumer has its own captureCursor, so every consumer sees every record,
+     *    and it detects the records which were overwritten before it read them as overruns.
+     *
+     *    Each slot is guarded with a sequence number (seqlock), so a consumer never returns a record
+     *    which is being overwritten.
+     *
+     * @par Example
+     * @code{.cpp}
+     *   BlackLib::BlackGPIOCaptureBuffer capture(8192);
+     *   BlackLib::BlackGPIOEventEngine   engine;
+     *   engine.addPin(BlackLib::GPIO_48, BlackLib::bothEdges);
+     *   engine.setCaptureBuffer(&capture);
+     *   engine.start(80);                                  // SCHED_FIFO priority 80
+     *
+     *   BlackLib::captureCursor cursor = capture.getCursor();
+     *   BlackLib::gpioEvent     edge;
+     *   while( capture.pop(cursor, edge) )
+     *   {
+     *       std::cout << edge.timestamp << ": gpio" << edge.id << " = " << edge.value << std::endl;
+     *   }
+     *   std::cout << "Lost edges: " << cursor.overruns << std::endl;
+     * @endcode
+     */
+    class BlackGPIOCaptureBuffer
+    {
+        private:
+            /*! @brief Holds one record. Fields are atomic, so readers and the writer can touch it together.
+             */
+            struct captureSlot
+            {
+                std::atomic<uint64_t>   sequence;       /*!< @brief 2 x index + 1 while writing, 2 x index + 2 after writing */
+                std::atomic<uint64_t>   header;         /*!< @brief gpioEvent::id << 1 | gpioEvent::value */
+                std::atomic<uint64_t>   timestamp;      /*!< @brief gpioEvent::timestamp */
+            };
+
+            captureSlot             *slots;             /*!< @brief is used to hold the preallocated slots */
+            uint64_t                indexMask;          /*!< @brief is used to hold slot count - 1, slot count is power of two */
+            std::atomic<uint64_t>   writeIndex;         /*!< @brief is used to hold number of pushed records */
+
+            /*! @brief Copying is not allowed, because the object owns the slots.
+            */
+                                    BlackGPIOCaptureBuffer(const BlackGPIOCaptureBuffer &);
+
+            /*! @brief Copying is not allowed, because the object owns the slots.
+            */
+            BlackGPIOCaptureBuffer  &operator=(const BlackGPIOCaptureBuffer &);
+
+        public:
+            /*! @brief Constructor of BlackGPIOCaptureBuffer class.
+            *
+            * This function allocates the slots. No memory is allocated after construction.
+            * @param [in] capacity   minimum number of records, it is rounded up to power of two
+            */
+                                    BlackGPIOCaptureBuffer(size_t capacity);
+
+            /*! @brief Destructor of BlackGPIOCaptureBuffer class.
+            */
+            virtual                 ~BlackGPIOCaptureBuffer();
+
+            /*! @brief Adds a record to the ring, overwriting the oldest one if the ring is full.
+            *
+            * This function is lock free. It must be called from one producer thread only.
+            * @param [in] event      new record
+            */
+            void                    push(const gpioEvent &event);
+
+            /*! @brief Creates a consumer cursor which starts at the next pushed record.
+            *
+            * @return New cursor.
+            */
+            captureCursor           getCursor();
+
+            /*! @brief Takes the next record of a consumer.
+            *
+            * This function is lock free. Each cursor must be used from one thread only; any number of
+            * cursors can be used together. Skipped records are added to captureCursor::overruns.
+            * @param [in,out] cursor consumer cursor
+            * @param [out] event     taken record
+            * @return True if a record is taken, false if the consumer reached the producer.
+            */
+            bool                    pop(captureCursor &cursor, gpioEvent &event);
+
+            /*! @brief Exports slot count.
+            *
+            * @return Number of slots.
+            */
+            size_t                  getCapacity();
+
+            /*! @brief Exports number of pushed records since construction.
+            *
+            * @return Number of pushed records.
+            */
+            uint64_t                getWriteCount();
+    };
+    // ###################################### BLACKGPIOCAPTUREBUFFER DECLARATION ENDS ##################################### //
+
+
+
+
+
+    // ###################################### BLACKGPIOEVENTENGINE DECLARATION STARTS ##################################### //
+
+    /*! @brief Waits edge events of many gpio inputs in one epoll set.
+     *
+     *    At sysfs, every added pin is exported as input, its @b edge file is set, and its @b value file
+     *    is opened once and registered to one epoll set (sysfs reports edges as POLLPRI). A wake up
+     *    returns all of the ready sources together; value of each ready source is read only once per
+     *    wake up, and all of the events of the wake up get the same timestamp.
+     *
+     *    When gpiochip backend is selected (see BlackCoreGPIO::selectBackend()), every added pin is
+     *    requested as an edge detecting line instead, and its line request descriptor is registered.
+     *    The kernel queues every edge with its interrupt timestamp; a wake up reads all of the queued
+     *    edges of a line with batched reads, so no edge is lost between wake ups. When line requests of
+     *    different banks are ready at the same wake up, their edges are merged by kernel timestamp before
+     *    they are dispatched, so edges of a wake up are always dispatched in occurrence order.
+     *
+     *    Sources which have a callback are dispatched to it; the others are queued and can be taken
+     *    with getEvent(). Events are dispatched by processEvents(), which can be called from user loop,
+     *    or from the engine thread which is started with start().
+     *
+     *    With setCaptureBuffer(), events of the sources which have no callback are written to a
+     *    preallocated BlackGPIOCaptureBuffer instead of the queue, without locks and allocations. At
+     *    sysfs, the timestamp is taken just after epoll_wait() returns, before any value is read; at
+     *    gpiochip, it is the kernel timestamp of the edge.
+     *
+     *    Besides pins, any readable descriptor (for example a pipe which carries '0'/'1' characters)
+     *    can be added with addDescriptor(). Sources can be added and removed only while the engine
+     *    thread is not running.
+     *
+     * @par Example
+     * @code{.cpp}
+     *   void onButton(const BlackLib::gpioEvent &event, void *userData)
+     *   {
+     *       std::cout << "gpio" << event.id << " -> " << event.value << std::endl;
+     *   }
+     *
+     *   BlackLib::BlackGPIOEventEngine engine;
+     *   engine.addPin(BlackLib::GPIO_48, BlackLib::bothEdges, onButton);
+     *   engine.addPin(BlackLib::GPIO_49, BlackLib::risingEdge);            // queued
+     *   engine.start();
+     *
+     *   BlackLib::gpioEvent event;
+     *   while( engine.getEvent(event) )
+     *   {
+     *       ...
+     *   }
+     *   engine.stop();
+     * @endcode
+     */
+    class BlackGPIOEventEngine
+    {
+        private:
+            /*! @brief Holds one registered event source.
+             */
+            struct eventSource
+            {
+                unsigned int        id;             /*!< @brief is used to hold gpio number or descriptor id */
+                int                 fd;             /*!< @brief is used to hold the watched descriptor */
+                bool                isValueFile;    /*!< @brief is used to hold the read way, pread() at offset 0 for sysfs value files */
+                bool                isOwned;        /*!< @brief is used to hold whether descriptor is closed by the engine */
+                gpioEventCallback   callback;       /*!< @brief is used to hold the callback, NULL means queued */
+                void                *userData;      /*!< @brief is used to hold the callback parameter */
+                BlackGPIO           *pin;           /*!< @brief is used to hold the exported pin, NULL for other sources */
+                BlackGPIOChipLines  *lines;         /*!< @brief is used to hold the requested line, NULL for other sources */
+            };
+
+            /*! @brief Holds one line edge of a wake up until edges of all ready lines are merged.
+             */
+            struct lineRecord
+            {
+                gpioEvent           event;          /*!< @brief is used to hold the edge */
+                eventSource         *source;        /*!< @brief is used to hold source of the edge */
+                unsigned int        order;          /*!< @brief is used to hold read order, it keeps equal timestamps in order */
+            };
+
+            int                         epollFd;            /*!< @brief is used to hold the epoll set */
+            int                         stopFd;             /*!< @brief is used to hold the eventfd which stops the engine thread */
+            std::vector<eventSource *>  sources;            /*!< @brief is used to hold registered sources */
+            std::vector<epoll_event>    readyEvents;        /*!< @brief is used to hold epoll_wait() output */
+            std::vector<lineRecord>     lineRecords;        /*!< @brief is used to hold line edges of a wake up, preallocated */
+            std::deque<gpioEvent>       queue;              /*!< @brief is used to hold events of sources which have no callback */
+            BlackGPIOCaptureBuffer      *captureBuffer;     /*!< @brief is used to hold the capture ring, NULL means events are queued */
+            std::mutex                  queueMutex;         /*!< @brief is used to guard the event queue */
+            size_t                      queueLimit;         /*!< @brief is used to hold maximum number of queued events */
+            std::atomic<uint64_t>       droppedEvents;      /*!< @brief is used to hold number of events dropped at full queue */
+            std::atomic<uint64_t>       wakeUps;            /*!< @brief is used to hold number of wake ups which had events */
+            std::atomic<bool>           isRunning;          /*!< @brief is used to hold the thread state */
+            pthread_t                   eventThread;        /*!< @brief is used to hold the engine thread */
+
+            /*! @brief Copying is not allowed, because the object owns descriptors and the thread.
+            */
+                                        BlackGPIOEventEngine(const BlackGPIOEventEngine &);
+
+            /*! @brief Copying is not allowed, because the object owns descriptors and the thread.
+            */
+            BlackGPIOEventEngine        &operator=(const BlackGPIOEventEngine &);
+
+            /*! @brief Registers a source to epoll set.
+            *
+            * @param [in] source     new source, the engine owns it after this call
+            * @param [in] events     epoll event mask of the source
+            * @return True if registering is successful, else false (source is deleted).
+            */
+            bool                        addSource(eventSource *source, uint32_t events);
+
+            /*! @brief Closes descriptor and deletes pin of a source.
+            */
+            void                        releaseSource(eventSource *source);
+
+            /*! @brief Reads current value of a source.
+            *
+            * @param [in] source     source which is ready
+            * @param [out] value     read value, 0 or 1
+            * @return True if reading is successful, else false.
+            */
+            bool                        readSource(eventSource *source, int &value);
+
+            /*! @brief Gives an event to callback, capture ring or pending events of the wake up.
+            *
+            * Callbacks are called without holding the queue lock.
+            * @param [in] source         source of the event
+            * @param [in] event          event
+            * @param [in,out] pending    pending events of the wake up, which have no callback
+            * @param [in,out] pendingCount number of pending events, they are queued when the array is full
+            */
+            void                        dispatch(eventSource *source, const gpioEvent &event, gpioEvent *pending, unsigned int &pendingCount);
+
+            /*! @brief Compares line edges by kernel timestamp, then by read order.
+            *
+            * @param [in] first      first edge
+            * @param [in] second     second edge
+            * @return True if the first edge occurred before the second one, else false.
+            */
+            static bool                 isEarlierLine(const lineRecord &first, const lineRecord &second);
+
+            /*! @brief Appends pending events of a wake up to the queue.
+            *
+            * The queue is locked only while appending.
+            * @param [in] pending        pending events
+            * @param [in] count          number of pending events
+            */
+            void                        appendQueue(const gpioEvent *pending, unsigned int count);
+
+            /*! @brief Thread function, which calls processEvents() until stop() is called.
+            */
+            static void                 *threadEntry(void *engine);
+
+        public:
+            /*! @brief Constructor of BlackGPIOEventEngine class.
+            *
+            * This function creates the epoll set.
+            * @param [in] maxQueued  maximum number of queued events; when the queue is full, the oldest
+            * event is dropped
+            */
+                                        BlackGPIOEventEngine(size_t maxQueued = 4096);
+
+            /*! @brief Destructor of BlackGPIOEventEngine class.
+            *
+            * This function stops the engine thread, closes all of the descriptors and deletes the pins.
+            */
+            virtual                     ~BlackGPIOEventEngine();
+
+            /*! @brief Adds a gpio input to the engine.
+            *
+            * At sysfs, this function exports the pin as input, writes @a edge to its @b edge file, opens
+            * its @b value file and registers it. Current value is read once, so the first wake up is not
+            * reported as an edge. At gpiochip, it requests the line with @a edge and @a debouncePeriod.
+            * @param [in] pin            gpio pin name (enum)
+            * @param [in] edge           edges which generate events (enum)
+            * @param [in] callback       function which is called for each event, NULL means events are queued
+            * @param [in] userData       parameter of @a callback
+            * @param [in] debouncePeriod hardware debounce period at microsecond level, it is used only at gpiochip
+            * @return True if adding is successful, else false. Adding fails while the thread is running.
+            * @sa edgeType
+            */
+            bool                        addPin(gpioName pin, edgeType edge, gpioEventCallback callback = NULL, void *userData = NULL,
+                                               unsigned int debouncePeriod = 0);
+
+            /*! @brief Adds gpio inputs whose relative edge order is needed (like quadrature channels).
+            *
+            * At gpiochip, pins of each bank are requested together with one line request, so the kernel
+            * queues their edges at one descriptor in occurrence order. Id of a request is the first pin
+            * of its bank at @a pins, and remove() of this id removes all pins of the request. At sysfs,
+            * pins are added one by one with addPin().
+            * @param [in] pins           gpio pin names (enum array)
+            * @param [in] count          size of @a pins array, maximum 32
+            * @param [in] edge           edges which generate events (enum)
+            * @param [in] callback       function which is called for each event, NULL means events are queued
+            * @param [in] userData       parameter of @a callback
+            * @param [in] debouncePeriod hardware debounce period at microsecond level, it is used only at gpiochip
+            * @return True if all of the pins are added, else false.
+            */
+            bool                        addPinGroup(const gpioName *pins, unsigned int count, edgeType edge, gpioEventCallback callback = NULL,
+                                                    void *userData = NULL, unsigned int debouncePeriod = 0);
+
+            /*! @brief Adds a readable descriptor to the engine.
+            *
+            * Every wake up reads the descriptor once; last '0' or '1' character of the read data is the
+            * value of the event. This is used for stand-ins of the value files and for other event sources.
+            * @param [in] fd         readable descriptor, it is not closed by the engine
+            * @param [in] id         id of the source, it is reported in gpioEvent::id
+            * @param [in] callback   function which is called for each event, NULL means events are queued
+            * @param [in] userData   parameter of @a callback
+            * @return True if adding is successful, else false. Adding fails while the thread is running.
+            */
+            bool                        addDescriptor(int fd, unsigned int id, gpioEventCallback callback = NULL, void *userData = NULL);
+
+            /*! @brief Removes a source from the engine.
+            *
+            * @param [in] id         gpio number or descriptor id of the source
+            * @return True if the source is found and removed, else false. Removing fails while the thread is running.
+            */
+            bool                        remove(unsigned int id);
+
+            /*! @brief Waits one wake up and dispatches its events.
+            *
+            * @param [in] timeout    maximum wait time at millisecond level, -1 means infinite
+            * @return Number of dispatched events, 0 at timeout, -1 at error.
+            */
+            int                         processEvents(int timeout);
+
+            /*! @brief Starts the engine thread, which dispatches events until stop() is called.
+            *
+            * @param [in] priority   SCHED_FIFO priority of the thread (1-99), 0 uses normal scheduling
+            * @return True if the thread is started, else false. Real time scheduling needs root or CAP_SYS_NICE.
+            */
+            bool                        start(int priority = 0);
+
+            /*! @brief Stops the engine thread and waits its end.
+            */
+            void                        stop();
+
+            /*! @brief Selects capture ring of the sources which have no callback.
+            *
+            * The ring is not owned by the engine. It can be changed only while the thread is not running.
+            * @param [in] buffer     capture ring, NULL means events are queued
+            * @return True if the ring is selected, else false.
+            */
+            bool                        setCaptureBuffer(BlackGPIOCaptureBuffer *buffer);
+
+            /*! @brief Takes oldest queued event.
+            *
+            * @param [out] event     taken event
+            * @return True if an event is taken, false if the queue is empty.
+            */
+            bool                        getEvent(gpioEvent &event);
+
+            /*! @brief Exports number of registered sources.
+            *
+            * @return Number of sources.
+            */
+            size_t                      getSourceCount();
+
+            /*! @brief Exports number of wake ups which had at least one event.
+            *
+            * @return Number of wake ups.
+            */
+            uint64_t                    getWakeUpCount();
+
+            /*! @brief Exports number of events which are dropped, because the queue was full.
+            *
+            * @return Number of dropped events.
+            */
+            uint64_t                    getDroppedCount();
+    };
+    // ####################################### BLACKGPIOEVENTENGINE DECLARATION ENDS ###################################### //
+
+
+
+
+
+    // ###################################### BLACKGPIOCAPTUREBUFFER DEFINITION STARTS ################################### //
+    BlackGPIOCaptureBuffer::BlackGPIOCaptureBuffer(size_t capacity)
+    {
+        uint64_t slotCount = 1;
+        while( slotCount < capacity )
+        {
+            slotCount <<= 1;
+        }
+
+        this->slots         = new captureSlot[slotCount];
+        this->indexMask     = slotCount - 1;
+        this->writeIndex    = 0;
+
+        for( uint64_t i = 0 ; i < slotCount ; i++ )
+        {
+            this->slots[i].sequence.store(0, std::memory_order_relaxed);
+            this->slots[i].header.store(0, std::memory_order_relaxed);
+            this->slots[i].timestamp.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    BlackGPIOCaptureBuffer::~BlackGPIOCaptureBuffer()
+    {
+        delete[] this->slots;
+    }
+
+    void        BlackGPIOCaptureBuffer::push(const gpioEvent &event)
+    {
+        uint64_t position   = this->writeIndex.load(std::memory_order_relaxed);
+        captureSlot &slot   = this->slots[position & this->indexMask];
+
+        slot.sequence.store(2 * position + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.header.store( (static_cast<uint64_t>(event.id) << 1) | (event.value & 1), std::memory_order_relaxed );
+        slot.timestamp.store( event.timestamp, std::memory_order_relaxed );
+
+        slot.sequence.store(2 * position + 2, std::memory_order_release);
+        this->writeIndex.store(position + 1, std::memory_order_release);
+    }
+
+    captureCursor BlackGPIOCaptureBuffer::getCursor()
+    {
+        captureCursor cursor;
+        cursor.position = this->writeIndex.load(std::memory_order_acquire);
+        cursor.overruns = 0;
+        return cursor;
+    }
+
+    bool        BlackGPIOCaptureBuffer::pop(captureCursor &cursor, gpioEvent &event)
+    {
+        while( true )
+        {
+            uint64_t head = this->writeIndex.load(std::memory_order_acquire);
+            if( cursor.position >= head )
+            {
+                return false;
+            }
+
+            // oldest record which is still in the ring
+            if( head - cursor.position > this->indexMask + 1 )
+            {
+                cursor.overruns += head - cursor.position - (this->indexMask + 1);
+                cursor.position  = head - (this->indexMask + 1);
+            }
+
+            captureSlot &slot       = this->slots[cursor.position & this->indexMask];
+            uint64_t firstSequence  = slot.sequence.load(std::memory_order_acquire);
+            uint64_t header         = slot.header.load(std::memory_order_relaxed);
+            uint64_t timestamp      = slot.timestamp.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t lastSequence   = slot.sequence.load(std::memory_order_relaxed);
+
+            // producer passed the consumer while reading, the record is lost
+            if( firstSequence != 2 * cursor.position + 2 or lastSequence != firstSequence )
+            {
+                cursor.overruns++;
+                cursor.position++;
+                continue;
+            }
+
+            event.id        = static_cast<unsigned int>(header >> 1);
+            event.value     = static_cast<int>(header & 1);
+            event.timestamp = timestamp;
+            cursor.position++;
+            return true;
+        }
+    }
+
+    size_t      BlackGPIOCaptureBuffer::getCapacity()
+    {
+        return static_cast<size_t>(this->indexMask + 1);
+    }
+
+    uint64_t    BlackGPIOCaptureBuffer::getWriteCount()
+    {
+        return this->writeIndex.load(std::memory_order_acquire);
+    }
+    // ####################################### BLACKGPIOCAPTUREBUFFER DEFINITION ENDS #################################### //
+
+
+
+
+
+    // ####################################### BLACKGPIOEVENTENGINE DEFINITION STARTS ##################################### //
+    BlackGPIOEventEngine::BlackGPIOEventEngine(size_t maxQueued)
+    {
+        this->epollFd       = ::epoll_create1(EPOLL_CLOEXEC);
+        this->stopFd        = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        this->queueLimit    = (maxQueued == 0) ? 1 : maxQueued;
+        this->captureBuffer = NULL;
+        this->droppedEvents = 0;
+        this->wakeUps       = 0;
+        this->isRunning     = false;
+
+        if( this->epollFd >= 0 and this->stopFd >= 0 )
+        {
+            // NULL data pointer marks the stop descriptor
+            epoll_event stopEvent;
+            stopEvent.events    = EPOLLIN;
+            stopEvent.data.ptr  = NULL;
+            ::epoll_ctl(this->epollFd, EPOLL_CTL_ADD, this->stopFd, &stopEvent);
+        }
+
+        this->readyEvents.resize(1);
+        this->lineRecords.reserve(256);
+    }
+
+    BlackGPIOEventEngine::~BlackGPIOEventEngine()
+    {
+        this->stop();
+
+        for( size_t i = 0 ; i < this->sources.size() ; i++ )
+        {
+            this->releaseSource(this->sources[i]);
+        }
+
+        if( this->stopFd >= 0 )
+        {
+            ::close(this->stopFd);
+        }
+
+        if( this->epollFd >= 0 )
+        {
+            ::close(this->epollFd);
+        }
+    }
+
+    bool        BlackGPIOEventEngine::addSource(eventSource *source, uint32_t events)
+    {
+        epoll_event sourceEvent;
+        sourceEvent.events      = events;
+        sourceEvent.data.ptr    = source;
+
+        if( this->epollFd < 0 or source->fd < 0 or ::epoll_ctl(this->epollFd, EPOLL_CTL_ADD, source->fd, &sourceEvent) != 0 )
+        {
+            this->releaseSource(source);
+            return false;
+        }
+
+        this->sources.push_back(source);
+        this->readyEvents.resize(this->sources.size() + 1);
+        return true;
+    }
+
+    void        BlackGPIOEventEngine::releaseSource(eventSource *source)
+    {
+        if( source->isOwned and source->fd >= 0 )
+        {
+            ::close(source->fd);
+        }
+
+        delete source->pin;
+        delete source->lines;
+        delete source;
+    }
+
+    bool        BlackGPIOEventEngine::readSource(eventSource *source, int &value)
+    {
+        char buffer[64];
+        ssize_t readSize;
+
+        if( source->isValueFile )
+        {
+            // reading from offset 0 also re-arms POLLPRI of sysfs value file
+            readSize = ::pread(source->fd, buffer, sizeof(buffer), 0);
+        }
+        else
+        {
+            readSize = ::read(source->fd, buffer, sizeof(buffer));
+        }
+
+        for( ssize_t i = readSize - 1 ; i >= 0 ; i-- )
+        {
+            if( buffer[i] == '0' or buffer[i] == '1' )
+            {
+                value = buffer[i] - '0';
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool        BlackGPIOEventEngine::addPin(gpioName pin, edgeType edge, gpioEventCallback callback, void *userData,
+                                         unsigned int debouncePeriod)
+    {
+        if( this->isRunning )
+        {
+            return false;
+        }
+
+        eventSource *source = new eventSource;
+        source->id          = static_cast<unsigned int>(pin);
+        source->isValueFile = true;
+        source->callback    = callback;
+        source->userData    = userData;
+
+        if( BlackCoreGPIO::selectBackend(gpioAutoBackend) == gpioChipBackend )
+        {
+            unsigned int offset = source->id % 32;
+
+            // descriptor is owned by the line request
+            source->isOwned     = false;
+            source->pin         = NULL;
+            source->lines       = new BlackGPIOChipLines(source->id / 32, &offset, 1, input, edge, debouncePeriod);
+            source->fd          = source->lines->getFd();
+            return this->addSource(source, EPOLLIN);
+        }
+
+        source->isOwned     = true;
+        source->lines       = NULL;
+        source->pin         = new BlackGPIO(pin, input, fastMode, gpioSysfsBackend);
+
+        std::string pinPath = BlackCore::getFilesystemRoot() + "/sys/class/gpio/gpio" + tostr(source->id);
+        const char *edgeNames[4] = { "none\n", "rising\n", "falling\n", "both\n" };
+
+        int edgeFd = ::open((pinPath + "/edge").c_str(), O_WRONLY);
+        bool isEdgeSet = ( edgeFd >= 0 and ::write(edgeFd, edgeNames[edge], strlen(edgeNames[edge])) > 0 );
+        if( edgeFd >= 0 )
+        {
+            ::close(edgeFd);
+        }
+
+        source->fd = ::open((pinPath + "/value").c_str(), O_RDONLY | O_CLOEXEC);
+
+        if( ! isEdgeSet )
+        {
+            this->releaseSource(source);
+            return false;
+        }
+
+        int value;
+        this->readSource(source, value);
+        return this->addSource(source, EPOLLPRI | EPOLLERR);
+    }
+
+    bool        BlackGPIOEventEngine::addPinGroup(const gpioName *pins, unsigned int count, edgeType edge, gpioEventCallback callback,
+                                              void *userData, unsigned int debouncePeriod)
+    {
+        if( this->isRunning or count > 32 )
+        {
+            return false;
+        }
+
+        bool isSuccess = true;
+
+        if( BlackCoreGPIO::selectBackend(gpioAutoBackend) != gpioChipBackend )
+        {
+            for( unsigned int i = 0 ; i < count ; i++ )
+            {
+                isSuccess &= this->addPin(pins[i], edge, callback, userData, debouncePeriod);
+            }
+            return isSuccess;
+        }
+
+        for( unsigned int bank = 0 ; bank < 4 ; bank++ )
+        {
+            unsigned int offsets[32];
+            unsigned int lineCount  = 0;
+            unsigned int firstPin   = 0;
+
+            for( unsigned int i = 0 ; i < count ; i++ )
+            {
+                unsigned int number = static_cast<unsigned int>(pins[i]);
+                if( number / 32 == bank )
+                {
+                    firstPin = (lineCount == 0) ? number : firstPin;
+                    offsets[lineCount++] = number % 32;
+                }
+            }
+
+            if( lineCount == 0 )
+            {
+                continue;
+            }
+
+            eventSource *source = new eventSource;
+            source->id          = firstPin;
+            source->isValueFile = true;
+            source->isOwned     = false;
+            source->callback    = callback;
+            source->userData    = userData;
+            source->pin         = NULL;
+            source->lines       = new BlackGPIOChipLines(bank, offsets, lineCount, input, edge, debouncePeriod);
+            source->fd          = source->lines->getFd();
+
+            isSuccess &= this->addSource(source, EPOLLIN);
+        }
+
+        return isSuccess;
+    }
+
+    bool        BlackGPIOEventEngine::addDescriptor(int fd, unsigned int id, gpioEventCallback callback, void *userData)
+    {
+        if( this->isRunning )
+        {
+            return false;
+        }
+
+        eventSource *source = new eventSource;
+        source->id          = id;
+        source->fd          = fd;
+        source->isValueFile = false;
+        source->isOwned     = false;
+        source->callback    = callback;
+        source->userData    = userData;
+        source->pin         = NULL;
+        source->lines       = NULL;
+
+        return this->addSource(source, EPOLLIN);
+    }
+
+    bool        BlackGPIOEventEngine::remove(unsigned int id)
+    {
+        if( this->isRunning )
+        {
+            return false;
+        }
+
+        for( size_t i = 0 ; i < this->sources.size() ; i++ )
+        {
+            if( this->sources[i]->id == id )
+            {
+                ::epoll_ctl(this->epollFd, EPOLL_CTL_DEL, this->sources[i]->fd, NULL);
+                this->releaseSource(this->sources[i]);
+                this->sources.erase(this->sources.begin() + i);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    int         BlackGPIOEventEngine::processEvents(int timeout)
+    {
+        if( this->epollFd < 0 )
+        {
+            return -1;
+        }
+
+        int readyCount = ::epoll_wait(this->epollFd, &(this->readyEvents[0]), static_cast<int>(this->readyEvents.size()), timeout);
+        if( readyCount <= 0 )
+        {
+            return (readyCount < 0 and errno != EINTR) ? -1 : 0;
+        }
+
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        gpioEvent event;
+        event.timestamp     = static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+
+        int dispatched      = 0;
+        gpioEvent pending[64];
+        unsigned int pendingCount = 0;
+        unsigned int readyLines   = 0;
+
+        this->lineRecords.clear();
+
+        for( int i = 0 ; i < readyCount ; i++ )
+        {
+            eventSource *source = static_cast<eventSource *>(this->readyEvents[i].data.ptr);
+            if( source == NULL )
+            {
+                continue;
+            }
+
+            if( source->lines != NULL )
+            {
+                // kernel timestamped edges, read in batches until the line queue is empty
+                gpioEvent lineEvents[16];
+                int eventCount;
+                readyLines++;
+
+                do
+                {
+                    eventCount = source->lines->readEvents(lineEvents, 16);
+                    for( int j = 0 ; j < eventCount ; j++ )
+                    {
+                        lineRecord record;
+                        record.event    = lineEvents[j];
+                        record.source   = source;
+                        record.order    = static_cast<unsigned int>(this->lineRecords.size());
+                        this->lineRecords.push_back(record);
+                    }
+                } while( eventCount == 16 );
+
+                continue;
+            }
+
+            if( ! this->readSource(source, event.value) )
+            {
+                continue;
+            }
+
+            event.id = source->id;
+            this->dispatch(source, event, pending, pendingCount);
+            dispatched++;
+        }
+
+        // edges of one request are already in order, edges of different requests are merged
+        if( readyLines > 1 )
+        {
+            std::sort(this->lineRecords.begin(), this->lineRecords.end(), &BlackGPIOEventEngine::isEarlierLine);
+        }
+
+        for( size_t i = 0 ; i < this->lineRecords.size() ; i++ )
+        {
+            this->dispatch(this->lineRecords[i].source, this->lineRecords[i].event, pending, pendingCount);
+            dispatched++;
+        }
+
+        if( pendingCount > 0 )
+        {
+            this->appendQueue(pending, pendingCount);
+        }
+
+        if( dispatched > 0 )
+        {
+            this->wakeUps++;
+        }
+
+        return dispatched;
+    }
+
+    bool        BlackGPIOEventEngine::isEarlierLine(const lineRecord &first, const lineRecord &second)
+    {
+        if( first.event.timestamp != second.event.timestamp )
+        {
+            return ( first.event.timestamp < second.event.timestamp );
+        }
+        return ( first.order < second.order );
+    }
+
+    void        BlackGPIOEventEngine::dispatch(eventSource *source, const gpioEvent &event, gpioEvent *pending, unsigned int &pendingCount)
+    {
+        if( source->callback != NULL )
+        {
+            source->callback(event, source->userData);
+            return;
+        }
+
+        if( this->captureBuffer != NULL )
+        {
+            this->captureBuffer->push(event);
+            return;
+        }
+
+        // queue is locked once per 64 events, never while reading sources or calling callbacks
+        pending[pendingCount++] = event;
+        if( pendingCount == 64 )
+        {
+            this->appendQueue(pending, pendingCount);
+            pendingCount = 0;
+        }
+    }
+
+    void        BlackGPIOEventEngine::appendQueue(const gpioEvent *pending, unsigned int count)
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+
+        for( unsigned int i = 0 ; i < count ; i++ )
+        {
+            if( this->queue.size() >= this->queueLimit )
+            {
+                this->queue.pop_front();
+                this->droppedEvents++;
+            }
+            this->queue.push_back(pending[i]);
+        }
+    }
+
+    void        *BlackGPIOEventEngine::threadEntry(void *engine)
+    {
+        BlackGPIOEventEngine *self = static_cast<BlackGPIOEventEngine *>(engine);
+
+        while( self->isRunning )
+        {
+            if( self->processEvents(-1) < 0 )
+            {
+                break;
+            }
+        }
+
+        return NULL;
+    }
+
+    bool        BlackGPIOEventEngine::start(int priority)
+    {
+        if( this->isRunning or this->epollFd < 0 or this->stopFd < 0 )
+        {
+            return false;
+        }
+
+        uint64_t counter;
+        while( ::read(this->stopFd, &counter, sizeof(counter)) > 0 ) {}
+
+        pthread_attr_t attributes;
+        pthread_attr_init(&attributes);
+
+        if( priority > 0 )
+        {
+            sched_param parameter;
+            parameter.sched_priority = priority;
+            pthread_attr_setinheritsched(&attributes, PTHREAD_EXPLICIT_SCHED);
+            pthread_attr_setschedpolicy(&attributes, SCHED_FIFO);
+            pthread_attr_setschedparam(&attributes, &parameter);
+        }
+
+        this->isRunning = true;
+        if( pthread_create(&this->eventThread, &attributes, &BlackGPIOEventEngine::threadEntry, this) != 0 )
+        {
+            this->isRunning = false;
+            pthread_attr_destroy(&attributes);
+            return false;
+        }
+
+        pthread_attr_destroy(&attributes);
+        return true;
+    }
+
+    void        BlackGPIOEventEngine::stop()
+    {
+        if( ! this->isRunning )
+        {
+            return;
+        }
+
+        this->isRunning = false;
+
+        uint64_t counter = 1;
+        if( ::write(this->stopFd, &counter, sizeof(counter)) == sizeof(counter) )
+        {
+            pthread_join(this->eventThread, NULL);
+        }
+
+        // stop descriptor is drained, so processEvents() can be used from user loop again
+        while( ::read(this->stopFd, &counter, sizeof(counter)) > 0 ) {}
+    }
+
+    bool        BlackGPIOEventEngine::setCaptureBuffer(BlackGPIOCaptureBuffer *buffer)
+    {
+        if( this->isRunning )
+        {
+            return false;
+        }
+
+        this->captureBuffer = buffer;
+        return true;
+    }
+
+    bool        BlackGPIOEventEngine::getEvent(gpioEvent &event)
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+
+        if( this->queue.empty() )
+        {
+            return false;
+        }
+
+        event = this->queue.front();
+        this->queue.pop_front();
+        return true;
+    }
+
+    size_t      BlackGPIOEventEngine::getSourceCount()
+    {
+        return this->sources.size();
+    }
+
+    uint64_t    BlackGPIOEventEngine::getWakeUpCount()
+    {
+        return this->wakeUps;
+    }
+
+    uint64_t    BlackGPIOEventEngine::getDroppedCount()
+    {
+        return this->droppedEvents;
+    }
+    // ######################################## BLACKGPIOEVENTENGINE DEFINITION ENDS ###################################### //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKGPIOEVENT_H_ */
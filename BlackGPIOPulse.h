@@ -0,0 +1,440 @@
+#ifndef BLACKGPIOPULSE_H_
+#define BLACKGPIOPULSE_H_
+
+#include "BlackGPIOEvent.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+#include <time.h>           // need for clock_gettime() function
+
+namespace BlackLib
+{
+
+    /*! @brief Holds pulse measurement of a pin over one window.
+     *
+     *    Periods are measured between consecutive rising edges, and high times between a rising edge
+     *    and the next falling edge. Times are at @a nanosecond level.
+     */
+    struct pulseMeasurement
+    {
+        uint64_t    pulseCount;             /*!< @brief number of rising edges at the window */
+        uint64_t    totalPulses;            /*!< @brief number of rising edges since the pin is added */
+        uint64_t    period;                 /*!< @brief mean period at the window */
+        uint64_t    minPeriod;              /*!< @brief minimum period at the window */
+        uint64_t    maxPeriod;              /*!< @brief maximum period at the window */
+        double      frequency;              /*!< @brief frequency at Hz, calculated from mean period */
+        float       dutyCycle;              /*!< @brief mean high time percentage of the periods at the window */
+        uint64_t    windowStart;            /*!< @brief timestamp of the first edge of the window */
+        uint64_t    windowEnd;              /*!< @brief timestamp of the edge which closed the window */
+        bool        isValid;                /*!< @brief is false until the first window is closed */
+    };
+
+
+
+    // ###################################### BLACKGPIOPULSEMETER DECLARATION STARTS ###################################### //
+
+    /*! @brief Measures period, frequency, duty cycle and pulse count of gpio inputs from their edges.
+     *
+     *    Every added pin is added to a BlackGPIOEventEngine with both edges, and its edges are given to
+     *    this class with the engine callback, so all of the pins are measured by the thread which
+     *    dispatches the engine. At gpiochip backend, kernel timestamps of the edges are used; at sysfs,
+     *    wake up timestamps of the engine are used.
+     *
+     *    Each pin has preallocated accumulators, which are updated by every edge without locks and
+     *    allocations. When an edge comes after the window time of the pin, the window is closed: its
+     *    result is copied to the published measurement (under the lock of the pin, once per window),
+     *    and accumulators are cleared. Period of a pulse which passes a window boundary is counted at
+     *    the window where it ends, so no pulse is lost between windows.
+     *
+     *    A window can only be closed by an edge. A pin whose last edge is older than two windows (or
+     *    two periods, whichever is longer) is reported with zero frequency and zero pulse count, so a
+     *    stopped fan reads 0 Hz. Its duty cycle is 100 % if it is held high and 0 % if it is held low.
+     *
+     *    The engine must be stopped before the meter is destroyed, because the meter removes its pins
+     *    from the engine at its destructor.
+     *
+     * @par Example
+     * @code{.cpp}
+     *   BlackLib::BlackGPIOEventEngine engine;
+     *   BlackLib::BlackGPIOPulseMeter  meter(engine, 500000000);           // 500 ms windows
+     *
+     *   meter.addPin(BlackLib::GPIO_48);                                   // fan tachometer
+     *   meter.addPin(BlackLib::GPIO_49, 2000000000);                       // flow sensor, 2 s window
+     *   engine.start();
+     *
+     *   BlackLib::pulseMeasurement fan;
+     *   if( meter.getMeasurement(BlackLib::GPIO_48, fan) and fan.isValid )
+     *   {
+     *       std::cout << "Fan: " << fan.frequency * 30 << " rpm";         // 2 pulses per turn
+     *   }
+     *   engine.stop();
+     * @endcode
+     */
+    class BlackGPIOPulseMeter
+    {
+        private:
+            /*! @brief Holds measurement state of one pin.
+             */
+            struct pulseState
+            {
+                unsigned int            id;                 /*!< @brief gpio number or descriptor id */
+                uint64_t                window;             /*!< @brief window time at nanosecond level */
+                int                     level;              /*!< @brief last level, -1 before the first edge */
+                uint64_t                lastRise;           /*!< @brief timestamp of last rising edge, 0 before it */
+                uint64_t                lastFall;           /*!< @brief timestamp of last falling edge, 0 before it */
+                uint64_t                windowStart;        /*!< @brief timestamp of first edge of current window */
+                uint64_t                pulses;             /*!< @brief rising edges at current window */
+                uint64_t                totalPulses;        /*!< @brief rising edges since the pin is added */
+                uint64_t                periodSum;          /*!< @brief sum of periods at current window */
+                uint64_t                periodCount;        /*!< @brief number of periods at current window */
+                uint64_t                minPeriod;          /*!< @brief minimum period at current window */
+                uint64_t                maxPeriod;          /*!< @brief maximum period at current window */
+                uint64_t                highSum;            /*!< @brief sum of high times at current window */
+                uint64_t                dutyPeriodSum;      /*!< @brief sum of periods which have a measured high time */
+                std::atomic<uint64_t>   lastEdge;           /*!< @brief timestamp of last edge, read by getMeasurement() */
+                std::atomic<int>        lastLevel;          /*!< @brief level after last edge, read by getMeasurement() */
+                std::mutex              resultMutex;        /*!< @brief is used to lock published measurement */
+                pulseMeasurement        result;             /*!< @brief published measurement of last closed window */
+            };
+
+            BlackGPIOEventEngine        *engine;            /*!< @brief is used to hold the engine of the pins */
+            uint64_t                    defaultWindow;      /*!< @brief is used to hold default window time */
+            std::vector<pulseState *>   states;             /*!< @brief is used to hold states of added pins */
+
+            /*! @brief Copying is not allowed, because the engine holds pointers of the states.
+            */
+                                        BlackGPIOPulseMeter(const BlackGPIOPulseMeter &);
+
+            /*! @brief Copying is not allowed, because the engine holds pointers of the states.
+            */
+            BlackGPIOPulseMeter         &operator=(const BlackGPIOPulseMeter &);
+
+            /*! @brief Creates state of a pin.
+            *
+            *  @param [in] id           gpio number or descriptor id
+            *  @param [in] window       window time, 0 means default window time
+            *  @return Pointer of new state.
+            */
+            pulseState                  *createState(unsigned int id, uint64_t window);
+
+            /*! @brief Finds state of a pin.
+            *
+            *  @param [in] id           gpio number or descriptor id
+            *  @return Pointer of state, or NULL if the pin isn't added.
+            */
+            pulseState                  *findState(unsigned int id);
+
+            /*! @brief Updates accumulators of a pin with an edge.
+            *
+            *  @param [in,out] state    state of the pin
+            *  @param [in] event        edge
+            */
+            static void                 updateState(pulseState &state, const gpioEvent &event);
+
+            /*! @brief Copies accumulators to published measurement and clears them.
+            *
+            *  @param [in,out] state    state of the pin
+            *  @param [in] timestamp    timestamp of the edge which closes the window
+            */
+            static void                 closeWindow(pulseState &state, uint64_t timestamp);
+
+            /*! @brief Engine callback of the pins.
+            *
+            *  @param [in] event        edge
+            *  @param [in] userData     state of the pin
+            */
+            static void                 eventCallback(const gpioEvent &event, void *userData);
+
+        public:
+            /*! @brief Constructor of BlackGPIOPulseMeter class.
+            *
+            *  @param [in] eventEngine  engine which dispatches edges of the pins
+            *  @param [in] window       default window time at nanosecond level, default value is 1 second
+            */
+                                        BlackGPIOPulseMeter(BlackGPIOEventEngine &eventEngine, uint64_t window = 1000000000);
+
+            /*! @brief Destructor of BlackGPIOPulseMeter class.
+            *
+            *  This function removes the pins from the engine and deletes their states.
+            */
+            virtual                     ~BlackGPIOPulseMeter();
+
+            /*! @brief Adds a gpio input.
+            *
+            *  @param [in] pin            gpio pin name (enum)
+            *  @param [in] window         window time at nanosecond level, 0 means default window time
+            *  @param [in] debouncePeriod hardware debounce period at microsecond level, it is used only at gpiochip
+            *  @return True if adding is successful, else false. Adding fails while the engine thread is running.
+            */
+            bool                        addPin(gpioName pin, uint64_t window = 0, unsigned int debouncePeriod = 0);
+
+            /*! @brief Adds a readable descriptor as input.
+            *
+            *  @param [in] fd           descriptor, see BlackGPIOEventEngine::addDescriptor()
+            *  @param [in] id           id of the input
+            *  @param [in] window       window time at nanosecond level, 0 means default window time
+            *  @return True if adding is successful, else false.
+            */
+            bool                        addDescriptor(int fd, unsigned int id, uint64_t window = 0);
+
+            /*! @brief Gives an edge which isn't dispatched by the engine (like an edge of a capture buffer).
+            *
+            *  This function must be called from the thread which dispatches the engine, or the engine
+            *  must not be running.
+            *  @param [in] event        edge, its id must be an added pin
+            *  @return True if the pin is found, else false.
+            */
+            bool                        handleEvent(const gpioEvent &event);
+
+            /*! @brief Exports measurement of last closed window of a pin.
+            *
+            *  This function can be called from any thread.
+            *  @param [in] id           gpio number or descriptor id
+            *  @param [out] result      measurement
+            *  @return True if the pin is found, else false.
+            *  @sa pulseMeasurement
+            */
+            bool                        getMeasurement(unsigned int id, pulseMeasurement &result);
+
+            /*! @brief Exports number of added pins.
+            *
+            *  @return Number of pins.
+            */
+            size_t                      getPinCount();
+    };
+    // ####################################### BLACKGPIOPULSEMETER DECLARATION ENDS ####################################### //
+
+
+
+
+
+    // ####################################### BLACKGPIOPULSEMETER DEFINITION STARTS ###################################### //
+    BlackGPIOPulseMeter::BlackGPIOPulseMeter(BlackGPIOEventEngine &eventEngine, uint64_t window)
+    {
+        this->engine        = &eventEngine;
+        this->defaultWindow = (window == 0) ? 1 : window;
+    }
+
+    BlackGPIOPulseMeter::~BlackGPIOPulseMeter()
+    {
+        for( size_t i = 0 ; i < this->states.size() ; i++ )
+        {
+            this->engine->remove(this->states[i]->id);
+            delete this->states[i];
+        }
+    }
+
+    BlackGPIOPulseMeter::pulseState *BlackGPIOPulseMeter::createState(unsigned int id, uint64_t window)
+    {
+        pulseState *state       = new pulseState;
+        state->id               = id;
+        state->window           = (window == 0) ? this->defaultWindow : window;
+        state->level            = -1;
+        state->lastRise         = 0;
+        state->lastFall         = 0;
+        state->windowStart      = 0;
+        state->pulses           = 0;
+        state->totalPulses      = 0;
+        state->periodSum        = 0;
+        state->periodCount      = 0;
+        state->minPeriod        = 0;
+        state->maxPeriod        = 0;
+        state->highSum          = 0;
+        state->dutyPeriodSum    = 0;
+        state->lastEdge         = 0;
+        state->lastLevel        = -1;
+
+        memset(&state->result, 0, sizeof(state->result));
+        return state;
+    }
+
+    BlackGPIOPulseMeter::pulseState *BlackGPIOPulseMeter::findState(unsigned int id)
+    {
+        for( size_t i = 0 ; i < this->states.size() ; i++ )
+        {
+            if( this->states[i]->id == id )
+            {
+                return this->states[i];
+            }
+        }
+        return NULL;
+    }
+
+    bool        BlackGPIOPulseMeter::addPin(gpioName pin, uint64_t window, unsigned int debouncePeriod)
+    {
+        if( this->findState(static_cast<unsigned int>(pin)) != NULL )
+        {
+            return false;
+        }
+
+        pulseState *state = this->createState(static_cast<unsigned int>(pin), window);
+        if( ! this->engine->addPin(pin, bothEdges, &BlackGPIOPulseMeter::eventCallback, state, debouncePeriod) )
+        {
+            delete state;
+            return false;
+        }
+
+        this->states.push_back(state);
+        return true;
+    }
+
+    bool        BlackGPIOPulseMeter::addDescriptor(int fd, unsigned int id, uint64_t window)
+    {
+        if( this->findState(id) != NULL )
+        {
+            return false;
+        }
+
+        pulseState *state = this->createState(id, window);
+        if( ! this->engine->addDescriptor(fd, id, &BlackGPIOPulseMeter::eventCallback, state) )
+        {
+            delete state;
+            return false;
+        }
+
+        this->states.push_back(state);
+        return true;
+    }
+
+    void        BlackGPIOPulseMeter::eventCallback(const gpioEvent &event, void *userData)
+    {
+        BlackGPIOPulseMeter::updateState( *static_cast<pulseState *>(userData), event );
+    }
+
+    bool        BlackGPIOPulseMeter::handleEvent(const gpioEvent &event)
+    {
+        pulseState *state = this->findState(event.id);
+        if( state == NULL )
+        {
+            return false;
+        }
+
+        BlackGPIOPulseMeter::updateState(*state, event);
+        return true;
+    }
+
+    void        BlackGPIOPulseMeter::updateState(pulseState &state, const gpioEvent &event)
+    {
+        // sysfs reports levels; a level which repeats is not an edge
+        if( event.value == state.level )
+        {
+            return;
+        }
+
+        if( state.level < 0 )
+        {
+            state.windowStart = event.timestamp;
+        }
+        else if( event.timestamp - state.windowStart >= state.window )
+        {
+            BlackGPIOPulseMeter::closeWindow(state, event.timestamp);
+        }
+
+        state.level = event.value;
+
+        if( event.value == 1 )
+        {
+            if( state.lastRise != 0 )
+            {
+                uint64_t period = event.timestamp - state.lastRise;
+
+                state.periodSum += period;
+                state.minPeriod  = (state.periodCount == 0 or period < state.minPeriod) ? period : state.minPeriod;
+                state.maxPeriod  = (period > state.maxPeriod) ? period : state.maxPeriod;
+                state.periodCount++;
+
+                // high time of the finished period
+                if( state.lastFall > state.lastRise )
+                {
+                    state.highSum       += state.lastFall - state.lastRise;
+                    state.dutyPeriodSum += period;
+                }
+            }
+
+            state.lastRise = event.timestamp;
+            state.pulses++;
+            state.totalPulses++;
+        }
+        else
+        {
+            state.lastFall = event.timestamp;
+        }
+
+        state.lastLevel.store(event.value, std::memory_order_relaxed);
+        state.lastEdge.store(event.timestamp, std::memory_order_relaxed);
+    }
+
+    void        BlackGPIOPulseMeter::closeWindow(pulseState &state, uint64_t timestamp)
+    {
+        {
+            std::lock_guard<std::mutex> lock(state.resultMutex);
+            pulseMeasurement &result = state.result;
+
+            result.pulseCount   = state.pulses;
+            result.totalPulses  = state.totalPulses;
+            result.period       = (state.periodCount == 0) ? 0 : state.periodSum / state.periodCount;
+            result.minPeriod    = state.minPeriod;
+            result.maxPeriod    = state.maxPeriod;
+            result.frequency    = (state.periodSum == 0) ? 0.0 : state.periodCount * 1e9 / state.periodSum;
+            result.dutyCycle    = (state.dutyPeriodSum == 0) ? 0.0f : static_cast<float>(state.highSum * 100.0 / state.dutyPeriodSum);
+            result.windowStart  = state.windowStart;
+            result.windowEnd    = timestamp;
+            result.isValid      = true;
+        }
+
+        state.windowStart   = timestamp;
+        state.pulses        = 0;
+        state.periodSum     = 0;
+        state.periodCount   = 0;
+        state.minPeriod     = 0;
+        state.maxPeriod     = 0;
+        state.highSum       = 0;
+        state.dutyPeriodSum = 0;
+    }
+
+    bool        BlackGPIOPulseMeter::getMeasurement(unsigned int id, pulseMeasurement &result)
+    {
+        pulseState *state = this->findState(id);
+        if( state == NULL )
+        {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(state->resultMutex);
+            result = state->result;
+        }
+
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        uint64_t nowTime    = static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+        uint64_t lastEdge   = state->lastEdge.load(std::memory_order_relaxed);
+        uint64_t timeout    = 2 * ( (result.maxPeriod > state->window) ? result.maxPeriod : state->window );
+
+        // no edge for a long time, the signal is stopped
+        if( result.isValid and nowTime > lastEdge and nowTime - lastEdge > timeout )
+        {
+            result.pulseCount   = 0;
+            result.period       = 0;
+            result.minPeriod    = 0;
+            result.maxPeriod    = 0;
+            result.frequency    = 0.0;
+            result.dutyCycle    = (state->lastLevel.load(std::memory_order_relaxed) == 1) ? 100.0f : 0.0f;
+            result.windowStart  = lastEdge;
+            result.windowEnd    = nowTime;
+        }
+
+        return true;
+    }
+
+    size_t      BlackGPIOPulseMeter::getPinCount()
+    {
+        return this->states.size();
+    }
+    // ######################################## BLACKGPIOPULSEMETER DEFINITION ENDS ####################################### //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKGPIOPULSE_H_ */
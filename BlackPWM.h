@@ -2,11 +2,16 @@
 #define BLACKPWM_H_
 
 #include "BlackCore.h"
+#include "BlackPins.h"
 
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <cstdlib>          // need for strtoll() function
+#include <mutex>            // need for locking of process wide layout and pwmchip path caches
 #include <stdint.h>
+#include <fcntl.h>          // need for open() function
+#include <unistd.h>         // need for pread(), pwrite() and close() functions
 
 using namespace std;
 
@@ -52,6 +57,69 @@ namespace BlackLib
                                 reverse                 = 1
                             };
 
+    /*!
+    * This enum is used for selecting the way which BlackPWM accesses to hardware.
+    */
+    enum pwmBackend         {   sysfsBackend            = 0,    /*!< pwm_test driver files at ocp directory */
+                                registerBackend         = 1,    /*!< memory mapped PWMSS registers */
+                                pwmchipBackend          = 2,    /*!< pwmchip files at /sys/class/pwm directory */
+                                autoBackend             = 3     /*!< sysfsBackend or pwmchipBackend, whichever the kernel has */
+                            };
+
+    /*!
+    * This array is used for mapping pwm name to header pin.
+    */
+    constexpr headerPin pwmHeaderPinMap[7] = {  HEADER_P8_13,
+                                                HEADER_P8_19,
+                                                HEADER_P9_14,
+                                                HEADER_P9_16,
+                                                HEADER_P9_21,
+                                                HEADER_P9_22,
+                                                HEADER_P9_42
+                                            };
+
+    /*!
+    * This array is used for mapping pwm name to PWMSS module physical address.
+    */
+    constexpr uint32_t pwmModuleAddressMap[7] = {   headerPinPwmModuleAddress(HEADER_P8_13),    // PWMSS2
+                                                    headerPinPwmModuleAddress(HEADER_P8_19),    // PWMSS2
+                                                    headerPinPwmModuleAddress(HEADER_P9_14),    // PWMSS1
+                                                    headerPinPwmModuleAddress(HEADER_P9_16),    // PWMSS1
+                                                    headerPinPwmModuleAddress(HEADER_P9_21),    // PWMSS0
+                                                    headerPinPwmModuleAddress(HEADER_P9_22),    // PWMSS0
+                                                    headerPinPwmModuleAddress(HEADER_P9_42)     // PWMSS0
+                                                };
+
+    /*!
+    * This array is used for mapping pwm name to output of PWMSS module. 0 is EHRPWM A output,
+    * 1 is EHRPWM B output and 2 is eCAP output.
+    */
+    constexpr unsigned int pwmChannelMap[7] = { findHeaderPin(HEADER_P8_13).pwmOutput,
+                                                findHeaderPin(HEADER_P8_19).pwmOutput,
+                                                findHeaderPin(HEADER_P9_14).pwmOutput,
+                                                findHeaderPin(HEADER_P9_16).pwmOutput,
+                                                findHeaderPin(HEADER_P9_21).pwmOutput,
+                                                findHeaderPin(HEADER_P9_22).pwmOutput,
+                                                findHeaderPin(HEADER_P9_42).pwmOutput
+                                            };
+
+    /*!
+    * This array is used for mapping pwm name to pwm number of its pwmchip (pwmM directory). EHRPWM B
+    * output is pwm1; EHRPWM A and eCAP outputs are pwm0.
+    */
+    constexpr unsigned int pwmChipChannelMap[7] = { (pwmChannelMap[P8_13] == 1) ? 1u : 0u,
+                                                    (pwmChannelMap[P8_19] == 1) ? 1u : 0u,
+                                                    (pwmChannelMap[P9_14] == 1) ? 1u : 0u,
+                                                    (pwmChannelMap[P9_16] == 1) ? 1u : 0u,
+                                                    (pwmChannelMap[P9_21] == 1) ? 1u : 0u,
+                                                    (pwmChannelMap[P9_22] == 1) ? 1u : 0u,
+                                                    (pwmChannelMap[P9_42] == 1) ? 1u : 0u
+                                                };
+
+    static_assert( pwmModuleAddressMap[P8_13] == 0x48304000 and pwmModuleAddressMap[P9_14] == 0x48302000 and
+                   pwmModuleAddressMap[P9_42] == 0x48300000,                        "pwm pin map is broken" );
+    static_assert( pwmChannelMap[P8_13] == 1 and pwmChannelMap[P8_19] == 0 and pwmChannelMap[P9_42] == 2, "pwm pin map is broken" );
+
 
 
 
@@ -67,15 +135,19 @@ namespace BlackLib
     {
         private:
             errorCorePWM    *pwmCoreErrors;             /*!< @brief is used to hold the errors of BlackCorePWM class */
-            std::string     pwmTestPath;                /*!< @brief is used to hold the pwm_test (pwm device driver) path */
+            std::string     pwmTestPath;                /*!< @brief is used to hold the pwm_test or pwmchip channel directory path */
             pwmName         pwmPinName;                 /*!< @brief is used to hold the selected pwm @b pin name */
+            pwmBackend      pwmLayout;                  /*!< @brief is used to hold the sysfs layout, sysfsBackend or pwmchipBackend */
+            uint64_t        pathGeneration;             /*!< @brief is used to hold the discovery index generation of pwm_test path */
 
             /*! @brief Loads PWM overlays to device tree.
             *
             *  This function loads @b "am33xx_pwm" and @b "bone_pwm_P?_?" overlay to device tree.
             *  Question marks at the second overlay, represents port and pin numbers of selected PWM
-            *  output. This overlays perform pinmuxing and generate device drivers.
+            *  output. This overlays perform pinmuxing and generate device drivers. Overlays which are
+            *  already loaded are not written to slots file again.
             *  @return True if successful, else false.
+            *  @sa BlackCore::loadOverlay()
             */
             bool            loadDeviceTree();
 
@@ -88,6 +160,25 @@ namespace BlackLib
             */
             std::string     findPwmTestName(pwmName pwm);
 
+            /*! @brief Checks existence of directory entry which starts with entered prefix.
+            *
+            *  @param [in] searchIn     directory path
+            *  @param [in] prefix       searched name prefix
+            *  @return True if an entry is found, else false.
+            */
+            static bool     hasEntry(const std::string &searchIn, const std::string &prefix);
+
+            /*! @brief Finds pwmchip directory of pwm.
+            *
+            *  Every entry of @b "/sys/class/pwm" is a link to pwmchip directory of a device. The device
+            *  name starts with register address of the EHRPWM or eCAP block (for example @b "48302200."
+            *  for EHRPWM1), so link targets are compared with this address. Found paths are cached
+            *  for the process, and the cache is locked, so it can be called from several threads.
+            *  @param [in] pwm          pwm name (enum)
+            *  @return Full path of pwmchip directory if successful, else BlackLib::SEARCH_DIR_NOT_FOUND string.
+            */
+            static std::string findPwmChipPath(pwmName pwm);
+
 
         protected:
             /*! @brief Exports pwm period file name to derived class.
@@ -120,18 +211,38 @@ namespace BlackLib
             */
             errorCorePWM    *getErrorsFromCorePWM();
 
+            /*! @brief Exports sysfs layout to derived class.
+            *
+            *  @return BlackLib::sysfsBackend for pwm_test files, BlackLib::pwmchipBackend for pwmchip files.
+            */
+            pwmBackend      getLayout();
+
+            /*! @brief Finds pwm_test directory again, if discovery index is changed.
+            *
+            *  This function compares generation of BlackDiscoveryIndex with the generation which pwm_test
+            *  path was found at. It does nothing else if they are same. Otherwise pwm_test name is taken
+            *  from the index again; it is resolved by watcher thread already, when watcher is running.
+            *  @return True if pwm_test path is changed, else false.
+            *  @sa BlackCore::startDiscoveryWatcher()
+            */
+            bool            updatePwmTestPath();
+
         public:
 
             /*! @brief Constructor of BlackCorePWM class.
             *
-            *  This function initializes errorCorePWM struct and calls device tree loading and
-            *  pwm test name finding functions.
+            *  This function initializes errorCorePWM struct and selects sysfs layout. At pwm_test layout,
+            *  it calls device tree loading and pwm test name finding functions. At pwmchip layout, it
+            *  exports the pwm from its pwmchip instead; device tree overlays are not loaded.
+            *  @param [in] pwm          pwm name (enum)
+            *  @param [in] backend      backend of BlackPWM (enum), it is used for selecting the layout
             *
             *  @sa BlackCorePWM::loadDeviceTree()
             *  @sa BlackCorePWM::findPwmTestName()
+            *  @sa BlackCorePWM::selectLayout()
             *  @sa pwmName
             */
-                            BlackCorePWM(pwmName pwm);
+                            BlackCorePWM(pwmName pwm, pwmBackend backend = sysfsBackend);
 
             /*! @brief Destructor of BlackCorePWM class.
             *
@@ -142,6 +253,29 @@ namespace BlackLib
             /*! @brief First declaration of this function.
             */
             virtual std::string getValue() = 0;
+
+            /*! @brief Selects sysfs layout of a backend.
+            *
+            *  BlackLib::sysfsBackend and BlackLib::pwmchipBackend select their own layouts. Other backends
+            *  use detected layout of the kernel. Detection is done once in a process: pwm_test layout is
+            *  selected when cape manager exists at @b "/sys/devices" directory (pwm_test driver holds the
+            *  pwms at these kernels), else pwmchip layout is selected when @b "/sys/class/pwm" directory
+            *  has a pwmchip. Detection is locked, so it can be called from several threads.
+            *  @param [in] backend      backend of BlackPWM (enum)
+            *  @return BlackLib::sysfsBackend or BlackLib::pwmchipBackend.
+            */
+            static pwmBackend   selectLayout(pwmBackend backend);
+
+            /*! @brief Exports pwms from their pwmchips.
+            *
+            *  Export file of every pwmchip is opened once, and all of the pwms of that chip which aren't
+            *  exported yet are written to this descriptor. Export fails if the export file can't be opened,
+            *  or a write fails for any reason except that the pwm is already exported.
+            *  @param [in] pwms         pwm names (enum array)
+            *  @param [in] count        size of @a pwms array
+            *  @return True if all of the pwm directories exist after exporting, else false.
+            */
+            static bool         exportPwmChannels(const pwmName *pwms, unsigned int count);
     };
     // ########################################## BLACKCOREPWM DECLARATION ENDS ########################################### //
 
@@ -154,6 +288,259 @@ namespace BlackLib
 
 
 
+    // ######################################### BLACKPWMBACKEND DECLARATION STARTS ####################################### //
+
+    /*! @brief Hardware access interface of BlackPWM.
+     *
+     *    BlackPWM reads and writes period, duty, run and polarity values through this interface. All of
+     *    the values have pwm_test driver meaning: period and duty are at nanosecond level, run and
+     *    polarity are 0 or 1.
+     */
+    class BlackPWMBackend
+    {
+        public:
+            /*!
+            * This enum is used for selecting pwm attribute.
+            */
+            enum attribute  {   periodAttribute     = 0,
+                                dutyAttribute       = 1,
+                                runAttribute        = 2,
+                                polarityAttribute   = 3
+                            };
+
+            /*! @brief Destructor of BlackPWMBackend class.
+            */
+            virtual         ~BlackPWMBackend() {}
+
+            /*! @brief Reads current value of pwm attribute from hardware.
+            *
+            *  @param [in] attr         attribute (enum)
+            *  @param [out] value       read value
+            *  @return True if reading is successful, else false.
+            */
+            virtual bool    readAttribute(attribute attr, int64_t &value) = 0;
+
+            /*! @brief Writes new value of pwm attribute to hardware.
+            *
+            *  Like pwm_test driver, implementations reject a period which is less than current duty
+            *  and a duty which is greater than current period.
+            *  @param [in] attr         attribute (enum)
+            *  @param [in] value        new value
+            *  @return True if writing is successful, else false.
+            */
+            virtual bool    writeAttribute(attribute attr, int64_t value) = 0;
+    };
+
+
+
+    /*! @brief Accesses pwm through pwm_test driver files.
+     *
+     *    This backend opens period, duty, run and polarity files once and holds them open. All reads
+     *    and writes are done with one pread() or pwrite() call at offset 0 of cached descriptors.
+     */
+    class BlackPWMSysfsBackend : public BlackPWMBackend
+    {
+        protected:
+            std::string     paths[4];                   /*!< @brief is used to hold the attribute file paths */
+            int             fds[4];                     /*!< @brief is used to hold the attribute file descriptors */
+
+            /*! @brief Opens attribute file, if it isn't open.
+            *
+            *  @param [in] attr         attribute (enum)
+            *  @return True if file descriptor is open, else false.
+            */
+            bool            openAttribute(attribute attr);
+
+        public:
+            /*! @brief Constructor of BlackPWMSysfsBackend class.
+            *
+            *  This function opens entered files. If opening fails, it is tried again at next access.
+            *  @param [in] periodPath   period file path
+            *  @param [in] dutyPath     duty file path
+            *  @param [in] runPath      run file path
+            *  @param [in] polarityPath polarity file path
+            */
+                            BlackPWMSysfsBackend(const std::string &periodPath, const std::string &dutyPath,
+                                                 const std::string &runPath, const std::string &polarityPath);
+
+            /*! @brief Destructor of BlackPWMSysfsBackend class.
+            *
+            *  This function closes attribute files.
+            */
+            virtual         ~BlackPWMSysfsBackend();
+
+            /*! @brief Reads numeric value of attribute file.
+            *
+            *  @sa BlackPWMBackend::readAttribute()
+            */
+            bool            readAttribute(attribute attr, int64_t &value);
+
+            /*! @brief Writes numeric value to attribute file.
+            *
+            *  The value is converted to decimal text with trailing new line, like
+            *  <b> "echo value > file" </b> command does.
+            *  @sa BlackPWMBackend::writeAttribute()
+            */
+            bool            writeAttribute(attribute attr, int64_t value);
+    };
+
+
+
+    /*! @brief Accesses pwm through pwmchip files of /sys/class/pwm directory.
+     *
+     *    This backend uses period, duty_cycle, enable and polarity files of a pwmchip channel with cached
+     *    descriptors, like BlackPWMSysfsBackend. pwmchip @a duty_cycle is the time that output stays at
+     *    active level, but pwm_test @a duty is the time that output stays at "0" when polarity is
+     *    straight. So straight polarity is written as @b "inversed" and reverse polarity is written as
+     *    @b "normal"; then period, duty and run values are same numbers at both of the layouts.
+     *
+     *    Kernel doesn't allow changing polarity of an enabled pwm, polarity writes fail while it runs.
+     */
+    class BlackPWMChipBackend : public BlackPWMSysfsBackend
+    {
+        public:
+            /*! @brief Constructor of BlackPWMChipBackend class.
+            *
+            *  @param [in] periodPath   period file path
+            *  @param [in] dutyPath     duty_cycle file path
+            *  @param [in] runPath      enable file path
+            *  @param [in] polarityPath polarity file path
+            */
+                            BlackPWMChipBackend(const std::string &periodPath, const std::string &dutyPath,
+                                                const std::string &runPath, const std::string &polarityPath);
+
+            /*! @brief Reads value of attribute file, polarity text is converted to pwm_test value.
+            *
+            *  @sa BlackPWMBackend::readAttribute()
+            */
+            bool            readAttribute(attribute attr, int64_t &value);
+
+            /*! @brief Writes value to attribute file, polarity value is converted to pwmchip text.
+            *
+            *  @sa BlackPWMBackend::writeAttribute()
+            */
+            bool            writeAttribute(attribute attr, int64_t value);
+    };
+
+
+
+    /*! @brief Accesses pwm through memory mapped PWMSS registers.
+     *
+     *    This backend maps the PWMSS module of the pwm and updates EHRPWM (TBCTL, TBPRD, CMPA, CMPB,
+     *    AQCTLA, AQCTLB, AQCSFRC) or eCAP (CAP1, CAP2, ECCTL2) registers directly. Attribute values keep
+     *    pwm_test driver meaning, so BlackPWM works same with both of the backends:
+     *    @li output stays at "1" for <b> (period - duty) </b> when polarity is straight,
+     *    @li stopped EHRPWM output is forced to its inactive level, stopped eCAP counter is frozen.
+     *
+     *    Time base clock is 100 MHz. EHRPWM period is 16 bit, so prescaler is selected as the smallest
+     *    one which fits the period; resolution of values is 10 ns multiplied by the prescaler.
+     *    A and B outputs of an EHRPWM module share the period.
+     *
+     *    Module clock and pinmux are prepared by the kernel before mapping: BlackCorePWM loads device
+     *    tree overlays at pwm_test layout and exports the pwm at pwmchip layout.
+     */
+    class BlackPWMRegisterBackend : public BlackPWMBackend
+    {
+        private:
+            /*!
+            * This enum is used for defining register offsets.
+            */
+            enum registerOffset {   pwmssClockConfig    = 0x008,    /*!< PWMSS clock config, from module base */
+                                    ecapBlock           = 0x100,    /*!< eCAP registers, from module base */
+                                    epwmBlock           = 0x200,    /*!< EHRPWM registers, from module base */
+
+                                    epwmTbctl           = 0x00,     /*!< time base control, from EHRPWM block */
+                                    epwmTbprd           = 0x0A,     /*!< time base period, from EHRPWM block */
+                                    epwmCmpa            = 0x12,     /*!< counter compare A, from EHRPWM block */
+                                    epwmCmpb            = 0x14,     /*!< counter compare B, from EHRPWM block */
+                                    epwmAqctla          = 0x16,     /*!< action qualifier A, from EHRPWM block */
+                                    epwmAqctlb          = 0x18,     /*!< action qualifier B, from EHRPWM block */
+                                    epwmAqsfrc          = 0x1A,     /*!< software force, from EHRPWM block */
+                                    epwmAqcsfrc         = 0x1C,     /*!< continuous software force, from EHRPWM block */
+
+                                    ecapCap1            = 0x08,     /*!< APWM period, from eCAP block */
+                                    ecapCap2            = 0x0C,     /*!< APWM compare, from eCAP block */
+                                    ecapEcctl2          = 0x2A      /*!< eCAP control 2, from eCAP block */
+                                };
+
+            BlackMemoryRegion   *region;                /*!< @brief is used to hold mapped PWMSS module */
+            unsigned int        channel;                /*!< @brief is used to hold output, 0: EHRPWM A, 1: EHRPWM B, 2: eCAP */
+
+            /*! @brief Calculates prescaler of EHRPWM from TBCTL register value.
+            *
+            *  @param [in] tbctl        TBCTL register value
+            *  @return Total prescaler (CLKDIV x HSPCLKDIV).
+            */
+            uint32_t        epwmPrescaler(uint16_t tbctl);
+
+            /*! @brief Reads period value from registers.
+            *
+            *  @return Period at nanosecond level.
+            */
+            int64_t         readPeriod();
+
+            /*! @brief Reads duty value of an output from registers.
+            *
+            *  @param [in] output       0: EHRPWM A, 1: EHRPWM B, 2: eCAP
+            *  @return Duty at nanosecond level.
+            */
+            int64_t         readDuty(unsigned int output);
+
+            /*! @brief Writes compare register of an output.
+            *
+            *  @param [in] output       0: EHRPWM A, 1: EHRPWM B, 2: eCAP
+            *  @param [in] period       current period at nanosecond level
+            *  @param [in] duty         new duty at nanosecond level
+            */
+            void            writeDuty(unsigned int output, int64_t period, int64_t duty);
+
+            /*! @brief Writes period registers and keeps duty values of outputs.
+            *
+            *  @param [in] period       new period at nanosecond level
+            */
+            void            writePeriod(int64_t period);
+
+            /*! @brief Copying is not allowed, because the object owns the mapping.
+            */
+                            BlackPWMRegisterBackend(const BlackPWMRegisterBackend &);
+
+            /*! @brief Copying is not allowed, because the object owns the mapping.
+            */
+            BlackPWMRegisterBackend &operator=(const BlackPWMRegisterBackend &);
+
+        public:
+            /*! @brief Constructor of BlackPWMRegisterBackend class.
+            *
+            *  This function maps the PWMSS module of @a pwm, enables its module clock and prepares
+            *  the output (action qualifiers or APWM mode), if it isn't prepared yet.
+            *  @param [in] pwm          pwm name (enum)
+            */
+                            BlackPWMRegisterBackend(pwmName pwm);
+
+            /*! @brief Destructor of BlackPWMRegisterBackend class.
+            *
+            *  This function unmaps the module.
+            */
+            virtual         ~BlackPWMRegisterBackend();
+
+            /*! @brief Decodes attribute value from registers.
+            *
+            *  @sa BlackPWMBackend::readAttribute()
+            */
+            bool            readAttribute(attribute attr, int64_t &value);
+
+            /*! @brief Encodes attribute value to registers.
+            *
+            *  @sa BlackPWMBackend::writeAttribute()
+            */
+            bool            writeAttribute(attribute attr, int64_t value);
+    };
+    // ########################################## BLACKPWMBACKEND DECLARATION ENDS ######################################## //
+
+
+
+
+
     // ########################################### BLACKPWM DECLARATION STARTS ############################################ //
 
     /*! @brief Interacts with end user, to use PWM.
@@ -275,6 +662,43 @@ namespace BlackLib
             std::string     dutyPath;                   /*!< @brief is used to hold the @a duty file path */
             std::string     runPath;                    /*!< @brief is used to hold the @a run file path */
             std::string     polarityPath;               /*!< @brief is used to hold the @a polarity file path */
+            BlackPWMBackend *backend;                   /*!< @brief is used to hold the hardware access backend */
+            pwmBackend      backendType;                /*!< @brief is used to hold the type of hardware access backend */
+            int64_t         periodShadow;               /*!< @brief is used to hold the last known @a period value */
+            int64_t         dutyShadow;                 /*!< @brief is used to hold the last known @a duty value */
+            int64_t         runShadow;                  /*!< @brief is used to hold the last known @a run value */
+            int64_t         polarityShadow;             /*!< @brief is used to hold the last known @a polarity value */
+
+            /*! @brief Fills shadow value of pwm attribute, if it is not known.
+            *
+            *  Shadow values equal to BlackLib::FILE_COULD_NOT_OPEN_INT, when they are not known. In
+            *  this case the attribute is read from backend and its value is saved to @a shadow.
+            *  @param [in] attr         attribute (enum)
+            *  @param [in,out] shadow   shadow value of the attribute
+            *  @return True if shadow value is known, else false.
+            */
+            bool            fetchAttribute(BlackPWMBackend::attribute attr, int64_t &shadow);
+
+            /*! @brief Writes pwm attribute through its shadow value.
+            *
+            *  If @a value equals to known shadow value, nothing is written. Otherwise value is written
+            *  to the backend and shadow value is updated after successful writing.
+            *  @param [in] attr         attribute (enum)
+            *  @param [in,out] shadow   shadow value of the attribute
+            *  @param [in] value        new value
+            *  @return True if hardware holds @a value after call, else false.
+            */
+            bool            storeAttribute(BlackPWMBackend::attribute attr, int64_t &shadow, int64_t value);
+
+            /*! @brief Reopens pwm files, if pwm_test directory is changed.
+            *
+            *  This function is called before every hardware access. It costs one atomic read when
+            *  nothing is changed. If pwm_test path is changed (overlay is loaded again), file paths are
+            *  updated, files are opened at new paths and shadow values are cleared; old files are
+            *  never written.
+            *  @sa BlackCorePWM::updatePwmTestPath()
+            */
+            void            checkPaths();
 
 
         public:
@@ -296,26 +720,35 @@ namespace BlackLib
             /*! @brief Constructor of BlackPWM class.
             *
             * This function initializes BlackCorePWM class with entered parameter and errorPWM struct.
-            * Then it sets file paths of period, duty, polarity and run files.
+            * Then it sets file paths of period, duty, polarity and run files and creates the selected
+            * backend. Sysfs and pwmchip backends open these files and hold them open until destruction
+            * of the object; register backend maps PWMSS registers of the pwm instead. Auto backend uses
+            * the sysfs layout which BlackCorePWM detected. At the end, current values are read to shadow
+            * values by calling resync().
             * @param [in] pwm        pwm name (enum)
+            * @param [in] backend    hardware access way (enum), default value is autoBackend
             *
             * @par Example
             *  @code{.cpp}
             *   BlackLib::BlackPWM  myPwm(BlackLib::P8_19);
             *   BlackLib::BlackPWM *myPwmPtr = new BlackLib::BlackPWM(BlackLib::EHRPWM2B);
+            *   BlackLib::BlackPWM  myFastPwm(BlackLib::P9_14, BlackLib::registerBackend);
             *
             *   myPwm.getValue();
             *   myPwmPtr->getValue();
+            *   myFastPwm.getValue();
             *
             * @endcode
             *
             * @sa pwmName
+            * @sa pwmBackend
             */
-                            BlackPWM(pwmName pwm);
+                            BlackPWM(pwmName pwm, pwmBackend backend = autoBackend);
 
             /*! @brief Destructor of BlackPWM class.
             *
-            * This function deletes errorPWM struct pointer.
+            * This function deletes backend, which closes pwm attribute files or unmaps registers, and
+            * deletes errorPWM struct pointer.
             */
             virtual         ~BlackPWM();
 
@@ -346,7 +779,8 @@ namespace BlackLib
 
             /*! @brief Reads period value of pwm signal.
             *
-            * This function reads specified file from path, where defined at BlackPWM::periodPath variable.
+            * This function returns shadow value of the file, where defined at BlackPWM::periodPath variable.
+            * The file is read only if its shadow value is not known yet.
             * This file holds pwm period value at nanosecond (ns) level.
             *  @return @a string type period value. If file opening fails, it returns BlackLib::FILE_COULD_NOT_OPEN_STRING.
             *
@@ -371,7 +805,8 @@ namespace BlackLib
 
             /*! @brief Reads duty value of pwm signal.
             *
-            * This function reads specified file from path, where defined at BlackPWM::dutyPath variable.
+            * This function returns shadow value of the file, where defined at BlackPWM::dutyPath variable.
+            * The file is read only if its shadow value is not known yet.
             * This file holds pwm duty value at nanosecond (ns) level.
             *  @return @a string type duty value. If file opening fails, it returns BlackLib::FILE_COULD_NOT_OPEN_STRING.
             *
@@ -397,7 +832,8 @@ namespace BlackLib
 
             /*! @brief Reads run value of pwm signal.
             *
-            * This function reads specified file from path, where defined at BlackPWM::runPath variable.
+            * This function returns shadow value of the file, where defined at BlackPWM::runPath variable.
+            * The file is read only if its shadow value is not known yet.
             * This file holds pwm run value.
             *  @return @a string type run value. If file opening fails, it returns BlackLib::FILE_COULD_NOT_OPEN_STRING.
             *
@@ -424,7 +860,8 @@ namespace BlackLib
 
             /*! @brief Reads polarity value of pwm signal.
             *
-            * This function reads specified file from path, where defined at BlackPWM::polarityPath variable.
+            * This function returns shadow value of the file, where defined at BlackPWM::polarityPath variable.
+            * The file is read only if its shadow value is not known yet.
             * This file holds pwm polarity value.
             *  @return @a String type polarity value. If file opening fails, it returns BlackLib::FILE_COULD_NOT_OPEN_STRING.
             *
@@ -476,7 +913,8 @@ namespace BlackLib
 
             /*! @brief Reads numeric period value of pwm signal.
             *
-            * This function reads specified file from path, where defined at BlackPWM::periodPath variable.
+            * This function returns shadow value of the file, where defined at BlackPWM::periodPath variable.
+            * The file is read only if its shadow value is not known yet.
             * This file holds pwm period value at nanosecond (ns) level.
             * @return @a int64_t (long int) type period value.  If file opening fails, it returns BlackLib::FILE_COULD_NOT_OPEN_INT.
             * @warning Any alphabetic character existence in period file can crash your application.
@@ -502,7 +940,8 @@ namespace BlackLib
 
             /*! @brief Reads numeric duty value of pwm signal.
             *
-            * This function reads specified file from path, where defined at BlackPWM::dutyPath variable.
+            * This function returns shadow value of the file, where defined at BlackPWM::dutyPath variable.
+            * The file is read only if its shadow value is not known yet.
             * This file holds pwm duty value at nanosecond (ns) level.
             * @return @a int64_t (long int) type duty value.  If file opening fails, it returns BlackLib::FILE_COULD_NOT_OPEN_INT.
             * @warning Any alphabetic character existence in period file can crash your application.
@@ -560,11 +999,46 @@ namespace BlackLib
             * @endcode
             *
             * @sa getNumericPeriodValue()
-            * @note This function can do very little rounding error at new duty value. For example if
-            * your current duty value is \f$ 10^6 \f$, this rounding error equals maximum \f$ 0.5 / 10^6 = 5*10^-7 \f$
+            * @note Percentage is converted to parts per million of period, the rest of calculation is done
+            * with integer math. So new duty value has maximum 0.5 ns rounding error plus resolution of
+            * \f$ 10^-4 \f$ percent.
             */
             bool            setDutyPercent(float percentage);
 
+            /*! @brief Sets load time of pwm signal at nanosecond level.
+            *
+            * This function is integer version of setDutyPercent() and nanosecond version of
+            * setLoadRatioTime(). Input parameter is the time which output stays at "1" (load time) and
+            * it must not be greater than current period. It isn't the duty file value: duty file value
+            * is calculated as <b> (current period - load) </b> without floating point math, so
+            * getDutyValue() returns that difference. Use setSpaceRatioTime() for writing the duty file
+            * value directly.
+            * @param [in] load new load time at nanosecond level
+            * @return True if setting new value is successful, else false.
+            *
+            * @par Example
+            * @code{.cpp}
+            *   BlackLib::BlackPWM myPwm(BlackLib::P8_19);
+            *
+            *   myPwm.setPeriodAndDuty(500000, 0);
+            *   myPwm.setLoadTime(100000);
+            *
+            *   std::cout << "Pwm duty file value : " << myPwm.getDutyValue() << " nanoseconds \n";
+            *   std::cout << "Pwm load ratio      : " << myPwm.getValue() << "%";
+            *
+            * @endcode
+            * @code{.cpp}
+            *   // Possible Output:
+            *   // Pwm duty file value : 400000 nanoseconds
+            *   // Pwm load ratio      : 20%
+            * @endcode
+            *
+            * @sa setDutyPercent()
+            * @sa setLoadRatioTime()
+            * @sa setSpaceRatioTime()
+            */
+            bool            setLoadTime(uint64_t load);
+
             /*! @brief Sets period value of pwm signal.
             *
             * If input parameter's nanosecond equivalent is in range (from 0 to 10^9), this function changes period value
@@ -646,7 +1120,7 @@ namespace BlackLib
             * If input parameter's nanosecond equivalent is in range (from 0 to 10^9), this function changes duty value
             * by saving (current period value - calculated input value) to duty file. Users can select time type of entered
             * space time value like picosecond, nanosecond, microsecond, milisecond and second. This parameter's default
-            * value is nanosecond.
+            * value is nanosecond. Converted value is written with setLoadTime().
             * @param [in] load new load time
             * @param [in] tType time type of your new period value(enum)
             * @return True if setting new value is successful, else false.
@@ -677,6 +1151,44 @@ namespace BlackLib
             */
             bool            setLoadRatioTime(uint64_t load, timeType tType = nanosecond);
 
+            /*! @brief Sets period and duty values of pwm signal together.
+            *
+            * Beaglebone rejects a new period which is less than the current duty value, and a new duty
+            * value which is greater than the current period. This function finds a legal writing order
+            * from the current period and duty values, and writes only the changed values. So there is
+            * no need to set duty to zero and wait before changing the period. Both of the values must be
+            * in range (from 0 to 10^9 nanoseconds) and duty value can not be greater than period value.
+            * @param [in] period new period value
+            * @param [in] duty new duty value, like the value which is written by setSpaceRatioTime()
+            * @param [in] tType time type of your new period and duty values(enum)
+            * @return True if both of the values are set successfully, else false. If period writing
+            * fails, errorPWM::periodFileError is set; if duty writing fails, errorPWM::dutyFileError is
+            * set; if input values are invalid, errorPWM::outOfRange is set and nothing is written.
+            *
+            * @par Example
+            * @code{.cpp}
+            *   BlackLib::BlackPWM myPwm(BlackLib::P8_19);
+            *
+            *   myPwm.setPeriodAndDuty(500000, 400000);
+            *   myPwm.setPeriodAndDuty(100, 25, BlackLib::microsecond);
+            *
+            *   std::cout << "Pwm period time: " << myPwm.getPeriodValue() << " nanoseconds \n";
+            *   std::cout << "Pwm duty time  : " << myPwm.getDutyValue() << " nanoseconds \n";
+            *   std::cout << "Pwm duty ratio : " << myPwm.getValue() << "%";
+            *
+            * @endcode
+            * @code{.cpp}
+            *   // Possible Output:
+            *   // Pwm period time: 100000 nanoseconds
+            *   // Pwm duty time  : 25000 nanoseconds
+            *   // Pwm duty ratio : 75.0%
+            * @endcode
+            *
+            * @sa BlackLib::timeType
+            * @sa setSpaceRatioTime()
+            */
+            bool            setPeriodAndDuty(uint64_t period, uint64_t duty, timeType tType = nanosecond);
+
             /*! @brief Sets polarity of pwm signal.
             *
             * The input parameter is converted to 1 or 0 and this value is saved to polarity file.
@@ -789,7 +1301,7 @@ namespace BlackLib
 
             /*! @brief Checks run state of pwm signal.
             *
-            * This function calls getRunValue() function and evaluates return value.
+            * This function evaluates shadow value of run file.
             * @return True if return value equals to 1, else false.
             *
             * @par Example
@@ -815,7 +1327,7 @@ namespace BlackLib
 
             /*! @brief Checks polarity of pwm signal.
             *
-            * This function calls getPolarityValue() function and evaluates return value.
+            * This function evaluates shadow value of polarity file.
             * @return True if return value not equals to 1, else false.
             *
             * @par Example
@@ -841,7 +1353,7 @@ namespace BlackLib
 
             /*! @brief Checks polarity of pwm signal.
             *
-            * This function calls getPolarityValue() function and evaluates return value.
+            * This function evaluates shadow value of polarity file.
             * @return True if return value equals to 1, else false.
             *
             * @par Example
@@ -867,6 +1379,7 @@ namespace BlackLib
 
             /*! @brief Is used for general debugging.
             *
+            * Cape manager and ocp errors are not counted at pwmchip layout, because they are not used there.
             * @return True if any error occured, else false.
             *
             * @par Example
@@ -947,79 +1460,238 @@ namespace BlackLib
             * @sa errorPWM
             */
             bool            fail(BlackPWM::flags f);
+
+            /*! @brief Reloads shadow values from pwm files.
+            *
+            * BlackPWM holds the last known period, duty, run and polarity values in the object. Read
+            * functions return these values and set functions skip writing if new value equals to them.
+            * If something outside of this object may have changed the pwm (another process or another
+            * BlackPWM object of the same pin), this function must be called to read actual values again.
+            * @return True if all of the files are read successfully, else false.
+            *
+            * @par Example
+            * @code{.cpp}
+            *   BlackLib::BlackPWM myPwm(BlackLib::P8_19);
+            *
+            *   system("echo 0 > /sys/devices/ocp.3/pwm_test_P8_19.15/run");
+            *
+            *   myPwm.resync();
+            *   std::cout << "Run value: " << std::boolalpha << myPwm.isRunning() << std::endl;
+            * @endcode
+            * @code{.cpp}
+            *   // Possible Output:
+            *   // Run value: false
+            * @endcode
+            */
+            bool            resync();
     };
     // ########################################### BLACKPWM DECLARATION STARTS ############################################ //
 
 
-    // ######################################### BLACKCOREPWM DEFINITION STARTS ########################################## //
-    BlackCorePWM::BlackCorePWM(pwmName pwm)
-    {
-        this->pwmPinName    = pwm;
-        this->pwmCoreErrors = new errorCorePWM( this->getErrorsFromCore() );
 
-        this->loadDeviceTree();
 
-        this->pwmTestPath   = "/sys/devices/" + this->getOcpName() + "/" + this->findPwmTestName( this->pwmPinName );
-    }
 
+    // ######################################### BLACKPWMGROUP DECLARATION STARTS ######################################### //
 
-    BlackCorePWM::~BlackCorePWM()
+    /*! @brief Updates several pwm outputs together.
+     *
+     *    This class owns one BlackPWM object per member pwm and applies per tick duty and period targets
+     *    of all members in one call. It doesn't batch writes at kernel level and gives no syscall
+     *    reduction over calling the members one by one: every changed value is still one write of its
+     *    member. The group compares targets with the shadow values of the members (see
+     *    BlackPWM::resync()) and skips unchanged members without calling their setters, so a tick which
+     *    changes k of N channels costs k writes. A member whose period and duty both change is written
+     *    in the order which keeps duty legal at every write (see BlackPWM::setPeriodAndDuty()), so it
+     *    costs two writes, never more. Members can be started together with
+     *    startSynchronized(). With register backend, time base counters of the member modules are
+     *    reset back to back at start, so the outputs start in phase. With the other backends, start is
+     *    only sequential: run values are written one by one, and phases of the members differ by the
+     *    time of the writes (several microseconds each).
+     *
+     * @par Example
+     * @code{.cpp}
+     *   BlackLib::pwmName channels[3] = { BlackLib::P8_13, BlackLib::P8_19, BlackLib::P9_14 };
+     *   BlackLib::BlackPWMGroup myGroup(channels, 3);
+     *
+     *   uint64_t periods[3] = { 500000, 500000, 200000 };
+     *   uint64_t duties[3]  = { 250000, 100000,  50000 };
+     *   myGroup.setPeriodsAndDuties(periods, duties);
+     *   myGroup.startSynchronized();
+     *
+     *   float percents[3] = { 10.0, 20.0, 30.0 };
+     *   myGroup.setDutyPercents(percents);
+     * @endcode
+     */
+    class BlackPWMGroup
     {
-        delete this->pwmCoreErrors;
-    }
+        private:
+            /*!
+            * This enum is used for defining time base counter offsets, from PWMSS module base.
+            */
+            enum counterOffset {    epwmTbcnt           = 0x208,    /*!< EHRPWM time base counter */
+                                    ecapTsctr           = 0x100     /*!< eCAP time stamp counter */
+                                };
 
+            BlackPWM            *members[7];            /*!< @brief is used to hold member pwm objects */
+            unsigned int        memberCount;            /*!< @brief is used to hold number of member pwm objects */
+            BlackMemoryRegion   *modules[3];            /*!< @brief is used to hold mapped PWMSS modules which have a member (register backend) */
+            uint32_t            moduleOutputs[3];       /*!< @brief is used to hold used outputs of each module, bit 0-1: EHRPWM, bit 2: eCAP */
 
-    bool        BlackCorePWM::loadDeviceTree()
-    {
-        std::string file    = this->getSlotsFilePath();
-        std::ofstream slotsFile;
+            /*! @brief Copying is not allowed, because members are owned by the group.
+            */
+                            BlackPWMGroup(const BlackPWMGroup &);
 
-        slotsFile.open(file.c_str(), std::ios::out);
-        if(slotsFile.fail())
-        {
-            slotsFile.close();
-            this->pwmCoreErrors->dtSsError  = true;
-            this->pwmCoreErrors->dtError    = true;
-            return false;
-        }
-        else
-        {
-            slotsFile << "am33xx_pwm";
-            slotsFile.close();
-            this->pwmCoreErrors->dtSsError  = false;
-        }
+            /*! @brief Copying is not allowed, because members are owned by the group.
+            */
+            BlackPWMGroup   &operator=(const BlackPWMGroup &);
 
+        public:
+            /*! @brief Constructor of BlackPWMGroup class.
+            *
+            * This function creates one BlackPWM object for each entered pwm name. Maximum seven
+            * members can be used; the rest of the entered names are ignored. At pwmchip layout, all
+            * members are exported together before creating them. With register backend, every PWMSS
+            * module which has a member is mapped once more for startSynchronized().
+            * @param [in] pwms       pwm names (enum array)
+            * @param [in] count      number of entered pwm names
+            * @param [in] backend    hardware access way of members (enum)
+            *
+            * @sa pwmName
+            * @sa pwmBackend
+            */
+                            BlackPWMGroup(const pwmName *pwms, unsigned int count, pwmBackend backend = autoBackend);
 
-        slotsFile.open(file.c_str(), std::ios::out);
-        if(slotsFile.fail())
-        {
-            slotsFile.close();
-            this->pwmCoreErrors->dtError    = true;
-            return false;
-        }
-        else
-        {
-            slotsFile << ("bone_pwm_" + pwmNameMap[this->pwmPinName]);
-            slotsFile.close();
-            this->pwmCoreErrors->dtError    = false;
-            return true;
-        }
-    }
+            /*! @brief Destructor of BlackPWMGroup class.
+            *
+            * This function deletes member BlackPWM objects and unmaps the modules.
+            */
+            virtual         ~BlackPWMGroup();
 
-    std::string BlackCorePWM::findPwmTestName(pwmName pwm)
-    {
-        std::string searchResult = SEARCH_DIR_NOT_FOUND;
-        switch (pwm)
-        {
-            case P8_13:
-            {
-                searchResult = this->searchDirectoryOcp(BlackCore::PWM_P8_13);
-                break;
-            }
+            /*! @brief Exports number of members.
+            *
+            * @return Number of member pwm objects.
+            */
+            unsigned int    getChannelCount();
 
-            case P8_19:
-            {
-                searchResult = this->searchDirectoryOcp(BlackCore::PWM_P8_19);
+            /*! @brief Exports member pwm object.
+            *
+            * @param [in] index      member index, order of the constructor parameter. It must be smaller
+            * than getChannelCount(), it isn't checked.
+            * @return Reference of member BlackPWM object.
+            */
+            BlackPWM        &getChannel(unsigned int index);
+
+            /*! @brief Sets percentage values of duty cycles of all members.
+            *
+            * @param [in] percentages new percentage values, one for each member
+            * @return True if all of the members are set successfully, else false.
+            * @sa BlackPWM::setDutyPercent()
+            */
+            bool            setDutyPercents(const float *percentages);
+
+            /*! @brief Sets duty values of all members.
+            *
+            * @param [in] duties     new duty values, one for each member
+            * @param [in] tType      time type of your new duty values(enum)
+            * @return True if all of the members are set successfully, else false.
+            * @sa BlackPWM::setSpaceRatioTime()
+            */
+            bool            setDuties(const uint64_t *duties, timeType tType = nanosecond);
+
+            /*! @brief Sets period and duty values of all members.
+            *
+            * @param [in] periods    new period values, one for each member
+            * @param [in] duties     new duty values, one for each member
+            * @param [in] tType      time type of your new values(enum)
+            * @return True if all of the members are set successfully, else false.
+            * @sa BlackPWM::setPeriodAndDuty()
+            */
+            bool            setPeriodsAndDuties(const uint64_t *periods, const uint64_t *duties, timeType tType = nanosecond);
+
+            /*! @brief Sets run value of all members.
+            *
+            * @param [in] state      new run value(enum)
+            * @return True if all of the members are set successfully, else false.
+            * @sa BlackPWM::setRunState()
+            */
+            bool            setRunStates(runValue state);
+
+            /*! @brief Starts all members together.
+            *
+            * This function stops running members first, then writes run value to all of the members
+            * back to back. With register backend, time base counters (EHRPWM TBCNT, eCAP TSCTR) of all
+            * member modules are reset to zero with back to back stores after that, so every output
+            * starts a new period at the same time, within a few bus cycles. With the other backends
+            * start is only sequential, outputs start as close in time as sysfs allows.
+            * @return True if all of the members are started successfully, else false.
+            */
+            bool            startSynchronized();
+
+            /*! @brief Is used for general debugging.
+            *
+            * @return True if any error occured at any member, else false.
+            * @sa BlackPWM::fail()
+            */
+            bool            fail();
+    };
+    // ########################################## BLACKPWMGROUP DECLARATION ENDS ########################################## //
+
+
+    // ######################################### BLACKCOREPWM DEFINITION STARTS ########################################## //
+    BlackCorePWM::BlackCorePWM(pwmName pwm, pwmBackend backend)
+    {
+        this->pwmPinName        = pwm;
+        this->pwmCoreErrors     = new errorCorePWM( this->getErrorsFromCore() );
+        this->pwmLayout         = BlackCorePWM::selectLayout(backend);
+        this->pathGeneration    = BlackDiscoveryIndex::instance().getGeneration();
+
+        if( this->pwmLayout == pwmchipBackend )
+        {
+            this->pwmCoreErrors->pwmTestError = ! BlackCorePWM::exportPwmChannels( &(this->pwmPinName), 1 );
+            this->pwmTestPath   = BlackCorePWM::findPwmChipPath( this->pwmPinName ) + "/pwm" + tostr( pwmChipChannelMap[this->pwmPinName] );
+        }
+        else
+        {
+            this->loadDeviceTree();
+
+            this->pwmTestPath   = this->getDevicesPath() + this->getOcpName() + "/" + this->findPwmTestName( this->pwmPinName );
+        }
+    }
+
+
+    BlackCorePWM::~BlackCorePWM()
+    {
+        delete this->pwmCoreErrors;
+    }
+
+
+    bool        BlackCorePWM::loadDeviceTree()
+    {
+        this->pwmCoreErrors->dtSsError  = ! this->loadOverlay("am33xx_pwm");
+        if( this->pwmCoreErrors->dtSsError )
+        {
+            this->pwmCoreErrors->dtError    = true;
+            return false;
+        }
+
+        this->pwmCoreErrors->dtError    = ! this->loadOverlay("bone_pwm_" + pwmNameMap[this->pwmPinName]);
+        return ( ! this->pwmCoreErrors->dtError );
+    }
+
+    std::string BlackCorePWM::findPwmTestName(pwmName pwm)
+    {
+        std::string searchResult = SEARCH_DIR_NOT_FOUND;
+        switch (pwm)
+        {
+            case P8_13:
+            {
+                searchResult = this->searchDirectoryOcp(BlackCore::PWM_P8_13);
+                break;
+            }
+
+            case P8_19:
+            {
+                searchResult = this->searchDirectoryOcp(BlackCore::PWM_P8_19);
                 break;
             }
 
@@ -1069,6 +1741,180 @@ namespace BlackLib
 
 
 
+    bool        BlackCorePWM::hasEntry(const std::string &searchIn, const std::string &prefix)
+    {
+        DIR *path = opendir(searchIn.c_str());
+        if( path == NULL )
+        {
+            return false;
+        }
+
+        bool isFound = false;
+        dirent *entry;
+        while( (entry = readdir(path)) != NULL )
+        {
+            if( strncmp(entry->d_name, prefix.c_str(), prefix.size()) == 0 )
+            {
+                isFound = true;
+                break;
+            }
+        }
+
+        closedir(path);
+        return isFound;
+    }
+
+    std::string BlackCorePWM::findPwmChipPath(pwmName pwm)
+    {
+        static std::string chipPaths[7];
+        static std::mutex  chipPathMutex;
+
+        // objects can be constructed from several threads, the scan fills the cache under the lock
+        std::lock_guard<std::mutex> lock(chipPathMutex);
+
+        if( ! chipPaths[pwm].empty() )
+        {
+            return chipPaths[pwm];
+        }
+
+        // EHRPWM block is at module + 0x200, eCAP block is at module + 0x100
+        char deviceName[16];
+        uint32_t blockAddress = pwmModuleAddressMap[pwm] + ((pwmChannelMap[pwm] == 2) ? 0x100 : 0x200);
+        snprintf(deviceName, sizeof(deviceName), "/%08x.", blockAddress);
+
+        std::string classPath = BlackCore::getFilesystemRoot() + "/sys/class/pwm/";
+        DIR *path = opendir(classPath.c_str());
+        if( path == NULL )
+        {
+            return SEARCH_DIR_NOT_FOUND;
+        }
+
+        dirent *entry;
+        while( (entry = readdir(path)) != NULL )
+        {
+            if( strncmp(entry->d_name, "pwmchip", 7) != 0 )
+            {
+                continue;
+            }
+
+            char linkTarget[512];
+            ssize_t linkSize = readlink((classPath + entry->d_name).c_str(), linkTarget, sizeof(linkTarget)-1);
+            if( linkSize <= 0 )
+            {
+                continue;
+            }
+
+            linkTarget[linkSize] = '\0';
+            if( strstr(linkTarget, deviceName) != NULL )
+            {
+                chipPaths[pwm] = classPath + entry->d_name;
+                break;
+            }
+        }
+
+        closedir(path);
+        return (chipPaths[pwm].empty() ? SEARCH_DIR_NOT_FOUND : chipPaths[pwm]);
+    }
+
+    pwmBackend  BlackCorePWM::selectLayout(pwmBackend backend)
+    {
+        if( backend == sysfsBackend or backend == pwmchipBackend )
+        {
+            return backend;
+        }
+
+        static pwmBackend detectedLayout = autoBackend;
+        static std::mutex layoutMutex;
+
+        std::lock_guard<std::mutex> lock(layoutMutex);
+
+        if( detectedLayout == autoBackend )
+        {
+            std::string root = BlackCore::getFilesystemRoot();
+
+            if( ! BlackCorePWM::hasEntry(root + "/sys/devices/", "bone_capemgr.") and
+                  BlackCorePWM::hasEntry(root + "/sys/class/pwm/", "pwmchip") )
+            {
+                detectedLayout = pwmchipBackend;
+            }
+            else
+            {
+                detectedLayout = sysfsBackend;
+            }
+        }
+
+        return detectedLayout;
+    }
+
+    bool        BlackCorePWM::exportPwmChannels(const pwmName *pwms, unsigned int count)
+    {
+        bool isExported[7]  = { false, false, false, false, false, false, false };
+        bool isSuccess      = true;
+
+        for( unsigned int i = 0 ; i < count ; i++ )
+        {
+            if( isExported[ pwms[i] ] )
+            {
+                continue;
+            }
+
+            std::string chipPath = BlackCorePWM::findPwmChipPath(pwms[i]);
+            if( chipPath == SEARCH_DIR_NOT_FOUND )
+            {
+                isSuccess = false;
+                continue;
+            }
+
+            // one export descriptor for all of the pwms of this chip
+            int exportFd = -1;
+            for( unsigned int j = i ; j < count ; j++ )
+            {
+                if( isExported[ pwms[j] ] or BlackCorePWM::findPwmChipPath(pwms[j]) != chipPath )
+                {
+                    continue;
+                }
+
+                isExported[ pwms[j] ] = true;
+
+                std::string channel     = tostr( pwmChipChannelMap[ pwms[j] ] );
+                std::string channelPath = chipPath + "/pwm" + channel;
+                if( ::access(channelPath.c_str(), F_OK) == 0 )
+                {
+                    continue;
+                }
+
+                if( exportFd < 0 )
+                {
+                    exportFd = ::open((chipPath + "/export").c_str(), O_WRONLY);
+                }
+
+                if( exportFd < 0 )
+                {
+                    isSuccess = false;
+                    continue;
+                }
+
+                // EBUSY means the pwm is exported by someone else after the access() check
+                channel += "\n";
+                ssize_t writtenSize = ::write(exportFd, channel.c_str(), channel.size());
+                bool    isWritten   = (writtenSize == static_cast<ssize_t>(channel.size())) or (writtenSize < 0 and errno == EBUSY);
+                if( ! isWritten or ::access(channelPath.c_str(), F_OK) != 0 )
+                {
+                    isSuccess = false;
+                }
+            }
+
+            if( exportFd >= 0 )
+            {
+                ::close(exportFd);
+            }
+        }
+
+        return isSuccess;
+    }
+
+
+
     std::string BlackCorePWM::getPeriodFilePath()
     {
         return (this->pwmTestPath + "/period");
@@ -1076,12 +1922,12 @@ namespace BlackLib
 
     std::string BlackCorePWM::getDutyFilePath()
     {
-        return (this->pwmTestPath + "/duty");
+        return (this->pwmTestPath + ((this->pwmLayout == pwmchipBackend) ? "/duty_cycle" : "/duty"));
     }
 
     std::string BlackCorePWM::getRunFilePath()
     {
-        return (this->pwmTestPath + "/run");
+        return (this->pwmTestPath + ((this->pwmLayout == pwmchipBackend) ? "/enable" : "/run"));
     }
 
     std::string BlackCorePWM::getPolarityFilePath()
@@ -1093,7 +1939,460 @@ namespace BlackLib
     {
         return (this->pwmCoreErrors);
     }
-    // ########################################## BLACKCOREPWM DEFINITION ENDS ########################################### //
+
+    pwmBackend  BlackCorePWM::getLayout()
+    {
+        return (this->pwmLayout);
+    }
+
+    bool        BlackCorePWM::updatePwmTestPath()
+    {
+        uint64_t generation = BlackDiscoveryIndex::instance().getGeneration();
+        if( generation == this->pathGeneration )
+        {
+            return false;
+        }
+
+        this->pathGeneration = generation;
+        if( this->pwmLayout == pwmchipBackend )
+        {
+            return false;
+        }
+
+        std::string newPath = this->getDevicesPath() + this->getOcpName() + "/" + this->findPwmTestName( this->pwmPinName );
+        if( newPath == this->pwmTestPath )
+        {
+            return false;
+        }
+
+        this->pwmTestPath = newPath;
+        return true;
+    }
+    // ########################################## BLACKCOREPWM DEFINITION ENDS ########################################### //
+
+
+
+
+    // ######################################### BLACKPWMBACKEND DEFINITION STARTS ######################################## //
+    BlackPWMSysfsBackend::BlackPWMSysfsBackend(const std::string &periodPath, const std::string &dutyPath,
+                                               const std::string &runPath, const std::string &polarityPath)
+    {
+        this->paths[periodAttribute]    = periodPath;
+        this->paths[dutyAttribute]      = dutyPath;
+        this->paths[runAttribute]       = runPath;
+        this->paths[polarityAttribute]  = polarityPath;
+
+        for( int i = 0 ; i < 4 ; i++ )
+        {
+            this->fds[i] = ::open(this->paths[i].c_str(), O_RDWR);
+        }
+    }
+
+    BlackPWMSysfsBackend::~BlackPWMSysfsBackend()
+    {
+        for( int i = 0 ; i < 4 ; i++ )
+        {
+            if( this->fds[i] >= 0 )
+            {
+                ::close(this->fds[i]);
+            }
+        }
+    }
+
+    bool        BlackPWMSysfsBackend::openAttribute(attribute attr)
+    {
+        if( this->fds[attr] < 0 )
+        {
+            this->fds[attr] = ::open(this->paths[attr].c_str(), O_RDWR);
+        }
+        return (this->fds[attr] >= 0);
+    }
+
+    bool        BlackPWMSysfsBackend::readAttribute(attribute attr, int64_t &value)
+    {
+        if( ! this->openAttribute(attr) )
+        {
+            return false;
+        }
+
+        char buffer[32];
+        ssize_t readSize = ::pread(this->fds[attr], buffer, sizeof(buffer)-1, 0);
+        if( readSize <= 0 )
+        {
+            return false;
+        }
+
+        buffer[readSize] = '\0';
+        value = static_cast<int64_t>( strtoll(buffer, NULL, 10) );
+        return true;
+    }
+
+    bool        BlackPWMSysfsBackend::writeAttribute(attribute attr, int64_t value)
+    {
+        if( ! this->openAttribute(attr) )
+        {
+            return false;
+        }
+
+        // digits are filled from the end of buffer, trailing new line makes the value look like
+        // "echo value > file" and terminates the number for readers of regular (stand-in) files.
+        char buffer[24];
+        char *cursor        = buffer + sizeof(buffer);
+        bool isNegative     = (value < 0);
+        uint64_t magnitude  = isNegative ? (0 - static_cast<uint64_t>(value)) : static_cast<uint64_t>(value);
+
+        *--cursor = '\n';
+        do
+        {
+            *--cursor = static_cast<char>('0' + (magnitude % 10));
+            magnitude /= 10;
+        } while( magnitude != 0 );
+
+        if( isNegative )
+        {
+            *--cursor = '-';
+        }
+
+        size_t writeSize = static_cast<size_t>( (buffer + sizeof(buffer)) - cursor );
+        return ( ::pwrite(this->fds[attr], cursor, writeSize, 0) == static_cast<ssize_t>(writeSize) );
+    }
+
+
+
+
+    BlackPWMChipBackend::BlackPWMChipBackend(const std::string &periodPath, const std::string &dutyPath,
+                                             const std::string &runPath, const std::string &polarityPath)
+        : BlackPWMSysfsBackend(periodPath, dutyPath, runPath, polarityPath)
+    {
+    }
+
+    bool        BlackPWMChipBackend::readAttribute(attribute attr, int64_t &value)
+    {
+        if( attr != polarityAttribute )
+        {
+            return BlackPWMSysfsBackend::readAttribute(attr, value);
+        }
+
+        if( ! this->openAttribute(attr) )
+        {
+            return false;
+        }
+
+        char buffer[16];
+        ssize_t readSize = ::pread(this->fds[attr], buffer, sizeof(buffer)-1, 0);
+        if( readSize <= 0 )
+        {
+            return false;
+        }
+
+        buffer[readSize] = '\0';
+        if( strncmp(buffer, "inversed", 8) == 0 )
+        {
+            value = static_cast<int64_t>(straight);
+        }
+        else if( strncmp(buffer, "normal", 6) == 0 )
+        {
+            value = static_cast<int64_t>(reverse);
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    bool        BlackPWMChipBackend::writeAttribute(attribute attr, int64_t value)
+    {
+        if( attr != polarityAttribute )
+        {
+            return BlackPWMSysfsBackend::writeAttribute(attr, value);
+        }
+
+        if( ! this->openAttribute(attr) )
+        {
+            return false;
+        }
+
+        const char *text    = (value == straight) ? "inversed\n" : "normal\n";
+        size_t writeSize    = strlen(text);
+        return ( ::pwrite(this->fds[attr], text, writeSize, 0) == static_cast<ssize_t>(writeSize) );
+    }
+
+
+
+
+    BlackPWMRegisterBackend::BlackPWMRegisterBackend(pwmName pwm)
+    {
+        this->channel   = pwmChannelMap[pwm];
+        this->region    = new BlackMemoryRegion(pwmModuleAddressMap[pwm], 0x1000);
+
+        if( ! this->region->isMapped() )
+        {
+            return;
+        }
+
+        if( this->channel == 2 )
+        {
+            *this->region->register32(pwmssClockConfig) |= 0x0001;                     // ECAPCLK_EN
+
+            volatile uint16_t *ecctl2 = this->region->register16(ecapBlock + ecapEcctl2);
+            *ecctl2 |= 0x0200;                                                          // CAP_APWM
+        }
+        else
+        {
+            *this->region->register32(pwmssClockConfig) |= 0x0100;                     // EPWMCLK_EN
+
+            // continuous software force is loaded immediately, not at next period.
+            *this->region->register16(epwmBlock + epwmAqsfrc) |= 0x00C0;               // RLDCSF = 3
+
+            volatile uint16_t *aqctl = this->region->register16(epwmBlock + ((this->channel == 0) ? epwmAqctla : epwmAqctlb));
+            if( *aqctl == 0 )
+            {
+                *aqctl = (this->channel == 0) ? 0x0012 : 0x0102;                        // set at zero, clear at compare
+            }
+        }
+    }
+
+    BlackPWMRegisterBackend::~BlackPWMRegisterBackend()
+    {
+        delete this->region;
+    }
+
+    uint32_t    BlackPWMRegisterBackend::epwmPrescaler(uint16_t tbctl)
+    {
+        uint32_t clockDivider   = 1u << ((tbctl >> 10) & 0x7);
+        uint32_t highSpeedBits  = (tbctl >> 7) & 0x7;
+        uint32_t highSpeedDiv   = (highSpeedBits == 0) ? 1 : (2 * highSpeedBits);
+
+        return clockDivider * highSpeedDiv;
+    }
+
+    int64_t     BlackPWMRegisterBackend::readPeriod()
+    {
+        if( this->channel == 2 )
+        {
+            uint32_t cap1 = *this->region->register32(ecapBlock + ecapCap1);
+            return (cap1 == 0) ? 0 : (static_cast<int64_t>(cap1) + 1) * 10;
+        }
+
+        uint16_t tbprd = *this->region->register16(epwmBlock + epwmTbprd);
+        uint16_t tbctl = *this->region->register16(epwmBlock + epwmTbctl);
+        return (tbprd == 0) ? 0 : (static_cast<int64_t>(tbprd) + 1) * this->epwmPrescaler(tbctl) * 10;
+    }
+
+    int64_t     BlackPWMRegisterBackend::readDuty(unsigned int output)
+    {
+        int64_t period = this->readPeriod();
+        int64_t loadTime;
+
+        if( output == 2 )
+        {
+            loadTime = static_cast<int64_t>(*this->region->register32(ecapBlock + ecapCap2)) * 10;
+        }
+        else
+        {
+            uint16_t tbctl  = *this->region->register16(epwmBlock + epwmTbctl);
+            uint16_t cmp    = *this->region->register16(epwmBlock + ((output == 0) ? epwmCmpa : epwmCmpb));
+            loadTime        = static_cast<int64_t>(cmp) * this->epwmPrescaler(tbctl) * 10;
+        }
+
+        return (loadTime >= period) ? 0 : (period - loadTime);
+    }
+
+    void        BlackPWMRegisterBackend::writeDuty(unsigned int output, int64_t period, int64_t duty)
+    {
+        int64_t loadTime = (duty >= period) ? 0 : (period - duty);
+
+        if( output == 2 )
+        {
+            *this->region->register32(ecapBlock + ecapCap2) = static_cast<uint32_t>(loadTime / 10);
+        }
+        else
+        {
+            uint16_t tbctl      = *this->region->register16(epwmBlock + epwmTbctl);
+            int64_t loadTicks   = loadTime / (10 * static_cast<int64_t>(this->epwmPrescaler(tbctl)));
+            *this->region->register16(epwmBlock + ((output == 0) ? epwmCmpa : epwmCmpb)) =
+                    static_cast<uint16_t>( (loadTicks > 0xFFFF) ? 0xFFFF : loadTicks );
+        }
+    }
+
+    void        BlackPWMRegisterBackend::writePeriod(int64_t period)
+    {
+        int64_t ticks = period / 10;
+
+        if( this->channel == 2 )
+        {
+            int64_t duty = this->readDuty(2);
+            *this->region->register32(ecapBlock + ecapCap1) = (ticks == 0) ? 0 : static_cast<uint32_t>(ticks - 1);
+            this->writeDuty(2, period, duty);
+            return;
+        }
+
+        // smallest prescaler which keeps the period in 16 bit TBPRD is selected.
+        uint32_t bestPrescaler  = 0;
+        uint16_t bestBits       = 0;
+        for( uint16_t clockBits = 0 ; clockBits < 8 ; clockBits++ )
+        {
+            for( uint16_t highSpeedBits = 0 ; highSpeedBits < 8 ; highSpeedBits++ )
+            {
+                uint16_t bits       = static_cast<uint16_t>((clockBits << 10) | (highSpeedBits << 7));
+                uint32_t prescaler  = this->epwmPrescaler(bits);
+                if( ticks / prescaler <= 0x10000 and (bestPrescaler == 0 or prescaler < bestPrescaler) )
+                {
+                    bestPrescaler   = prescaler;
+                    bestBits        = bits;
+                }
+            }
+        }
+
+        // both outputs share the time base, so their duty values are kept with the new prescaler.
+        int64_t dutyA = this->readDuty(0);
+        int64_t dutyB = this->readDuty(1);
+
+        volatile uint16_t *tbctl = this->region->register16(epwmBlock + epwmTbctl);
+        int64_t periodTicks = ticks / bestPrescaler;
+
+        *tbctl = static_cast<uint16_t>((*tbctl & ~0x1F80) | bestBits);
+        *this->region->register16(epwmBlock + epwmTbprd) = (periodTicks == 0) ? 0 : static_cast<uint16_t>(periodTicks - 1);
+
+        this->writeDuty(0, period, dutyA);
+        this->writeDuty(1, period, dutyB);
+    }
+
+    bool        BlackPWMRegisterBackend::readAttribute(attribute attr, int64_t &value)
+    {
+        if( ! this->region->isMapped() )
+        {
+            return false;
+        }
+
+        switch( attr )
+        {
+            case periodAttribute:
+            {
+                value = this->readPeriod();
+                break;
+            }
+
+            case dutyAttribute:
+            {
+                value = this->readDuty(this->channel);
+                break;
+            }
+
+            case runAttribute:
+            {
+                if( this->channel == 2 )
+                {
+                    value = ((*this->region->register16(ecapBlock + ecapEcctl2) & 0x0010) != 0) ? 1 : 0;
+                }
+                else
+                {
+                    uint16_t tbctl  = *this->region->register16(epwmBlock + epwmTbctl);
+                    uint16_t force  = *this->region->register16(epwmBlock + epwmAqcsfrc);
+                    bool isForced   = ((force >> (this->channel * 2)) & 0x3) != 0;
+                    value = ((tbctl & 0x3) != 0x3 and ! isForced) ? 1 : 0;
+                }
+                break;
+            }
+
+            case polarityAttribute:
+            {
+                if( this->channel == 2 )
+                {
+                    value = ((*this->region->register16(ecapBlock + ecapEcctl2) & 0x0400) != 0) ? 1 : 0;
+                }
+                else
+                {
+                    uint16_t aqctl = *this->region->register16(epwmBlock + ((this->channel == 0) ? epwmAqctla : epwmAqctlb));
+                    value = ((aqctl & 0x3) == 0x1) ? 1 : 0;                             // clear at zero
+                }
+                break;
+            }
+        }
+
+        return true;
+    }
+
+    bool        BlackPWMRegisterBackend::writeAttribute(attribute attr, int64_t value)
+    {
+        if( ! this->region->isMapped() )
+        {
+            return false;
+        }
+
+        switch( attr )
+        {
+            case periodAttribute:
+            {
+                if( value < this->readDuty(this->channel) or value > static_cast<int64_t>(PWM_MAX_NANOSECOND) )
+                {
+                    return false;
+                }
+                this->writePeriod(value);
+                break;
+            }
+
+            case dutyAttribute:
+            {
+                int64_t period = this->readPeriod();
+                if( value < 0 or value > period )
+                {
+                    return false;
+                }
+                this->writeDuty(this->channel, period, value);
+                break;
+            }
+
+            case runAttribute:
+            {
+                if( this->channel == 2 )
+                {
+                    volatile uint16_t *ecctl2 = this->region->register16(ecapBlock + ecapEcctl2);
+                    *ecctl2 = static_cast<uint16_t>( (value != 0) ? (*ecctl2 | 0x0010) : (*ecctl2 & ~0x0010) );
+                }
+                else
+                {
+                    volatile uint16_t *force    = this->region->register16(epwmBlock + epwmAqcsfrc);
+                    volatile uint16_t *aqctl    = this->region->register16(epwmBlock + ((this->channel == 0) ? epwmAqctla : epwmAqctlb));
+                    uint16_t shift              = static_cast<uint16_t>(this->channel * 2);
+                    uint16_t inactiveLevel      = ((*aqctl & 0x3) == 0x1) ? 0x2 : 0x1;  // reverse: force high, straight: force low
+
+                    if( value != 0 )
+                    {
+                        *force = static_cast<uint16_t>(*force & ~(0x3 << shift));
+
+                        volatile uint16_t *tbctl = this->region->register16(epwmBlock + epwmTbctl);
+                        *tbctl = static_cast<uint16_t>((*tbctl & ~0x0003) | 0xC000);     // up count, free run
+                    }
+                    else
+                    {
+                        *force = static_cast<uint16_t>((*force & ~(0x3 << shift)) | (inactiveLevel << shift));
+                    }
+                }
+                break;
+            }
+
+            case polarityAttribute:
+            {
+                if( this->channel == 2 )
+                {
+                    volatile uint16_t *ecctl2 = this->region->register16(ecapBlock + ecapEcctl2);
+                    *ecctl2 = static_cast<uint16_t>( (value != 0) ? (*ecctl2 | 0x0400) : (*ecctl2 & ~0x0400) );
+                }
+                else
+                {
+                    volatile uint16_t *aqctl = this->region->register16(epwmBlock + ((this->channel == 0) ? epwmAqctla : epwmAqctlb));
+                    if( this->channel == 0 )    { *aqctl = (value != 0) ? 0x0021 : 0x0012; }
+                    else                        { *aqctl = (value != 0) ? 0x0201 : 0x0102; }
+                }
+                break;
+            }
+        }
+
+        return true;
+    }
+    // ########################################## BLACKPWMBACKEND DEFINITION ENDS ######################################### //
 
 
 
@@ -1107,7 +2406,7 @@ namespace BlackLib
 
 
     // ########################################### BLACKPWM DEFINITION STARTS ############################################ //
-    BlackPWM::BlackPWM(pwmName pwm) : BlackCorePWM(pwm)
+    BlackPWM::BlackPWM(pwmName pwm, pwmBackend backend) : BlackCorePWM(pwm, backend)
     {
         this->pwmErrors     = new errorPWM( this->getErrorsFromCorePWM() );
 
@@ -1115,13 +2414,108 @@ namespace BlackLib
         this->dutyPath      = this->getDutyFilePath();
         this->runPath       = this->getRunFilePath();
         this->polarityPath  = this->getPolarityFilePath();
+
+        if( backend == registerBackend )
+        {
+            this->backendType   = registerBackend;
+            this->backend       = new BlackPWMRegisterBackend(pwm);
+        }
+        else if( this->getLayout() == pwmchipBackend )
+        {
+            this->backendType   = pwmchipBackend;
+            this->backend       = new BlackPWMChipBackend(this->periodPath, this->dutyPath, this->runPath, this->polarityPath);
+        }
+        else
+        {
+            this->backendType   = sysfsBackend;
+            this->backend       = new BlackPWMSysfsBackend(this->periodPath, this->dutyPath, this->runPath, this->polarityPath);
+        }
+
+        this->resync();
     }
 
     BlackPWM::~BlackPWM()
     {
+        delete this->backend;
         delete this->pwmErrors;
     }
 
+    bool        BlackPWM::fetchAttribute(BlackPWMBackend::attribute attr, int64_t &shadow)
+    {
+        if( shadow != FILE_COULD_NOT_OPEN_INT )
+        {
+            return true;
+        }
+
+        this->checkPaths();
+
+        int64_t readValue;
+        if( ! this->backend->readAttribute(attr, readValue) )
+        {
+            return false;
+        }
+
+        shadow = readValue;
+        return true;
+    }
+
+    bool        BlackPWM::storeAttribute(BlackPWMBackend::attribute attr, int64_t &shadow, int64_t value)
+    {
+        if( shadow == value )
+        {
+            return true;
+        }
+
+        this->checkPaths();
+
+        if( ! this->backend->writeAttribute(attr, value) )
+        {
+            return false;
+        }
+
+        shadow = value;
+        return true;
+    }
+
+    void        BlackPWM::checkPaths()
+    {
+        if( this->backendType != sysfsBackend or ! this->updatePwmTestPath() )
+        {
+            return;
+        }
+
+        this->periodPath    = this->getPeriodFilePath();
+        this->dutyPath      = this->getDutyFilePath();
+        this->runPath       = this->getRunFilePath();
+        this->polarityPath  = this->getPolarityFilePath();
+
+        delete this->backend;
+        this->backend       = new BlackPWMSysfsBackend(this->periodPath, this->dutyPath, this->runPath, this->polarityPath);
+
+        this->periodShadow      = FILE_COULD_NOT_OPEN_INT;
+        this->dutyShadow        = FILE_COULD_NOT_OPEN_INT;
+        this->runShadow         = FILE_COULD_NOT_OPEN_INT;
+        this->polarityShadow    = FILE_COULD_NOT_OPEN_INT;
+    }
+
+    bool        BlackPWM::resync()
+    {
+        this->periodShadow      = FILE_COULD_NOT_OPEN_INT;
+        this->dutyShadow        = FILE_COULD_NOT_OPEN_INT;
+        this->runShadow         = FILE_COULD_NOT_OPEN_INT;
+        this->polarityShadow    = FILE_COULD_NOT_OPEN_INT;
+
+        this->pwmErrors->periodFileError    = ! this->fetchAttribute(BlackPWMBackend::periodAttribute, this->periodShadow);
+        this->pwmErrors->dutyFileError      = ! this->fetchAttribute(BlackPWMBackend::dutyAttribute, this->dutyShadow);
+        this->pwmErrors->runFileError       = ! this->fetchAttribute(BlackPWMBackend::runAttribute, this->runShadow);
+        this->pwmErrors->polarityFileError  = ! this->fetchAttribute(BlackPWMBackend::polarityAttribute, this->polarityShadow);
+
+        return !(this->pwmErrors->periodFileError or
+                 this->pwmErrors->dutyFileError or
+                 this->pwmErrors->runFileError or
+                 this->pwmErrors->polarityFileError);
+    }
+
     std::string BlackPWM::getValue()
     {
         double period   = static_cast<long double>( this->getNumericPeriodValue() );
@@ -1132,90 +2526,50 @@ namespace BlackLib
 
     std::string BlackPWM::getPeriodValue()
     {
-        std::ifstream periodValueFile;
-
-        periodValueFile.open(this->periodPath.c_str(),std::ios::in);
-        if(periodValueFile.fail())
+        if( ! this->fetchAttribute(BlackPWMBackend::periodAttribute, this->periodShadow) )
         {
-            periodValueFile.close();
             this->pwmErrors->periodFileError = true;
             return FILE_COULD_NOT_OPEN_STRING;
         }
-        else
-        {
-            std::string readValue;
-            periodValueFile >> readValue;
 
-            periodValueFile.close();
-            this->pwmErrors->periodFileError = false;
-            return readValue;
-        }
+        this->pwmErrors->periodFileError = false;
+        return tostr(this->periodShadow);
     }
 
     std::string BlackPWM::getDutyValue()
     {
-        std::ifstream dutyValueFile;
-
-        dutyValueFile.open(this->dutyPath.c_str(),std::ios::in);
-        if(dutyValueFile.fail())
+        if( ! this->fetchAttribute(BlackPWMBackend::dutyAttribute, this->dutyShadow) )
         {
-            dutyValueFile.close();
             this->pwmErrors->dutyFileError = true;
             return FILE_COULD_NOT_OPEN_STRING;
         }
-        else
-        {
-            std::string readValue;
-            dutyValueFile >> readValue;
 
-            dutyValueFile.close();
-            this->pwmErrors->dutyFileError = false;
-            return readValue;
-        }
+        this->pwmErrors->dutyFileError = false;
+        return tostr(this->dutyShadow);
     }
 
     std::string BlackPWM::getRunValue()
     {
-        std::ifstream runValueFile;
-
-        runValueFile.open(this->runPath.c_str(),std::ios::in);
-        if(runValueFile.fail())
+        if( ! this->fetchAttribute(BlackPWMBackend::runAttribute, this->runShadow) )
         {
-            runValueFile.close();
             this->pwmErrors->runFileError = true;
             return FILE_COULD_NOT_OPEN_STRING;
         }
-        else
-        {
-            std::string readValue;
-            runValueFile >> readValue;
 
-            runValueFile.close();
-            this->pwmErrors->runFileError = false;
-            return readValue;
-        }
+        this->pwmErrors->runFileError = false;
+        return tostr(this->runShadow);
     }
 
     std::string BlackPWM::getPolarityValue()
     {
-        std::ifstream polarityValueFile;
-
-        polarityValueFile.open(this->polarityPath.c_str(),std::ios::in);
-        if(polarityValueFile.fail())
+        if( ! this->fetchAttribute(BlackPWMBackend::polarityAttribute, this->polarityShadow) )
         {
-            polarityValueFile.close();
             this->pwmErrors->polarityFileError = true;
             return FILE_COULD_NOT_OPEN_STRING;
         }
-        else
-        {
-            std::string readValue;
-            polarityValueFile >> readValue;
 
-            polarityValueFile.close();
-            this->pwmErrors->polarityFileError = false;
-            return readValue;
-        }
+        this->pwmErrors->polarityFileError = false;
+        return tostr(this->polarityShadow);
     }
 
     float       BlackPWM::getNumericValue()
@@ -1228,45 +2582,26 @@ namespace BlackLib
 
     inline int64_t    BlackPWM::getNumericPeriodValue()
     {
-        int64_t readValue = FILE_COULD_NOT_OPEN_INT;
-
-        std::ifstream periodValueFile;
-
-        periodValueFile.open(this->periodPath.c_str(),std::ios::in);
-        if(periodValueFile.fail())
+        if( ! this->fetchAttribute(BlackPWMBackend::periodAttribute, this->periodShadow) )
         {
-            periodValueFile.close();
             this->pwmErrors->periodFileError = true;
+            return FILE_COULD_NOT_OPEN_INT;
         }
-        else
-        {
-            periodValueFile >> readValue;
 
-            periodValueFile.close();
-            this->pwmErrors->periodFileError = false;
-        }
-        return readValue;
+        this->pwmErrors->periodFileError = false;
+        return this->periodShadow;
     }
 
     inline int64_t    BlackPWM::getNumericDutyValue()
     {
-        int64_t readValue = FILE_COULD_NOT_OPEN_INT;
-        std::ifstream dutyValueFile;
-
-        dutyValueFile.open(this->dutyPath.c_str(),std::ios::in);
-        if(dutyValueFile.fail())
+        if( ! this->fetchAttribute(BlackPWMBackend::dutyAttribute, this->dutyShadow) )
         {
-            dutyValueFile.close();
             this->pwmErrors->dutyFileError = true;
+            return FILE_COULD_NOT_OPEN_INT;
         }
-        else
-        {
-            dutyValueFile >> readValue;
 
-            dutyValueFile.close();
-            this->pwmErrors->dutyFileError = false;
-        }
-        return readValue;
+        this->pwmErrors->dutyFileError = false;
+        return this->dutyShadow;
     }
 
 
@@ -1282,29 +2617,50 @@ namespace BlackLib
 
         this->pwmErrors->outOfRange = false;
 
-        std::ofstream dutyFile;
-        dutyFile.open(this->dutyPath.c_str(),std::ios::out);
-        if(dutyFile.fail())
+        int64_t period = this->getNumericPeriodValue();
+        if( this->pwmErrors->periodFileError )
         {
-            dutyFile.close();
-            this->pwmErrors->dutyFileError = true;
             return false;
         }
-        else
+
+        // percentage is converted to parts per million once, the rest is exact integer math.
+        uint64_t loadPpm    = static_cast<uint64_t>(percantage * 10000.0f + 0.5f);
+        uint64_t load       = (static_cast<uint64_t>(period) * loadPpm + 500000) / 1000000;
+
+        return this->setLoadTime(load);
+    }
+
+    bool        BlackPWM::setLoadTime(uint64_t load)
+    {
+        int64_t period = this->getNumericPeriodValue();
+        if( this->pwmErrors->periodFileError )
         {
-            dutyFile << static_cast<int64_t>(round((this->getNumericPeriodValue()) * (1.0 - (percantage/100))));
-            dutyFile.close();
-            this->pwmErrors->dutyFileError = false;
-            return true;
+            return false;
+        }
+
+        if( load > static_cast<uint64_t>(period) )
+        {
+            this->pwmErrors->outOfRange = true;
+            return false;
         }
 
+        this->pwmErrors->outOfRange = false;
+
+        if( ! this->storeAttribute(BlackPWMBackend::dutyAttribute, this->dutyShadow, period - static_cast<int64_t>(load)) )
+        {
+            this->pwmErrors->dutyFileError = true;
+            return false;
+        }
+
+        this->pwmErrors->dutyFileError = false;
+        return true;
     }
 
     bool        BlackPWM::setPeriodTime(uint64_t period, timeType tType)
     {
-        uint64_t writeThis = static_cast<uint64_t>(period * static_cast<double>(pow( 10, static_cast<int>(tType)+9) ));
+        uint64_t writeThis;
 
-        if( writeThis > 1000000000)
+        if( ! convertToNanosecond(period, tType, writeThis) or writeThis > PWM_MAX_NANOSECOND )
         {
             this->pwmErrors->outOfRange = true;
             return false;
@@ -1312,143 +2668,159 @@ namespace BlackLib
         else
         {
             this->pwmErrors->outOfRange = false;
-            std::ofstream periodFile;
-            periodFile.open(this->periodPath.c_str(),std::ios::out);
-            if(periodFile.fail())
+
+            if( ! this->storeAttribute(BlackPWMBackend::periodAttribute, this->periodShadow, static_cast<int64_t>(writeThis)) )
             {
-                periodFile.close();
                 this->pwmErrors->periodFileError = true;
                 return false;
             }
-            else
-            {
-                periodFile << writeThis;
-                periodFile.close();
-                this->pwmErrors->periodFileError = false;
-                return true;
-            }
+
+            this->pwmErrors->periodFileError = false;
+            return true;
         }
 
     }
 
     bool        BlackPWM::setSpaceRatioTime(uint64_t space, timeType tType)
     {
-        uint64_t writeThis = static_cast<int64_t>(space * static_cast<double>(pow( 10, static_cast<int>(tType)+9) ));
+        uint64_t writeThis;
 
-        if( writeThis > 1000000000)
+        if( ! convertToNanosecond(space, tType, writeThis) or writeThis > PWM_MAX_NANOSECOND )
         {
             this->pwmErrors->outOfRange = true;
             return false;
         }
         else
         {
-            std::ofstream dutyFile;
-            dutyFile.open(this->dutyPath.c_str(),std::ios::out);
-            if(dutyFile.fail())
+            this->pwmErrors->outOfRange = false;
+
+            if( ! this->storeAttribute(BlackPWMBackend::dutyAttribute, this->dutyShadow, static_cast<int64_t>(writeThis)) )
             {
-                dutyFile.close();
                 this->pwmErrors->dutyFileError = true;
                 return false;
             }
-            else
-            {
-                dutyFile << writeThis;
-                dutyFile.close();
-                this->pwmErrors->dutyFileError = false;
-                return true;
-            }
+
+            this->pwmErrors->dutyFileError = false;
+            return true;
         }
     }
 
     bool        BlackPWM::setLoadRatioTime(uint64_t load, timeType tType)
     {
-        uint64_t writeThis = (this->getNumericPeriodValue() - static_cast<int64_t>(load * static_cast<double>(pow( 10, static_cast<int>(tType)+9) )));
+        uint64_t loadTime;
 
-        if( writeThis > 1000000000)
+        if( ! convertToNanosecond(load, tType, loadTime) )
         {
             this->pwmErrors->outOfRange = true;
             return false;
         }
-        else
+
+        return this->setLoadTime(loadTime);
+    }
+
+    bool        BlackPWM::setPeriodAndDuty(uint64_t period, uint64_t duty, timeType tType)
+    {
+        uint64_t periodTime;
+        uint64_t dutyTime;
+
+        if( ! convertToNanosecond(period, tType, periodTime) or ! convertToNanosecond(duty, tType, dutyTime) or
+            periodTime > PWM_MAX_NANOSECOND or dutyTime > periodTime )
+        {
+            this->pwmErrors->outOfRange = true;
+            return false;
+        }
+
+        this->pwmErrors->outOfRange = false;
+
+        int64_t newPeriod   = static_cast<int64_t>(periodTime);
+        int64_t newDuty     = static_cast<int64_t>(dutyTime);
+
+        if( ! this->fetchAttribute(BlackPWMBackend::dutyAttribute, this->dutyShadow) )
+        {
+            this->pwmErrors->dutyFileError = true;
+            return false;
+        }
+
+        // new period can't be less than current duty. If it is, the duty must be reduced first.
+        // New duty is not greater than new period, so it is also legal for the current period.
+        bool periodFirst = ( newPeriod >= this->dutyShadow );
+
+        if( periodFirst )
         {
-            std::ofstream dutyFile;
-            dutyFile.open(this->dutyPath.c_str(),std::ios::out);
-            if(dutyFile.fail())
+            this->pwmErrors->periodFileError = ! this->storeAttribute(BlackPWMBackend::periodAttribute, this->periodShadow, newPeriod);
+            if( this->pwmErrors->periodFileError )
             {
-                dutyFile.close();
-                this->pwmErrors->dutyFileError = true;
                 return false;
             }
-            else
+        }
+
+        this->pwmErrors->dutyFileError = ! this->storeAttribute(BlackPWMBackend::dutyAttribute, this->dutyShadow, newDuty);
+        if( this->pwmErrors->dutyFileError )
+        {
+            return false;
+        }
+
+        if( ! periodFirst )
+        {
+            this->pwmErrors->periodFileError = ! this->storeAttribute(BlackPWMBackend::periodAttribute, this->periodShadow, newPeriod);
+            if( this->pwmErrors->periodFileError )
             {
-                dutyFile << writeThis;
-                dutyFile.close();
-                this->pwmErrors->dutyFileError = false;
-                return true;
+                return false;
             }
         }
+
+        return true;
     }
 
     bool        BlackPWM::setPolarity(polarityType polarity)
     {
-        std::ofstream polarityFile;
-        polarityFile.open(this->polarityPath.c_str(),std::ios::out);
-        if(polarityFile.fail())
+        if( ! this->storeAttribute(BlackPWMBackend::polarityAttribute, this->polarityShadow, static_cast<int64_t>(polarity)) )
         {
-            polarityFile.close();
             this->pwmErrors->polarityFileError = true;
             return false;
         }
-        else
-        {
-            polarityFile << static_cast<int>(polarity);
-            polarityFile.close();
-            this->pwmErrors->polarityFileError = false;
-            return true;
-        }
+
+        this->pwmErrors->polarityFileError = false;
+        return true;
     }
 
     bool        BlackPWM::setRunState(runValue state)
     {
-        std::ofstream runFile;
-        runFile.open(this->runPath.c_str(),std::ios::out);
-        if(runFile.fail())
+        if( ! this->storeAttribute(BlackPWMBackend::runAttribute, this->runShadow, static_cast<int64_t>(state)) )
         {
-            runFile.close();
             this->pwmErrors->runFileError = true;
             return false;
         }
-        else
-        {
-            runFile << static_cast<int>(state);
-            runFile.close();
-            this->pwmErrors->runFileError = false;
-            return true;
-        }
+
+        this->pwmErrors->runFileError = false;
+        return true;
     }
 
 
 
     bool        BlackPWM::isRunning()
     {
-        return (this->getRunValue() == "1");
+        this->pwmErrors->runFileError = ! this->fetchAttribute(BlackPWMBackend::runAttribute, this->runShadow);
+        return (this->runShadow == 1);
     }
 
     bool        BlackPWM::isPolarityStraight()
     {
-        return !(this->getPolarityValue() == "1");
+        this->pwmErrors->polarityFileError = ! this->fetchAttribute(BlackPWMBackend::polarityAttribute, this->polarityShadow);
+        return !(this->polarityShadow == 1);
     }
 
     bool        BlackPWM::isPolarityReverse()
     {
-        return (this->getPolarityValue() == "1");
+        this->pwmErrors->polarityFileError = ! this->fetchAttribute(BlackPWMBackend::polarityAttribute, this->polarityShadow);
+        return (this->polarityShadow == 1);
     }
 
 
 
     void        BlackPWM::toggleRunState()
     {
-        if( this->getRunValue() == "1" )
+        if( this->isRunning() )
         {
             this->setRunState(stop);
         }
@@ -1460,7 +2832,7 @@ namespace BlackLib
 
     void        BlackPWM::tooglePolarity()
     {
-        if( this->getPolarityValue() == "0" )
+        if( this->isPolarityStraight() )
         {
             this->setPolarity(reverse);
         }
@@ -1480,8 +2852,9 @@ namespace BlackLib
                 this->pwmErrors->pwmCoreErrors->dtError or
                 this->pwmErrors->pwmCoreErrors->dtSsError or
                 this->pwmErrors->pwmCoreErrors->pwmTestError or
-                this->pwmErrors->pwmCoreErrors->coreErrors->ocpError or
-                this->pwmErrors->pwmCoreErrors->coreErrors->capeMgrError
+                ( this->getLayout() == sysfsBackend and
+                  ( this->pwmErrors->pwmCoreErrors->coreErrors->ocpError or
+                    this->pwmErrors->pwmCoreErrors->coreErrors->capeMgrError ) )
                 );
     }
 
@@ -1505,6 +2878,177 @@ namespace BlackLib
 
 
 
+
+
+
+    // ######################################### BLACKPWMGROUP DEFINITION STARTS ########################################## //
+    BlackPWMGroup::BlackPWMGroup(const pwmName *pwms, unsigned int count, pwmBackend backend)
+    {
+        this->memberCount = (count > 7) ? 7 : count;
+
+        if( BlackCorePWM::selectLayout(backend) == pwmchipBackend )
+        {
+            BlackCorePWM::exportPwmChannels(pwms, this->memberCount);
+        }
+
+        for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+        {
+            this->members[i] = new BlackPWM(pwms[i], backend);
+        }
+
+        for( unsigned int module = 0 ; module < 3 ; module++ )
+        {
+            this->modules[module]       = NULL;
+            this->moduleOutputs[module] = 0;
+        }
+
+        if( backend == registerBackend )
+        {
+            for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+            {
+                // PWMSS modules are 0x2000 apart from PWMSS0
+                unsigned int module = (pwmModuleAddressMap[pwms[i]] - pwmModuleAddressMap[P9_42]) / 0x2000;
+                if( this->modules[module] == NULL )
+                {
+                    this->modules[module] = new BlackMemoryRegion(pwmModuleAddressMap[pwms[i]], 0x1000);
+                }
+                this->moduleOutputs[module] |= (1u << pwmChannelMap[pwms[i]]);
+            }
+        }
+    }
+
+    BlackPWMGroup::~BlackPWMGroup()
+    {
+        for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+        {
+            delete this->members[i];
+        }
+
+        for( unsigned int module = 0 ; module < 3 ; module++ )
+        {
+            delete this->modules[module];
+        }
+    }
+
+    unsigned int BlackPWMGroup::getChannelCount()
+    {
+        return this->memberCount;
+    }
+
+    BlackPWM    &BlackPWMGroup::getChannel(unsigned int index)
+    {
+        return *(this->members[index]);
+    }
+
+    bool        BlackPWMGroup::setDutyPercents(const float *percentages)
+    {
+        bool isSuccess = true;
+        for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+        {
+            isSuccess &= this->members[i]->setDutyPercent(percentages[i]);
+        }
+        return isSuccess;
+    }
+
+    bool        BlackPWMGroup::setDuties(const uint64_t *duties, timeType tType)
+    {
+        bool isSuccess = true;
+        for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+        {
+            // shadow values are known after the first access, so unchanged members cost no syscall
+            uint64_t duty;
+            if( convertToNanosecond(duties[i], tType, duty) and
+                static_cast<int64_t>(duty) == this->members[i]->getNumericDutyValue() )
+            {
+                continue;
+            }
+
+            isSuccess &= this->members[i]->setSpaceRatioTime(duties[i], tType);
+        }
+        return isSuccess;
+    }
+
+    bool        BlackPWMGroup::setPeriodsAndDuties(const uint64_t *periods, const uint64_t *duties, timeType tType)
+    {
+        bool isSuccess = true;
+        for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+        {
+            uint64_t period;
+            uint64_t duty;
+            if( convertToNanosecond(periods[i], tType, period) and convertToNanosecond(duties[i], tType, duty) and
+                static_cast<int64_t>(period) == this->members[i]->getNumericPeriodValue() and
+                static_cast<int64_t>(duty) == this->members[i]->getNumericDutyValue() )
+            {
+                continue;
+            }
+
+            // the member orders its period and duty writes, so each changed value is written once
+            isSuccess &= this->members[i]->setPeriodAndDuty(periods[i], duties[i], tType);
+        }
+        return isSuccess;
+    }
+
+    bool        BlackPWMGroup::setRunStates(runValue state)
+    {
+        bool isSuccess = true;
+        for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+        {
+            isSuccess &= this->members[i]->setRunState(state);
+        }
+        return isSuccess;
+    }
+
+    bool        BlackPWMGroup::startSynchronized()
+    {
+        // running members are stopped first, otherwise they would keep their old phase.
+        if( ! this->setRunStates(stop) or ! this->setRunStates(run) )
+        {
+            return false;
+        }
+
+        // counters are reset after all members run, so every output starts its period at the same time.
+        bool isSuccess = true;
+        for( unsigned int module = 0 ; module < 3 ; module++ )
+        {
+            if( this->moduleOutputs[module] == 0 )
+            {
+                continue;
+            }
+
+            if( ! this->modules[module]->isMapped() )
+            {
+                isSuccess = false;
+                continue;
+            }
+
+            if( this->moduleOutputs[module] & 0x3 )
+            {
+                *this->modules[module]->register16(epwmTbcnt) = 0;
+            }
+            if( this->moduleOutputs[module] & 0x4 )
+            {
+                *this->modules[module]->register32(ecapTsctr) = 0;
+            }
+        }
+
+        return isSuccess;
+    }
+
+    bool        BlackPWMGroup::fail()
+    {
+        for( unsigned int i = 0 ; i < this->memberCount ; i++ )
+        {
+            if( this->members[i]->fail() )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    // ########################################## BLACKPWMGROUP DEFINITION ENDS ########################################### //
+
+
+
 } /* namespace BlackLib */
 
 #endif /* BLACKPWM_H_ */
@@ -0,0 +1,383 @@
+#ifndef BLACKPWMSTREAM_H_
+#define BLACKPWMSTREAM_H_
+
+#include "BlackPWM.h"
+
+#include <atomic>
+#include <vector>
+#include <stdint.h>
+#include <cerrno>
+#include <time.h>           // need for clock_nanosleep() function
+#include <pthread.h>        // need for streaming thread
+#include <sched.h>          // need for SCHED_FIFO scheduling policy
+#include <sys/mman.h>       // need for mlockall() function
+
+namespace BlackLib
+{
+
+    /*! @brief Holds timing statistics of BlackPWMStream.
+     *
+     *    Latency is the difference between the absolute deadline of a tick and the time which the
+     *    streaming thread wakes up at. It is measured at @a nanosecond level.
+     */
+    struct streamStatistics
+    {
+        uint64_t    ticks;                  /*!< @brief number of ticks since start */
+        uint64_t    underruns;              /*!< @brief number of ticks which found sample buffer empty */
+        uint64_t    missedTicks;            /*!< @brief number of deadlines passed completely while the thread was late */
+        uint64_t    writeErrors;            /*!< @brief number of failed duty writes */
+        int64_t     minLatency;             /*!< @brief minimum wake up latency */
+        int64_t     maxLatency;             /*!< @brief maximum wake up latency */
+        int64_t     meanLatency;            /*!< @brief mean wake up latency */
+    };
+
+
+
+    // ######################################### BLACKPWMSTREAM DECLARATION STARTS ######################################## //
+
+    /*! @brief Plays duty cycle sequences on a pwm output at fixed rate.
+     *
+     *    This class runs a dedicated thread, which wakes up at absolute deadlines with clock_nanosleep()
+     *    and writes one duty percentage sample to the pwm at every tick. Samples are given with push()
+     *    function from a producer thread, through a lock free single producer/single consumer buffer.
+     *    If the buffer is empty at a tick, the pwm keeps its last value and an underrun is counted.
+     *
+     *    While streaming, BlackPWM object must not be used from another thread.
+     *
+     * @par Example
+     * @code{.cpp}
+     *   BlackLib::BlackPWM         myPwm(BlackLib::P8_19);
+     *   BlackLib::BlackPWMStream   myStream(myPwm, 1000000, 4096);    // 1 kHz, 4096 samples
+     *
+     *   for( int i = 0 ; i < 1000 ; i++ )
+     *   {
+     *       myStream.push( 50.0 + 50.0 * sin(i * 0.00628) );
+     *   }
+     *
+     *   myStream.start(80, true);          // SCHED_FIFO priority 80, locked memory
+     *   sleep(1);
+     *   myStream.stop();
+     *
+     *   BlackLib::streamStatistics stats = myStream.getStatistics();
+     *   std::cout << "Underruns: " << stats.underruns << ", max latency: " << stats.maxLatency << " ns";
+     * @endcode
+     */
+    class BlackPWMStream
+    {
+        private:
+            BlackPWM                    *pwm;               /*!< @brief is used to hold the streamed pwm */
+            uint64_t                    tickPeriod;         /*!< @brief is used to hold the tick period at nanosecond level */
+            std::vector<float>          samples;            /*!< @brief is used to hold the sample ring buffer */
+            std::atomic<uint64_t>       writeIndex;         /*!< @brief is used to hold the producer position */
+            std::atomic<uint64_t>       readIndex;          /*!< @brief is used to hold the consumer position */
+            std::atomic<bool>           isStreaming;        /*!< @brief is used to hold the thread state */
+            pthread_t                   streamThread;       /*!< @brief is used to hold the streaming thread */
+            bool                        isJoinable;         /*!< @brief is used to hold whether streaming thread is waiting for join */
+            int                         fifoPriority;       /*!< @brief is used to hold SCHED_FIFO priority, 0 means normal scheduling */
+
+            std::atomic<uint64_t>       ticks;              /*!< @brief is used to hold streamStatistics::ticks */
+            std::atomic<uint64_t>       underruns;          /*!< @brief is used to hold streamStatistics::underruns */
+            std::atomic<uint64_t>       missedTicks;        /*!< @brief is used to hold streamStatistics::missedTicks */
+            std::atomic<uint64_t>       writeErrors;        /*!< @brief is used to hold streamStatistics::writeErrors */
+            std::atomic<int64_t>        minLatency;         /*!< @brief is used to hold streamStatistics::minLatency */
+            std::atomic<int64_t>        maxLatency;         /*!< @brief is used to hold streamStatistics::maxLatency */
+            std::atomic<int64_t>        totalLatency;       /*!< @brief is used to calculate streamStatistics::meanLatency */
+
+            /*! @brief Entry point of streaming thread.
+            *
+            *  @param [in] object    pointer of BlackPWMStream object
+            */
+            static void     *threadEntry(void *object);
+
+            /*! @brief Runs tick loop until stop() is called.
+            */
+            void            streamLoop();
+
+            /*! @brief Copying is not allowed, because the object owns a thread.
+            */
+                            BlackPWMStream(const BlackPWMStream &);
+
+            /*! @brief Copying is not allowed, because the object owns a thread.
+            */
+            BlackPWMStream  &operator=(const BlackPWMStream &);
+
+        public:
+            /*! @brief Constructor of BlackPWMStream class.
+            *
+            * This function allocates the sample buffer. No memory is allocated after construction.
+            * @param [in] pwmObject      pwm which is streamed
+            * @param [in] period         tick period at nanosecond level, 0 is treated as 1
+            * @param [in] bufferSize     maximum number of samples which are waiting in the buffer
+            */
+                            BlackPWMStream(BlackPWM &pwmObject, uint64_t period, unsigned int bufferSize);
+
+            /*! @brief Destructor of BlackPWMStream class.
+            *
+            * This function stops the streaming thread, if it is running.
+            */
+            virtual         ~BlackPWMStream();
+
+            /*! @brief Adds a duty percentage sample to the buffer.
+            *
+            * This function is lock free. It must be called from one producer thread only.
+            * @param [in] percentage     new duty percentage sample
+            * @return True if sample is added, false if buffer is full.
+            */
+            bool            push(float percentage);
+
+            /*! @brief Adds duty percentage samples to the buffer.
+            *
+            * @param [in] percentages    new duty percentage samples
+            * @param [in] count          number of samples
+            * @return Number of added samples.
+            * @sa push(float)
+            */
+            unsigned int    push(const float *percentages, unsigned int count);
+
+            /*! @brief Exports number of samples waiting in the buffer.
+            *
+            * @return Number of waiting samples.
+            */
+            unsigned int    getBufferedCount();
+
+            /*! @brief Starts streaming thread.
+            *
+            * @param [in] priority       SCHED_FIFO priority of the thread (1-99), 0 uses normal scheduling
+            * @param [in] lockMemory     if it is true, all pages of the process are locked with mlockall()
+            * @return True if thread is started, else false. Real time scheduling needs root or CAP_SYS_NICE.
+            * @note The thread exits by itself and isRunning() turns false, if clock_nanosleep() fails with
+            * an error other than EINTR.
+            */
+            bool            start(int priority = 0, bool lockMemory = false);
+
+            /*! @brief Stops streaming thread and waits for it.
+            */
+            void            stop();
+
+            /*! @brief Checks state of streaming thread.
+            *
+            * @return True if streaming thread is running, else false.
+            */
+            bool            isRunning();
+
+            /*! @brief Exports timing statistics.
+            *
+            * @return Statistics since last start().
+            * @sa streamStatistics
+            */
+            streamStatistics getStatistics();
+    };
+    // ########################################## BLACKPWMSTREAM DECLARATION ENDS ######################################### //
+
+
+
+
+    // ######################################### BLACKPWMSTREAM DEFINITION STARTS ######################################### //
+    BlackPWMStream::BlackPWMStream(BlackPWM &pwmObject, uint64_t period, unsigned int bufferSize)
+        : pwm(&pwmObject), tickPeriod( (period == 0) ? 1 : period ), samples( (bufferSize == 0) ? 1 : bufferSize ),
+          writeIndex(0), readIndex(0), isStreaming(false), streamThread(), isJoinable(false), fifoPriority(0),
+          ticks(0), underruns(0), missedTicks(0), writeErrors(0), minLatency(0), maxLatency(0), totalLatency(0)
+    {
+    }
+
+    BlackPWMStream::~BlackPWMStream()
+    {
+        this->stop();
+    }
+
+    bool        BlackPWMStream::push(float percentage)
+    {
+        uint64_t writePosition  = this->writeIndex.load(std::memory_order_relaxed);
+        uint64_t readPosition   = this->readIndex.load(std::memory_order_acquire);
+
+        if( writePosition - readPosition >= this->samples.size() )
+        {
+            return false;
+        }
+
+        this->samples[writePosition % this->samples.size()] = percentage;
+        this->writeIndex.store(writePosition + 1, std::memory_order_release);
+        return true;
+    }
+
+    unsigned int BlackPWMStream::push(const float *percentages, unsigned int count)
+    {
+        unsigned int pushed = 0;
+        while( pushed < count and this->push(percentages[pushed]) )
+        {
+            ++pushed;
+        }
+        return pushed;
+    }
+
+    unsigned int BlackPWMStream::getBufferedCount()
+    {
+        return static_cast<unsigned int>( this->writeIndex.load(std::memory_order_acquire) -
+                                          this->readIndex.load(std::memory_order_acquire) );
+    }
+
+    bool        BlackPWMStream::start(int priority, bool lockMemory)
+    {
+        if( this->isStreaming.load() )
+        {
+            return false;
+        }
+
+        // thread of previous run may be exited by itself after a sleep error.
+        if( this->isJoinable )
+        {
+            pthread_join(this->streamThread, NULL);
+            this->isJoinable = false;
+        }
+
+        if( lockMemory and mlockall(MCL_CURRENT | MCL_FUTURE) != 0 )
+        {
+            return false;
+        }
+
+        this->fifoPriority = priority;
+        this->ticks         = 0;
+        this->underruns     = 0;
+        this->missedTicks   = 0;
+        this->writeErrors   = 0;
+        this->minLatency    = INT64_MAX;
+        this->maxLatency    = 0;
+        this->totalLatency  = 0;
+
+        pthread_attr_t attributes;
+        pthread_attr_init(&attributes);
+
+        if( priority > 0 )
+        {
+            sched_param parameter;
+            parameter.sched_priority = priority;
+            pthread_attr_setinheritsched(&attributes, PTHREAD_EXPLICIT_SCHED);
+            pthread_attr_setschedpolicy(&attributes, SCHED_FIFO);
+            pthread_attr_setschedparam(&attributes, &parameter);
+        }
+
+        this->isStreaming = true;
+        if( pthread_create(&this->streamThread, &attributes, &BlackPWMStream::threadEntry, this) != 0 )
+        {
+            this->isStreaming = false;
+            pthread_attr_destroy(&attributes);
+            return false;
+        }
+
+        pthread_attr_destroy(&attributes);
+        this->isJoinable = true;
+        return true;
+    }
+
+    void        BlackPWMStream::stop()
+    {
+        this->isStreaming.store(false);
+        if( this->isJoinable )
+        {
+            pthread_join(this->streamThread, NULL);
+            this->isJoinable = false;
+        }
+    }
+
+    bool        BlackPWMStream::isRunning()
+    {
+        return this->isStreaming.load();
+    }
+
+    streamStatistics BlackPWMStream::getStatistics()
+    {
+        streamStatistics stats;
+        stats.ticks         = this->ticks.load();
+        stats.underruns     = this->underruns.load();
+        stats.missedTicks   = this->missedTicks.load();
+        stats.writeErrors   = this->writeErrors.load();
+        stats.minLatency    = (stats.ticks == 0) ? 0 : this->minLatency.load();
+        stats.maxLatency    = this->maxLatency.load();
+        stats.meanLatency   = (stats.ticks == 0) ? 0 : static_cast<int64_t>(this->totalLatency.load() / static_cast<int64_t>(stats.ticks));
+        return stats;
+    }
+
+    void        *BlackPWMStream::threadEntry(void *object)
+    {
+        static_cast<BlackPWMStream *>(object)->streamLoop();
+        return NULL;
+    }
+
+    void        BlackPWMStream::streamLoop()
+    {
+        const int64_t   period = static_cast<int64_t>(this->tickPeriod);
+        timespec        deadline;
+        timespec        now;
+
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+        while( this->isStreaming.load(std::memory_order_relaxed) )
+        {
+            // tv_nsec is a 32 bit long at the board, so whole seconds of the period go to tv_sec
+            deadline.tv_sec  += static_cast<time_t>(period / 1000000000);
+            deadline.tv_nsec += static_cast<long>(period % 1000000000);
+            if( deadline.tv_nsec >= 1000000000 )
+            {
+                deadline.tv_nsec -= 1000000000;
+                deadline.tv_sec  += 1;
+            }
+
+            int sleepResult;
+            while( (sleepResult = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL)) == EINTR )
+            {
+                // interrupted by a signal, sleep again to same deadline.
+            }
+
+            // any other error is not transient, streaming is stopped instead of spinning.
+            if( sleepResult != 0 )
+            {
+                this->isStreaming.store(false);
+                break;
+            }
+
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            int64_t latency = (now.tv_sec - deadline.tv_sec) * 1000000000LL + (now.tv_nsec - deadline.tv_nsec);
+
+            if( latency < this->minLatency.load(std::memory_order_relaxed) ) { this->minLatency.store(latency, std::memory_order_relaxed); }
+            if( latency > this->maxLatency.load(std::memory_order_relaxed) ) { this->maxLatency.store(latency, std::memory_order_relaxed); }
+            this->totalLatency.fetch_add(latency, std::memory_order_relaxed);
+            this->ticks.fetch_add(1, std::memory_order_relaxed);
+
+            // if the thread is late more than one tick, passed deadlines are skipped for keeping the rate.
+            if( latency >= period )
+            {
+                int64_t passed      = latency / period;
+                int64_t advance     = passed * period;
+                deadline.tv_sec    += static_cast<time_t>(advance / 1000000000);
+                deadline.tv_nsec   += static_cast<long>(advance % 1000000000);
+                if( deadline.tv_nsec >= 1000000000 )
+                {
+                    deadline.tv_nsec -= 1000000000;
+                    deadline.tv_sec  += 1;
+                }
+                this->missedTicks.fetch_add(static_cast<uint64_t>(passed), std::memory_order_relaxed);
+            }
+
+            uint64_t readPosition   = this->readIndex.load(std::memory_order_relaxed);
+            uint64_t writePosition  = this->writeIndex.load(std::memory_order_acquire);
+
+            if( readPosition == writePosition )
+            {
+                this->underruns.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            float percentage = this->samples[readPosition % this->samples.size()];
+            this->readIndex.store(readPosition + 1, std::memory_order_release);
+
+            if( ! this->pwm->setDutyPercent(percentage) )
+            {
+                this->writeErrors.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    // ########################################## BLACKPWMSTREAM DEFINITION ENDS ########################################## //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKPWMSTREAM_H_ */
@@ -0,0 +1,437 @@
+#ifndef BLACKPINS_H_
+#define BLACKPINS_H_
+
+#include <stdint.h>
+
+namespace BlackLib
+{
+
+    /*!
+    * This enum is used for selecting a pin of P8 and P9 headers. Value of a pin equals to its index at
+    * headerPinTable. Names have @b HEADER_ prefix, because bare P8_xx and P9_xx names are used by
+    * pwmName and by the macros of GPIO.h.
+    */
+    enum headerPin          {   HEADER_P8_01            = 0,
+                                HEADER_P8_02            = 1,
+                                HEADER_P8_03            = 2,
+                                HEADER_P8_04            = 3,
+                                HEADER_P8_05            = 4,
+                                HEADER_P8_06            = 5,
+                                HEADER_P8_07            = 6,
+                                HEADER_P8_08            = 7,
+                                HEADER_P8_09            = 8,
+                                HEADER_P8_10            = 9,
+                                HEADER_P8_11            = 10,
+                                HEADER_P8_12            = 11,
+                                HEADER_P8_13            = 12,
+                                HEADER_P8_14            = 13,
+                                HEADER_P8_15            = 14,
+                                HEADER_P8_16            = 15,
+                                HEADER_P8_17            = 16,
+                                HEADER_P8_18            = 17,
+                                HEADER_P8_19            = 18,
+                                HEADER_P8_20            = 19,
+                                HEADER_P8_21            = 20,
+                                HEADER_P8_22            = 21,
+                                HEADER_P8_23            = 22,
+                                HEADER_P8_24            = 23,
+                                HEADER_P8_25            = 24,
+                                HEADER_P8_26            = 25,
+                                HEADER_P8_27            = 26,
+                                HEADER_P8_28            = 27,
+                                HEADER_P8_29            = 28,
+                                HEADER_P8_30            = 29,
+                                HEADER_P8_31            = 30,
+                                HEADER_P8_32            = 31,
+                                HEADER_P8_33            = 32,
+                                HEADER_P8_34            = 33,
+                                HEADER_P8_35            = 34,
+                                HEADER_P8_36            = 35,
+                                HEADER_P8_37            = 36,
+                                HEADER_P8_38            = 37,
+                                HEADER_P8_39            = 38,
+                                HEADER_P8_40            = 39,
+                                HEADER_P8_41            = 40,
+                                HEADER_P8_42            = 41,
+                                HEADER_P8_43            = 42,
+                                HEADER_P8_44            = 43,
+                                HEADER_P8_45            = 44,
+                                HEADER_P8_46            = 45,
+                                HEADER_P9_01            = 46,
+                                HEADER_P9_02            = 47,
+                                HEADER_P9_03            = 48,
+                                HEADER_P9_04            = 49,
+                                HEADER_P9_05            = 50,
+                                HEADER_P9_06            = 51,
+                                HEADER_P9_07            = 52,
+                                HEADER_P9_08            = 53,
+                                HEADER_P9_09            = 54,
+                                HEADER_P9_10            = 55,
+                                HEADER_P9_11            = 56,
+                                HEADER_P9_12            = 57,
+                                HEADER_P9_13            = 58,
+                                HEADER_P9_14            = 59,
+                                HEADER_P9_15            = 60,
+                                HEADER_P9_16            = 61,
+                                HEADER_P9_17            = 62,
+                                HEADER_P9_18            = 63,
+                                HEADER_P9_19            = 64,
+                                HEADER_P9_20            = 65,
+                                HEADER_P9_21            = 66,
+                                HEADER_P9_22            = 67,
+                                HEADER_P9_23            = 68,
+                                HEADER_P9_24            = 69,
+                                HEADER_P9_25            = 70,
+                                HEADER_P9_26            = 71,
+                                HEADER_P9_27            = 72,
+                                HEADER_P9_28            = 73,
+                                HEADER_P9_29            = 74,
+                                HEADER_P9_30            = 75,
+                                HEADER_P9_31            = 76,
+                                HEADER_P9_32            = 77,
+                                HEADER_P9_33            = 78,
+                                HEADER_P9_34            = 79,
+                                HEADER_P9_35            = 80,
+                                HEADER_P9_36            = 81,
+                                HEADER_P9_37            = 82,
+                                HEADER_P9_38            = 83,
+                                HEADER_P9_39            = 84,
+                                HEADER_P9_40            = 85,
+                                HEADER_P9_41            = 86,
+                                HEADER_P9_42            = 87,
+                                HEADER_P9_43            = 88,
+                                HEADER_P9_44            = 89,
+                                HEADER_P9_45            = 90,
+                                HEADER_P9_46            = 91,
+
+                                headerPinCount          = 92
+                                };
+
+
+    /*!
+    * This enum is used for defining peripheral functions of a header pin. A pin can take more than one
+    * of them, so values are bit flags.
+    */
+    enum pinFunction        {   noFunction              = 0,
+                                gpioFunction            = (1 << 0),     /*!< gpio input or output */
+                                pwmFunction             = (1 << 1),     /*!< EHRPWM or eCAP output of a PWMSS module */
+                                spiFunction             = (1 << 2),     /*!< spi0 or spi1 signal */
+                                i2cFunction             = (1 << 3),     /*!< i2c1 or i2c2 signal */
+                                uartFunction            = (1 << 4),     /*!< uart signal */
+                                eqepFunction            = (1 << 5),     /*!< eQEP input of a PWMSS module */
+                                timerFunction           = (1 << 6),     /*!< timer4 - timer7 pin */
+                                lcdFunction             = (1 << 7),     /*!< lcd signal, used by HDMI at default device tree */
+                                mmcFunction             = (1 << 8),     /*!< mmc1 signal, used by eMMC at default device tree */
+                                analogFunction          = (1 << 9),     /*!< ADC input */
+                                powerFunction           = (1 << 10)     /*!< power, ground, reset or power button */
+                            };
+
+
+    /*! @brief Holds hardware properties of a header pin.
+     */
+    struct headerPinInfo
+    {
+        headerPin       pin;                /*!< @brief header pin, equals to table index */
+        int             gpio;               /*!< @brief kernel gpio number, -1 if the pin can not be gpio */
+        int             muxOffset;          /*!< @brief pinmux register offset from 0x44E10800 (like DTS files), -1 if the pin has not pinmux */
+        unsigned int    functions;          /*!< @brief peripheral functions of the pin (pinFunction flags) */
+        int             pwmModule;          /*!< @brief PWMSS module number of pwm output, -1 if the pin has not pwm output */
+        int             pwmOutput;          /*!< @brief output of the PWMSS module; 0 is EHRPWM A, 1 is EHRPWM B and 2 is eCAP */
+    };
+
+
+    /*!
+    * This table is used for finding properties of header pins at compile time.
+    */
+    constexpr headerPinInfo headerPinTable[headerPinCount] = {
+                                                { HEADER_P8_01,     -1,     -1, powerFunction,                                                     -1, -1 },   // DGND
+                                                { HEADER_P8_02,     -1,     -1, powerFunction,                                                     -1, -1 },   // DGND
+                                                { HEADER_P8_03,     38,  0x018, gpioFunction | mmcFunction,                                        -1, -1 },   // gpmc_ad6
+                                                { HEADER_P8_04,     39,  0x01C, gpioFunction | mmcFunction,                                        -1, -1 },   // gpmc_ad7
+                                                { HEADER_P8_05,     34,  0x008, gpioFunction | mmcFunction,                                        -1, -1 },   // gpmc_ad2
+                                                { HEADER_P8_06,     35,  0x00C, gpioFunction | mmcFunction,                                        -1, -1 },   // gpmc_ad3
+                                                { HEADER_P8_07,     66,  0x090, gpioFunction | timerFunction,                                      -1, -1 },   // gpmc_advn_ale, timer4
+                                                { HEADER_P8_08,     67,  0x094, gpioFunction | timerFunction,                                      -1, -1 },   // gpmc_oen_ren, timer7
+                                                { HEADER_P8_09,     69,  0x09C, gpioFunction | timerFunction,                                      -1, -1 },   // gpmc_ben0_cle, timer5
+                                                { HEADER_P8_10,     68,  0x098, gpioFunction | timerFunction,                                      -1, -1 },   // gpmc_wen, timer6
+                                                { HEADER_P8_11,     45,  0x034, gpioFunction | eqepFunction,                                       -1, -1 },   // gpmc_ad13, eQEP2B_in
+                                                { HEADER_P8_12,     44,  0x030, gpioFunction | eqepFunction,                                       -1, -1 },   // gpmc_ad12, eQEP2A_in
+                                                { HEADER_P8_13,     23,  0x024, gpioFunction | pwmFunction,                                         2,  1 },   // gpmc_ad9, ehrpwm2B
+                                                { HEADER_P8_14,     26,  0x028, gpioFunction,                                                      -1, -1 },   // gpmc_ad10
+                                                { HEADER_P8_15,     47,  0x03C, gpioFunction | eqepFunction,                                       -1, -1 },   // gpmc_ad15, eQEP2_strobe
+                                                { HEADER_P8_16,     46,  0x038, gpioFunction | eqepFunction,                                       -1, -1 },   // gpmc_ad14, eQEP2_index
+                                                { HEADER_P8_17,     27,  0x02C, gpioFunction,                                                      -1, -1 },   // gpmc_ad11
+                                                { HEADER_P8_18,     65,  0x08C, gpioFunction,                                                      -1, -1 },   // gpmc_clk
+                                                { HEADER_P8_19,     22,  0x020, gpioFunction | pwmFunction,                                         2,  0 },   // gpmc_ad8, ehrpwm2A
+                                                { HEADER_P8_20,     63,  0x084, gpioFunction | mmcFunction,                                        -1, -1 },   // gpmc_csn2, mmc1_cmd
+                                                { HEADER_P8_21,     62,  0x080, gpioFunction | mmcFunction,                                        -1, -1 },   // gpmc_csn1, mmc1_clk
+                                                { HEADER_P8_22,     37,  0x014, gpioFunction | mmcFunction,                                        -1, -1 },   // gpmc_ad5
+                                                { HEADER_P8_23,     36,  0x010, gpioFunction | mmcFunction,                                        -1, -1 },   // gpmc_ad4
+                                                { HEADER_P8_24,     33,  0x004, gpioFunction | mmcFunction,                                        -1, -1 },   // gpmc_ad1
+                                                { HEADER_P8_25,     32,  0x000, gpioFunction | mmcFunction,                                        -1, -1 },   // gpmc_ad0
+                                                { HEADER_P8_26,     61,  0x07C, gpioFunction,                                                      -1, -1 },   // gpmc_csn0
+                                                { HEADER_P8_27,     86,  0x0E0, gpioFunction | lcdFunction,                                        -1, -1 },   // lcd_vsync
+                                                { HEADER_P8_28,     88,  0x0E8, gpioFunction | lcdFunction,                                        -1, -1 },   // lcd_pclk
+                                                { HEADER_P8_29,     87,  0x0E4, gpioFunction | lcdFunction,                                        -1, -1 },   // lcd_hsync
+                                                { HEADER_P8_30,     89,  0x0EC, gpioFunction | lcdFunction,                                        -1, -1 },   // lcd_ac_bias_en
+                                                { HEADER_P8_31,     10,  0x0D8, gpioFunction | lcdFunction | eqepFunction,                         -1, -1 },   // lcd_data14, eQEP1_index
+                                                { HEADER_P8_32,     11,  0x0DC, gpioFunction | lcdFunction | eqepFunction,                         -1, -1 },   // lcd_data15, eQEP1_strobe
+                                                { HEADER_P8_33,      9,  0x0D4, gpioFunction | lcdFunction | eqepFunction,                         -1, -1 },   // lcd_data13, eQEP1B_in
+                                                { HEADER_P8_34,     81,  0x0CC, gpioFunction | lcdFunction | pwmFunction,                           1,  1 },   // lcd_data11, ehrpwm1B
+                                                { HEADER_P8_35,      8,  0x0D0, gpioFunction | lcdFunction | eqepFunction,                         -1, -1 },   // lcd_data12, eQEP1A_in
+                                                { HEADER_P8_36,     80,  0x0C8, gpioFunction | lcdFunction | pwmFunction,                           1,  0 },   // lcd_data10, ehrpwm1A
+                                                { HEADER_P8_37,     78,  0x0C0, gpioFunction | lcdFunction | uartFunction,                         -1, -1 },   // lcd_data8, uart5_txd
+                                                { HEADER_P8_38,     79,  0x0C4, gpioFunction | lcdFunction | uartFunction,                         -1, -1 },   // lcd_data9, uart5_rxd
+                                                { HEADER_P8_39,     76,  0x0B8, gpioFunction | lcdFunction,                                        -1, -1 },   // lcd_data6
+                                                { HEADER_P8_40,     77,  0x0BC, gpioFunction | lcdFunction,                                        -1, -1 },   // lcd_data7
+                                                { HEADER_P8_41,     74,  0x0B0, gpioFunction | lcdFunction,                                        -1, -1 },   // lcd_data4
+                                                { HEADER_P8_42,     75,  0x0B4, gpioFunction | lcdFunction,                                        -1, -1 },   // lcd_data5
+                                                { HEADER_P8_43,     72,  0x0A8, gpioFunction | lcdFunction,                                        -1, -1 },   // lcd_data2
+                                                { HEADER_P8_44,     73,  0x0AC, gpioFunction | lcdFunction,                                        -1, -1 },   // lcd_data3
+                                                { HEADER_P8_45,     70,  0x0A0, gpioFunction | lcdFunction | pwmFunction,                           2,  0 },   // lcd_data0, ehrpwm2A
+                                                { HEADER_P8_46,     71,  0x0A4, gpioFunction | lcdFunction | pwmFunction,                           2,  1 },   // lcd_data1, ehrpwm2B
+                                                { HEADER_P9_01,     -1,     -1, powerFunction,                                                     -1, -1 },   // DGND
+                                                { HEADER_P9_02,     -1,     -1, powerFunction,                                                     -1, -1 },   // DGND
+                                                { HEADER_P9_03,     -1,     -1, powerFunction,                                                     -1, -1 },   // VDD_3V3
+                                                { HEADER_P9_04,     -1,     -1, powerFunction,                                                     -1, -1 },   // VDD_3V3
+                                                { HEADER_P9_05,     -1,     -1, powerFunction,                                                     -1, -1 },   // VDD_5V
+                                                { HEADER_P9_06,     -1,     -1, powerFunction,                                                     -1, -1 },   // VDD_5V
+                                                { HEADER_P9_07,     -1,     -1, powerFunction,                                                     -1, -1 },   // SYS_5V
+                                                { HEADER_P9_08,     -1,     -1, powerFunction,                                                     -1, -1 },   // SYS_5V
+                                                { HEADER_P9_09,     -1,     -1, powerFunction,                                                     -1, -1 },   // PWR_BUT
+                                                { HEADER_P9_10,     -1,     -1, powerFunction,                                                     -1, -1 },   // SYS_RESETn
+                                                { HEADER_P9_11,     30,  0x070, gpioFunction | uartFunction,                                       -1, -1 },   // gpmc_wait0, uart4_rxd
+                                                { HEADER_P9_12,     60,  0x078, gpioFunction,                                                      -1, -1 },   // gpmc_be1n
+                                                { HEADER_P9_13,     31,  0x074, gpioFunction | uartFunction,                                       -1, -1 },   // gpmc_wpn, uart4_txd
+                                                { HEADER_P9_14,     50,  0x048, gpioFunction | pwmFunction,                                         1,  0 },   // gpmc_a2, ehrpwm1A
+                                                { HEADER_P9_15,     48,  0x040, gpioFunction,                                                      -1, -1 },   // gpmc_a0
+                                                { HEADER_P9_16,     51,  0x04C, gpioFunction | pwmFunction,                                         1,  1 },   // gpmc_a3, ehrpwm1B
+                                                { HEADER_P9_17,      5,  0x15C, gpioFunction | spiFunction | i2cFunction,                          -1, -1 },   // spi0_cs0, i2c1_scl
+                                                { HEADER_P9_18,      4,  0x158, gpioFunction | spiFunction | i2cFunction,                          -1, -1 },   // spi0_d1, i2c1_sda
+                                                { HEADER_P9_19,     13,  0x17C, gpioFunction | spiFunction | i2cFunction,                          -1, -1 },   // uart1_rtsn, i2c2_scl, spi1_cs1
+                                                { HEADER_P9_20,     12,  0x178, gpioFunction | spiFunction | i2cFunction,                          -1, -1 },   // uart1_ctsn, i2c2_sda, spi1_cs0
+                                                { HEADER_P9_21,      3,  0x154, gpioFunction | pwmFunction | spiFunction | i2cFunction | uartFunction,  0,  1 },   // spi0_d0, ehrpwm0B, i2c2_scl, uart2_txd
+                                                { HEADER_P9_22,      2,  0x150, gpioFunction | pwmFunction | spiFunction | i2cFunction | uartFunction,  0,  0 },   // spi0_sclk, ehrpwm0A, i2c2_sda, uart2_rxd
+                                                { HEADER_P9_23,     49,  0x044, gpioFunction,                                                      -1, -1 },   // gpmc_a1
+                                                { HEADER_P9_24,     15,  0x184, gpioFunction | i2cFunction | uartFunction,                         -1, -1 },   // uart1_txd, i2c1_scl
+                                                { HEADER_P9_25,    117,  0x1AC, gpioFunction | eqepFunction,                                       -1, -1 },   // mcasp0_ahclkx, eQEP0_strobe
+                                                { HEADER_P9_26,     14,  0x180, gpioFunction | i2cFunction | uartFunction,                         -1, -1 },   // uart1_rxd, i2c1_sda
+                                                { HEADER_P9_27,    115,  0x1A4, gpioFunction | eqepFunction,                                       -1, -1 },   // mcasp0_fsr, eQEP0B_in
+                                                { HEADER_P9_28,    113,  0x19C, gpioFunction | pwmFunction | spiFunction,                           2,  2 },   // mcasp0_ahclkr, spi1_cs0, eCAP2
+                                                { HEADER_P9_29,    111,  0x194, gpioFunction | pwmFunction | spiFunction,                           0,  1 },   // mcasp0_fsx, spi1_d0, ehrpwm0B
+                                                { HEADER_P9_30,    112,  0x198, gpioFunction | spiFunction,                                        -1, -1 },   // mcasp0_axr0, spi1_d1
+                                                { HEADER_P9_31,    110,  0x190, gpioFunction | pwmFunction | spiFunction,                           0,  0 },   // mcasp0_aclkx, spi1_sclk, ehrpwm0A
+                                                { HEADER_P9_32,     -1,     -1, powerFunction,                                                     -1, -1 },   // VDD_ADC
+                                                { HEADER_P9_33,     -1,     -1, analogFunction,                                                    -1, -1 },   // AIN4
+                                                { HEADER_P9_34,     -1,     -1, powerFunction,                                                     -1, -1 },   // GNDA_ADC
+                                                { HEADER_P9_35,     -1,     -1, analogFunction,                                                    -1, -1 },   // AIN6
+                                                { HEADER_P9_36,     -1,     -1, analogFunction,                                                    -1, -1 },   // AIN5
+                                                { HEADER_P9_37,     -1,     -1, analogFunction,                                                    -1, -1 },   // AIN2
+                                                { HEADER_P9_38,     -1,     -1, analogFunction,                                                    -1, -1 },   // AIN3
+                                                { HEADER_P9_39,     -1,     -1, analogFunction,                                                    -1, -1 },   // AIN0
+                                                { HEADER_P9_40,     -1,     -1, analogFunction,                                                    -1, -1 },   // AIN1
+                                                { HEADER_P9_41,     20,  0x1B4, gpioFunction,                                                      -1, -1 },   // xdma_event_intr1
+                                                { HEADER_P9_42,      7,  0x164, gpioFunction | pwmFunction | spiFunction | uartFunction,            0,  2 },   // ecap0_in_pwm0_out, spi1_cs1, uart3_txd
+                                                { HEADER_P9_43,     -1,     -1, powerFunction,                                                     -1, -1 },   // DGND
+                                                { HEADER_P9_44,     -1,     -1, powerFunction,                                                     -1, -1 },   // DGND
+                                                { HEADER_P9_45,     -1,     -1, powerFunction,                                                     -1, -1 },   // DGND
+                                                { HEADER_P9_46,     -1,     -1, powerFunction,                                                     -1, -1 }    // DGND
+                                                };
+
+
+    /*! @brief Checks order of headerPinTable at compile time.
+     *
+     * @param [in] index    checking starts from this table index
+     * @return True if every row is at the index of its pin, else false.
+     */
+    constexpr bool isHeaderPinTableOrdered(unsigned int index = 0)
+    {
+        return (index >= headerPinCount)                                    ? true :
+               (headerPinTable[index].pin == static_cast<headerPin>(index)) ? isHeaderPinTableOrdered(index + 1) :
+                                                                              false;
+    }
+
+
+    /*! @brief Finds properties of a header pin at compile time.
+     *
+     * @param [in] pin      header pin
+     * @return Table row of @a pin.
+     * @sa headerPinInfo
+     */
+    constexpr const headerPinInfo &findHeaderPin(headerPin pin)
+    {
+        return headerPinTable[pin];
+    }
+
+
+    /*! @brief Finds kernel gpio number of a header pin at compile time.
+     *
+     * @param [in] pin      header pin
+     * @return Gpio number, which can be used as gpioName. If the pin can not be gpio, -1.
+     */
+    constexpr int headerPinGpio(headerPin pin)
+    {
+        return headerPinTable[pin].gpio;
+    }
+
+
+    /*! @brief Finds gpio bank of a header pin at compile time.
+     *
+     * @param [in] pin      header pin
+     * @return Bank number (0-3). If the pin can not be gpio, -1.
+     */
+    constexpr int headerPinBank(headerPin pin)
+    {
+        return (headerPinTable[pin].gpio < 0) ? -1 : headerPinTable[pin].gpio / 32;
+    }
+
+
+    /*! @brief Finds bit mask of a header pin at its gpio bank registers at compile time.
+     *
+     * @param [in] pin      header pin
+     * @return Bit mask of the pin. If the pin can not be gpio, 0.
+     */
+    constexpr uint32_t headerPinBitMask(headerPin pin)
+    {
+        return (headerPinTable[pin].gpio < 0) ? 0 : (1u << (headerPinTable[pin].gpio % 32));
+    }
+
+
+    /*! @brief Finds pinmux register offset of a header pin at compile time.
+     *
+     * @param [in] pin      header pin
+     * @return Offset from 0x44E10800, which is used at @b pinctrl-single,pins of DTS files. If the
+     * pin has not pinmux, -1.
+     */
+    constexpr int headerPinMuxOffset(headerPin pin)
+    {
+        return headerPinTable[pin].muxOffset;
+    }
+
+
+    /*! @brief Checks a peripheral function of a header pin at compile time.
+     *
+     * @param [in] pin      header pin
+     * @param [in] function peripheral function
+     * @return True if @a pin can take @a function, else false.
+     */
+    constexpr bool isHeaderPinFunction(headerPin pin, pinFunction function)
+    {
+        return ( (headerPinTable[pin].functions & function) != 0 );
+    }
+
+
+    /*! @brief Finds physical address of PWMSS module of a header pin at compile time.
+     *
+     * @param [in] pin      header pin
+     * @return Address of PWMSS module (0x48300000, 0x48302000 or 0x48304000). If the pin has not
+     * pwm output, 0.
+     */
+    constexpr uint32_t headerPinPwmModuleAddress(headerPin pin)
+    {
+        return (headerPinTable[pin].pwmModule < 0) ? 0 : 0x48300000 + 0x2000 * static_cast<uint32_t>(headerPinTable[pin].pwmModule);
+    }
+
+
+    /*! @brief Finds header pin of a kernel gpio number at compile time.
+     *
+     * @param [in] gpio     kernel gpio number
+     * @param [in] index    searching starts from this table index
+     * @return Header pin of @a gpio. If @a gpio is not at the headers, headerPinCount.
+     */
+    constexpr headerPin findHeaderPinOfGpio(int gpio, unsigned int index = 0)
+    {
+        return (index >= headerPinCount)            ? headerPinCount :
+               (headerPinTable[index].gpio == gpio) ? headerPinTable[index].pin :
+                                                      findHeaderPinOfGpio(gpio, index + 1);
+    }
+
+
+    /*! @brief Calculates gpio bank mask of a pin group at compile time.
+     *
+     * @param [in] pins     header pins
+     * @param [in] count    number of pins
+     * @param [in] bank     gpio bank (0-3)
+     * @return Bit mask of the pins which are at @a bank, like the masks which BlackGPIOPort writes.
+     */
+    constexpr uint32_t headerPinBankMask(const headerPin *pins, unsigned int count, int bank)
+    {
+        return (count == 0) ? 0 :
+               ( (headerPinBank(pins[0]) == bank) ? headerPinBitMask(pins[0]) : 0 ) | headerPinBankMask(pins + 1, count - 1, bank);
+    }
+
+
+    /*! @brief Holds a planned usage of a header pin.
+     */
+    struct pinUsage
+    {
+        headerPin       pin;                /*!< @brief used header pin */
+        pinFunction     function;           /*!< @brief function which the pin is used for */
+    };
+
+
+    /*! @brief Checks usage of a header pin at a usage list at compile time.
+     *
+     * @param [in] pin      header pin
+     * @param [in] usages   usage list
+     * @param [in] count    number of usages
+     * @return True if @a pin is at @a usages, else false.
+     */
+    constexpr bool isHeaderPinUsed(headerPin pin, const pinUsage *usages, unsigned int count)
+    {
+        return (count == 0) ? false : (usages[0].pin == pin) or isHeaderPinUsed(pin, usages + 1, count - 1);
+    }
+
+
+    /*! @brief Checks a usage list for pins which are used more than once at compile time.
+     *
+     * @param [in] usages   usage list
+     * @param [in] count    number of usages
+     * @return True if a pin is used more than once (like P9_21 as EHRPWM0B and as spi0_d0), else false.
+     *
+     * @par Example
+     * @code{.cpp}
+     *   constexpr BlackLib::pinUsage board[3] = { { BlackLib::HEADER_P9_14, BlackLib::pwmFunction },
+     *                                             { BlackLib::HEADER_P9_21, BlackLib::pwmFunction },
+     *                                             { BlackLib::HEADER_P9_21, BlackLib::spiFunction } };
+     *
+     *   static_assert( ! BlackLib::hasPinConflict(board, 3), "P9_21 is used twice" );   // fails to compile
+     * @endcode
+     */
+    constexpr bool hasPinConflict(const pinUsage *usages, unsigned int count)
+    {
+        return (count < 2) ? false : isHeaderPinUsed(usages[0].pin, usages + 1, count - 1) or hasPinConflict(usages + 1, count - 1);
+    }
+
+
+    /*! @brief Checks functions of a usage list at compile time.
+     *
+     * @param [in] usages   usage list
+     * @param [in] count    number of usages
+     * @return True if every pin of the list can take its function, else false.
+     */
+    constexpr bool isPinUsageValid(const pinUsage *usages, unsigned int count)
+    {
+        return (count == 0) ? true : isHeaderPinFunction(usages[0].pin, usages[0].function) and isPinUsageValid(usages + 1, count - 1);
+    }
+
+
+    static_assert( isHeaderPinTableOrdered(),                              "header pin table is broken" );
+    static_assert( findHeaderPinOfGpio(60) == HEADER_P9_12,                "header pin table is broken" );
+    static_assert( headerPinBank(HEADER_P8_07) == 2,                        "header pin table is broken" );
+    static_assert( headerPinBitMask(HEADER_P8_07) == (1u << 2),             "header pin table is broken" );
+
+    // gpio numbers of the P9_* macros of GPIO.h, which are kept as literals for C style users
+    static_assert( headerPinGpio(HEADER_P9_11) == 30 and headerPinGpio(HEADER_P9_12) == 60 and
+                   headerPinGpio(HEADER_P9_13) == 31 and headerPinGpio(HEADER_P9_15) == 48 and
+                   headerPinGpio(HEADER_P9_17) == 5  and headerPinGpio(HEADER_P9_18) == 4,  "GPIO.h pin numbers are broken" );
+
+    // pinmux offsets of BLACKLIB-SPI0-00A0.dts and BLACKLIB-SPI1-00A0.dts
+    static_assert( headerPinMuxOffset(HEADER_P9_22) == 0x150 and headerPinMuxOffset(HEADER_P9_21) == 0x154 and
+                   headerPinMuxOffset(HEADER_P9_18) == 0x158 and headerPinMuxOffset(HEADER_P9_17) == 0x15C, "spi0 pinmux is broken" );
+    static_assert( headerPinMuxOffset(HEADER_P9_31) == 0x190 and headerPinMuxOffset(HEADER_P9_29) == 0x194 and
+                   headerPinMuxOffset(HEADER_P9_30) == 0x198 and headerPinMuxOffset(HEADER_P9_28) == 0x19C, "spi1 pinmux is broken" );
+
+} /* namespace BlackLib */
+
+#endif /* BLACKPINS_H_ */
@@ -0,0 +1,571 @@
+#ifndef BLACKSOFTPWM_H_
+#define BLACKSOFTPWM_H_
+
+#include "BlackGPIO.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <cerrno>
+#include <time.h>           // need for clock_nanosleep() function
+#include <pthread.h>        // need for pwm thread
+#include <sched.h>          // need for SCHED_FIFO scheduling policy
+#include <sys/mman.h>       // need for mlockall() function
+
+namespace BlackLib
+{
+
+    /*! @brief Holds timing statistics of BlackSoftPWM.
+     *
+     *    Latency is the difference between the scheduled time of an edge and the time which the pwm
+     *    thread writes it. It is measured at @a nanosecond level.
+     */
+    struct softPwmStatistics
+    {
+        uint64_t    periods;                /*!< @brief number of periods since start */
+        uint64_t    writes;                 /*!< @brief number of bank writes (one per scheduled instant) */
+        uint64_t    writeErrors;            /*!< @brief number of failed writes */
+        uint64_t    missedPeriods;          /*!< @brief number of periods passed completely while the thread was late */
+        int64_t     minLatency;             /*!< @brief minimum edge latency */
+        int64_t     maxLatency;             /*!< @brief maximum edge latency */
+        int64_t     meanLatency;            /*!< @brief mean edge latency */
+        uint64_t    cpuTime;                /*!< @brief cpu time of the pwm thread, at nanosecond level */
+    };
+
+
+
+    // ########################################## BLACKSOFTPWM DECLARATION STARTS ######################################### //
+
+    /*! @brief Generates pwm outputs on any gpio pins with one thread.
+     *
+     *    All channels have the same period. At the start of every period, the thread builds the
+     *    schedule of the period from the duty values: channels are sorted by their duty time, and the
+     *    channels whose falling edges are closer than the merge window are grouped into one instant.
+     *    Then the thread drives all of the channels which have a non zero duty high with one port
+     *    write, and at every instant of the schedule it drives the channels of the instant low with
+     *    one port write. Port writes combine the channels of a bank into one write (see BlackGPIOPort),
+     *    so register backend is the best choice for many channels.
+     *
+     *    Duty values are atomic; setDutyTime() and setDutyPercent() can be called from any thread
+     *    without locks, and a new value is used from the next period.
+     *
+     *    The thread sleeps with clock_nanosleep() until each instant. With setSpinTime(), it wakes up
+     *    earlier and waits the last part of the gap by spinning, which decreases jitter and increases
+     *    cpu usage.
+     *
+     * @par Example
+     * @code{.cpp}
+     *   BlackLib::gpioName heaters[3] = { BlackLib::GPIO_66, BlackLib::GPIO_67, BlackLib::GPIO_68 };
+     *   BlackLib::BlackSoftPWM  softPwm(heaters, 3, 1000000, BlackLib::gpioRegisterBackend);    // 1 kHz
+     *
+     *   softPwm.setDutyPercent(0, 25.0);
+     *   softPwm.setDutyPercent(1, 50.0);
+     *   softPwm.setDutyPercent(2, 50.0);      // same instant with channel 1, one write
+     *   softPwm.start(80, true);              // SCHED_FIFO priority 80, locked memory
+     *
+     *   softPwm.setDutyPercent(0, 75.0);      // from any thread
+     *
+     *   BlackLib::softPwmStatistics stats = softPwm.getStatistics();
+     *   std::cout << "Max latency: " << stats.maxLatency << " ns";
+     * @endcode
+     */
+    class BlackSoftPWM
+    {
+        private:
+            BlackGPIOPort               *port;                  /*!< @brief is used to hold the output pins */
+            unsigned int                channelCount;           /*!< @brief is used to hold number of channels */
+            uint64_t                    periodTime;             /*!< @brief is used to hold the period at nanosecond level */
+            uint64_t                    mergeWindow;            /*!< @brief is used to hold maximum distance of edges of one instant */
+            std::atomic<uint64_t>       spinTime;               /*!< @brief is used to hold spinning time before each instant */
+            std::atomic<uint64_t>       dutyTimes[32];          /*!< @brief is used to hold duty values at nanosecond level */
+            std::atomic<bool>           isActive;               /*!< @brief is used to hold the thread state */
+            pthread_t                   pwmThread;              /*!< @brief is used to hold the pwm thread */
+            bool                        isJoinable;             /*!< @brief is used to hold whether pwm thread is waiting for join */
+
+            uint64_t                    scheduleTimes[32];      /*!< @brief is used to hold instants of the period, thread private */
+            uint32_t                    scheduleMasks[32];      /*!< @brief is used to hold channels of each instant, thread private */
+            unsigned int                scheduleLength;         /*!< @brief is used to hold number of instants, thread private */
+            uint32_t                    startMask;              /*!< @brief is used to hold channels which are high at period start, thread private */
+
+            std::atomic<uint64_t>       periods;                /*!< @brief is used to hold softPwmStatistics::periods */
+            std::atomic<uint64_t>       writes;                 /*!< @brief is used to hold softPwmStatistics::writes */
+            std::atomic<uint64_t>       writeErrors;            /*!< @brief is used to hold softPwmStatistics::writeErrors */
+            std::atomic<uint64_t>       missedPeriods;          /*!< @brief is used to hold softPwmStatistics::missedPeriods */
+            std::atomic<int64_t>        minLatency;             /*!< @brief is used to hold softPwmStatistics::minLatency */
+            std::atomic<int64_t>        maxLatency;             /*!< @brief is used to hold softPwmStatistics::maxLatency */
+            std::atomic<int64_t>        totalLatency;           /*!< @brief is used to hold sum of latencies */
+            std::atomic<uint64_t>       cpuTime;                /*!< @brief is used to hold softPwmStatistics::cpuTime */
+
+            /*! @brief Copying is not allowed, because the object owns the port and the thread.
+            */
+                                        BlackSoftPWM(const BlackSoftPWM &);
+
+            /*! @brief Copying is not allowed, because the object owns the port and the thread.
+            */
+            BlackSoftPWM                &operator=(const BlackSoftPWM &);
+
+            /*! @brief Builds schedule of the next period from duty values.
+            */
+            void                        buildSchedule();
+
+            /*! @brief Waits until @a target time, with sleeping and spinning.
+            *
+            *  @param [in] target       CLOCK_MONOTONIC time at nanosecond level
+            *  @param [out] latency     latency of wake up at nanosecond level
+            *  @return True if waiting is successful, false if clock_nanosleep() fails with an error other than EINTR.
+            */
+            bool                        waitUntil(uint64_t target, int64_t &latency);
+
+            /*! @brief Updates statistics after a port write.
+            *
+            *  @param [in] latency      latency of the write
+            *  @param [in] isWritten    result of the write
+            */
+            void                        countWrite(int64_t latency, bool isWritten);
+
+            /*! @brief Reads CLOCK_MONOTONIC time.
+            *
+            *  @return Time at nanosecond level.
+            */
+            static uint64_t             monotonicTime();
+
+            /*! @brief Thread function, which runs pwmLoop().
+            */
+            static void                 *threadEntry(void *object);
+
+            /*! @brief Generates periods until stop() is called.
+            */
+            void                        pwmLoop();
+
+        public:
+            /*! @brief Constructor of BlackSoftPWM class.
+            *
+            *  This function creates an output BlackGPIOPort of the pins. Maximum 32 channels can be
+            *  used; the rest of the entered pins are ignored. All duty values start at zero.
+            *  @param [in] pins         gpio pin names (enum array), channel i is @a pins[i]
+            *  @param [in] count        number of entered pin names
+            *  @param [in] period       period of all channels at nanosecond level
+            *  @param [in] backend      hardware access way of the port (enum), default value is gpioAutoBackend
+            *  @param [in] merge        edges which are closer than this value (at nanosecond level) are
+            *  written together, default value is 1000
+            */
+                                        BlackSoftPWM(const gpioName *pins, unsigned int count, uint64_t period,
+                                                     gpioBackend backend = gpioAutoBackend, uint64_t merge = 1000);
+
+            /*! @brief Destructor of BlackSoftPWM class.
+            *
+            *  This function stops the thread, drives all channels low and deletes the port.
+            */
+            virtual                     ~BlackSoftPWM();
+
+            /*! @brief Sets duty time of a channel.
+            *
+            *  This function is lock free.
+            *  @param [in] channel      channel number
+            *  @param [in] duty         high time at nanosecond level, values bigger than period mean always high
+            *  @return True if setting is successful, else false.
+            */
+            bool                        setDutyTime(unsigned int channel, uint64_t duty);
+
+            /*! @brief Sets duty percentage of a channel.
+            *
+            *  This function is lock free.
+            *  @param [in] channel      channel number
+            *  @param [in] percentage   high time percentage (0 - 100)
+            *  @return True if setting is successful, else false.
+            */
+            bool                        setDutyPercent(unsigned int channel, float percentage);
+
+            /*! @brief Exports duty time of a channel.
+            *
+            *  @param [in] channel      channel number
+            *  @return Duty time at nanosecond level.
+            */
+            uint64_t                    getDutyTime(unsigned int channel);
+
+            /*! @brief Exports number of channels.
+            *
+            *  @return Number of channels.
+            */
+            unsigned int                getChannelCount();
+
+            /*! @brief Sets spinning time before each instant.
+            *
+            *  @param [in] spin         spinning time at nanosecond level, 0 means only sleeping
+            */
+            void                        setSpinTime(uint64_t spin);
+
+            /*! @brief Starts pwm thread.
+            *
+            *  @param [in] priority     SCHED_FIFO priority of the thread (1-99), 0 uses normal scheduling
+            *  @param [in] lockMemory   if it is true, all pages of the process are locked with mlockall()
+            *  @return True if thread is started, else false. Real time scheduling needs root or CAP_SYS_NICE.
+            *  @note The thread drives all channels low, exits by itself and isRunning() turns false, if
+            *  clock_nanosleep() fails with an error other than EINTR.
+            */
+            bool                        start(int priority = 0, bool lockMemory = false);
+
+            /*! @brief Stops pwm thread, waits for it and drives all channels low.
+            */
+            void                        stop();
+
+            /*! @brief Checks state of pwm thread.
+            *
+            *  @return True if pwm thread is running, else false.
+            */
+            bool                        isRunning();
+
+            /*! @brief Exports timing statistics.
+            *
+            *  @return Statistics since last start().
+            *  @sa softPwmStatistics
+            */
+            softPwmStatistics           getStatistics();
+
+            /*! @brief Is used for general debugging.
+            *
+            *  @return True if any pin of the port failed, else false.
+            *  @sa BlackGPIOPort::fail()
+            */
+            bool                        fail();
+    };
+    // ########################################### BLACKSOFTPWM DECLARATION ENDS ########################################## //
+
+
+
+
+
+    // ########################################### BLACKSOFTPWM DEFINITION STARTS ######################################### //
+    BlackSoftPWM::BlackSoftPWM(const gpioName *pins, unsigned int count, uint64_t period, gpioBackend backend, uint64_t merge)
+    {
+        this->channelCount      = (count > 32) ? 32 : count;
+        this->port              = new BlackGPIOPort(pins, this->channelCount, output, backend);
+        this->periodTime        = (period == 0) ? 1 : period;
+        this->mergeWindow       = merge;
+        this->spinTime          = 0;
+        this->isActive          = false;
+        this->isJoinable        = false;
+        this->scheduleLength    = 0;
+        this->startMask         = 0;
+
+        for( unsigned int channel = 0 ; channel < 32 ; channel++ )
+        {
+            this->dutyTimes[channel] = 0;
+        }
+
+        this->periods           = 0;
+        this->writes            = 0;
+        this->writeErrors       = 0;
+        this->missedPeriods     = 0;
+        this->minLatency        = 0;
+        this->maxLatency        = 0;
+        this->totalLatency      = 0;
+        this->cpuTime           = 0;
+    }
+
+    BlackSoftPWM::~BlackSoftPWM()
+    {
+        this->stop();
+        delete this->port;
+    }
+
+    bool        BlackSoftPWM::setDutyTime(unsigned int channel, uint64_t duty)
+    {
+        if( channel >= this->channelCount )
+        {
+            return false;
+        }
+
+        uint64_t limited = (duty > this->periodTime) ? this->periodTime : duty;
+        this->dutyTimes[channel].store(limited, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool        BlackSoftPWM::setDutyPercent(unsigned int channel, float percentage)
+    {
+        if( percentage < 0.0 or percentage > 100.0 )
+        {
+            return false;
+        }
+
+        return this->setDutyTime(channel, static_cast<uint64_t>( this->periodTime * (percentage / 100.0) ));
+    }
+
+    uint64_t    BlackSoftPWM::getDutyTime(unsigned int channel)
+    {
+        return (channel < this->channelCount) ? this->dutyTimes[channel].load(std::memory_order_relaxed) : 0;
+    }
+
+    unsigned int BlackSoftPWM::getChannelCount()
+    {
+        return this->channelCount;
+    }
+
+    void        BlackSoftPWM::setSpinTime(uint64_t spin)
+    {
+        this->spinTime.store(spin, std::memory_order_relaxed);
+    }
+
+    void        BlackSoftPWM::buildSchedule()
+    {
+        uint64_t        duties[32];
+        unsigned int    order[32];
+        unsigned int    sortedCount = 0;
+
+        this->startMask = 0;
+
+        // insertion sort of the channels which fall inside the period
+        for( unsigned int channel = 0 ; channel < this->channelCount ; channel++ )
+        {
+            uint64_t duty = this->dutyTimes[channel].load(std::memory_order_relaxed);
+            if( duty == 0 )
+            {
+                continue;
+            }
+
+            this->startMask |= (1u << channel);
+            if( duty >= this->periodTime )
+            {
+                continue;
+            }
+
+            unsigned int position = sortedCount++;
+            while( position > 0 and duties[position - 1] > duty )
+            {
+                duties[position]    = duties[position - 1];
+                order[position]     = order[position - 1];
+                position--;
+            }
+            duties[position]    = duty;
+            order[position]     = channel;
+        }
+
+        // close edges are one instant, which is written at the time of its first edge
+        this->scheduleLength = 0;
+        for( unsigned int i = 0 ; i < sortedCount ; i++ )
+        {
+            if( this->scheduleLength > 0 and duties[i] - this->scheduleTimes[this->scheduleLength - 1] <= this->mergeWindow )
+            {
+                this->scheduleMasks[this->scheduleLength - 1] |= (1u << order[i]);
+                continue;
+            }
+
+            this->scheduleTimes[this->scheduleLength]  = duties[i];
+            this->scheduleMasks[this->scheduleLength]  = (1u << order[i]);
+            this->scheduleLength++;
+        }
+    }
+
+    uint64_t    BlackSoftPWM::monotonicTime()
+    {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+    }
+
+    bool        BlackSoftPWM::waitUntil(uint64_t target, int64_t &latency)
+    {
+        uint64_t spin       = this->spinTime.load(std::memory_order_relaxed);
+        uint64_t wakeTime   = (target > spin) ? target - spin : 0;
+
+        timespec deadline;
+        deadline.tv_sec     = static_cast<time_t>(wakeTime / 1000000000ULL);
+        deadline.tv_nsec    = static_cast<long>(wakeTime % 1000000000ULL);
+
+        int sleepResult;
+        while( (sleepResult = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL)) == EINTR )
+        {
+            // interrupted by a signal, sleep again to same deadline.
+        }
+
+        if( sleepResult != 0 )
+        {
+            return false;
+        }
+
+        uint64_t now = BlackSoftPWM::monotonicTime();
+        while( now < target )
+        {
+            now = BlackSoftPWM::monotonicTime();
+        }
+
+        latency = static_cast<int64_t>(now - target);
+        return true;
+    }
+
+    void        BlackSoftPWM::countWrite(int64_t latency, bool isWritten)
+    {
+        if( latency < this->minLatency.load(std::memory_order_relaxed) or this->writes.load(std::memory_order_relaxed) == 0 )
+        {
+            this->minLatency.store(latency, std::memory_order_relaxed);
+        }
+        if( latency > this->maxLatency.load(std::memory_order_relaxed) )
+        {
+            this->maxLatency.store(latency, std::memory_order_relaxed);
+        }
+
+        this->totalLatency.fetch_add(latency, std::memory_order_relaxed);
+        this->writes.fetch_add(1, std::memory_order_relaxed);
+
+        if( ! isWritten )
+        {
+            this->writeErrors.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void        *BlackSoftPWM::threadEntry(void *object)
+    {
+        static_cast<BlackSoftPWM *>(object)->pwmLoop();
+        return NULL;
+    }
+
+    void        BlackSoftPWM::pwmLoop()
+    {
+        uint64_t periodStart = BlackSoftPWM::monotonicTime() + this->periodTime;
+
+        while( this->isActive.load(std::memory_order_relaxed) )
+        {
+            // schedule is built while waiting the period start
+            this->buildSchedule();
+
+            int64_t latency;
+            if( ! this->waitUntil(periodStart, latency) )
+            {
+                break;
+            }
+            this->countWrite( latency, this->port->setValues(this->startMask) );
+
+            bool isWaited = true;
+            for( unsigned int i = 0 ; i < this->scheduleLength and isWaited ; i++ )
+            {
+                isWaited = this->waitUntil(periodStart + this->scheduleTimes[i], latency);
+                if( isWaited )
+                {
+                    this->countWrite( latency, this->port->clearBits(this->scheduleMasks[i]) );
+                }
+            }
+
+            if( ! isWaited )
+            {
+                break;
+            }
+
+            this->periods.fetch_add(1, std::memory_order_relaxed);
+            periodStart += this->periodTime;
+
+            // only periods which passed completely are skipped; if the thread is just late, next period starts at once.
+            uint64_t now = BlackSoftPWM::monotonicTime();
+            if( now > periodStart )
+            {
+                uint64_t passed = (now - periodStart) / this->periodTime;
+                if( passed > 0 )
+                {
+                    periodStart += passed * this->periodTime;
+                    this->missedPeriods.fetch_add(passed, std::memory_order_relaxed);
+                }
+            }
+
+            timespec threadTime;
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &threadTime);
+            this->cpuTime.store( static_cast<uint64_t>(threadTime.tv_sec) * 1000000000ULL + static_cast<uint64_t>(threadTime.tv_nsec),
+                                 std::memory_order_relaxed );
+        }
+
+        // sleep errors are not transient, the loop is left instead of spinning and channels are not kept high.
+        if( this->isActive.exchange(false) )
+        {
+            this->port->setValues(0);
+        }
+    }
+
+    bool        BlackSoftPWM::start(int priority, bool lockMemory)
+    {
+        if( this->isActive.load() )
+        {
+            return false;
+        }
+
+        // thread of previous run may be exited by itself after a sleep error.
+        if( this->isJoinable )
+        {
+            pthread_join(this->pwmThread, NULL);
+            this->isJoinable = false;
+        }
+
+        if( lockMemory and mlockall(MCL_CURRENT | MCL_FUTURE) != 0 )
+        {
+            return false;
+        }
+
+        this->periods       = 0;
+        this->writes        = 0;
+        this->writeErrors   = 0;
+        this->missedPeriods = 0;
+        this->minLatency    = 0;
+        this->maxLatency    = 0;
+        this->totalLatency  = 0;
+        this->cpuTime       = 0;
+
+        pthread_attr_t attributes;
+        pthread_attr_init(&attributes);
+
+        if( priority > 0 )
+        {
+            sched_param parameter;
+            parameter.sched_priority = priority;
+            pthread_attr_setinheritsched(&attributes, PTHREAD_EXPLICIT_SCHED);
+            pthread_attr_setschedpolicy(&attributes, SCHED_FIFO);
+            pthread_attr_setschedparam(&attributes, &parameter);
+        }
+
+        this->isActive = true;
+        if( pthread_create(&this->pwmThread, &attributes, &BlackSoftPWM::threadEntry, this) != 0 )
+        {
+            this->isActive = false;
+            pthread_attr_destroy(&attributes);
+            return false;
+        }
+
+        pthread_attr_destroy(&attributes);
+        this->isJoinable = true;
+        return true;
+    }
+
+    void        BlackSoftPWM::stop()
+    {
+        this->isActive.store(false);
+        if( this->isJoinable )
+        {
+            pthread_join(this->pwmThread, NULL);
+            this->isJoinable = false;
+            this->port->setValues(0);
+        }
+    }
+
+    bool        BlackSoftPWM::isRunning()
+    {
+        return this->isActive.load();
+    }
+
+    softPwmStatistics BlackSoftPWM::getStatistics()
+    {
+        softPwmStatistics stats;
+        stats.periods       = this->periods.load();
+        stats.writes        = this->writes.load();
+        stats.writeErrors   = this->writeErrors.load();
+        stats.missedPeriods = this->missedPeriods.load();
+        stats.minLatency    = this->minLatency.load();
+        stats.maxLatency    = this->maxLatency.load();
+        stats.meanLatency   = (stats.writes == 0) ? 0 : static_cast<int64_t>(this->totalLatency.load() / static_cast<int64_t>(stats.writes));
+        stats.cpuTime       = this->cpuTime.load();
+        return stats;
+    }
+
+    bool        BlackSoftPWM::fail()
+    {
+        return this->port->fail();
+    }
+    // ############################################ BLACKSOFTPWM DEFINITION ENDS ########################################## //
+
+} /* namespace BlackLib */
+
+#endif /* BLACKSOFTPWM_H_ */
@@ -13,6 +13,7 @@
 #define POLL_TIMEOUT (3 * 1000) /* 3 seconds */
 #define MAX_BUF 64
 
+/* gpio numbers of header pins, BlackPins.h checks them against its pin table */
 #define P9_11 30
 #define P9_12 60
 #define P9_13 31
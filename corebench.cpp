@@ -0,0 +1,136 @@
+
+#include "BlackCore.h"
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <time.h>
+#include <sys/stat.h>
+
+// Benchmarks of BlackCore system access against a stand-in capemgr directory on tmpfs (/dev/shm).
+// Command latency is measured with a small and with a large (memory heavy) calling process, because
+// cost of fork() grows with the memory of the caller (popen() of older C libraries forks the caller).
+
+const std::string   benchRoot   = "/dev/shm/blacklib_corebench";
+const int           iterations  = 200;
+const size_t        ballastSize = 256 * 1024 * 1024;
+
+
+double elapsedNs(const timespec &start, const timespec &end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+}
+
+void makeStandInTree()
+{
+    mkdir(benchRoot.c_str(), 0755);
+    mkdir((benchRoot + "/sys").c_str(), 0755);
+    mkdir((benchRoot + "/sys/devices").c_str(), 0755);
+    mkdir((benchRoot + "/sys/devices/bone_capemgr.9").c_str(), 0755);
+    mkdir((benchRoot + "/sys/devices/ocp.3").c_str(), 0755);
+
+    std::ofstream slots((benchRoot + "/sys/devices/bone_capemgr.9/slots").c_str(), std::ios::out | std::ios::trunc);
+    slots << " 0: 54:PF--- \n"
+          << " 1: 55:PF--- \n"
+          << " 2: 56:PF--- \n"
+          << " 3: 57:PF--- \n"
+          << " 4: ff:P-O-L Bone-LT-eMMC-2G,00A0,Texas Instrument,BB-BONE-EMMC-2G\n"
+          << " 5: ff:P-O-- Bone-Black-HDMI,00A0,Texas Instrument,BB-BONELT-HDMI\n"
+          << " 7: ff:P-O-L Override Board Name,00A0,Override Manuf,am33xx_pwm\n";
+}
+
+// BlackCore is abstract, this class exports its protected system access functions to the benchmark.
+class BenchCore : public BlackLib::BlackCore
+{
+    private:
+        bool            loadDeviceTree() { return true; }
+
+    public:
+        std::string     runCommand(const std::string &command)  { return this->executeCommand(command); }
+        std::string     slots()                                 { return this->listSlots(); }
+        std::string     slotsPath()                             { return this->getSlotsFilePath(); }
+};
+
+// Old BlackCore::executeCommand() behaviour: popen() with shell, fgets() of 128 bytes until feof().
+std::string legacyExecuteCommand(const std::string &command)
+{
+    FILE* pipe = popen(command.c_str(), "r");
+    if ( pipe==NULL )
+    {
+        return "ERROR";
+    }
+
+    char buffer[128];
+    std::string result = "";
+
+    while( !feof(pipe) )
+    {
+        if( fgets(buffer, 128, pipe) != NULL )
+        {
+            result += buffer;
+        }
+    }
+
+    pclose(pipe);
+    return result;
+}
+
+void benchmark_SlotsListing(BenchCore &core, const char *title)
+{
+    std::string command = "cat " + core.slotsPath();
+    std::string popenResult, spawnResult, readResult;
+    timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        popenResult = legacyExecuteCommand(command);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double popenNs = elapsedNs(start, end) / iterations;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        spawnResult = core.runCommand(command);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double spawnNs = elapsedNs(start, end) / iterations;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        readResult = core.slots();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double readNs = elapsedNs(start, end) / iterations;
+
+    std::cout << title << std::endl;
+    std::cout << "  slots listing, popen() + shell:   \t" << popenNs / 1000 << " us/call" << std::endl;
+    std::cout << "  slots listing, posix_spawnp():    \t" << spawnNs / 1000 << " us/call" << std::endl;
+    std::cout << "  slots listing, in process:        \t" << readNs / 1000 << " us/call" << std::endl;
+    std::cout << "  same output:                      \t" << std::boolalpha
+              << (popenResult == spawnResult and spawnResult == readResult) << std::endl;
+}
+
+int main()
+{
+    makeStandInTree();
+    BlackLib::BlackCore::setFilesystemRoot(benchRoot);
+
+    BenchCore core;
+    benchmark_SlotsListing(core, "small process:");
+
+    // touched memory makes page tables of the process large, like a control process with big buffers
+    char *ballast = static_cast<char *>(malloc(ballastSize));
+    for( size_t i = 0 ; i < ballastSize ; i += 4096 )
+    {
+        ballast[i] = static_cast<char>(i);
+    }
+
+    benchmark_SlotsListing(core, "process with 256 MB resident memory:");
+
+    free(ballast);
+    return 0;
+}
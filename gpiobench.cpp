@@ -0,0 +1,1251 @@
+
+#include "BlackGPIO.h"
+#include "BlackGPIOEvent.h"
+#include "BlackGPIODebounce.h"
+#include "BlackSoftPWM.h"
+#include "BlackPins.h"
+#include "BlackGPIOPulse.h"
+#include "BlackGPIOEncoder.h"
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <time.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <poll.h>
+#include <pthread.h>
+#include <atomic>
+#include <map>
+#include <vector>
+#include <sys/eventfd.h>
+
+// Benchmarks of BlackGPIO against a stand-in sysfs tree. The tree is created on tmpfs (/dev/shm)
+// with the same layout as /sys/class/gpio, so it can run off-board. A sparse regular file stands in
+// for /dev/mem, so register backend writes can be checked by reading the file back. Edge events are
+// simulated with pipes, because regular files of the stand-in tree can not be polled. The gpiochip
+// character devices are simulated by a fake BlackGPIOChipDevice, which keeps line values in memory
+// and hands out pipes as line request descriptors.
+
+const std::string   benchRoot   = "/dev/shm/blacklib_gpiobench";
+const int           iterations  = 200000;
+
+// 16 bit parallel bus: GPIO_32..GPIO_39 (bank 1, bits 0-7) and GPIO_66..GPIO_73 (bank 2, bits 2-9)
+const int           portWidth   = 16;
+const BlackLib::gpioName portPins[portWidth] = {
+    BlackLib::GPIO_32, BlackLib::GPIO_33, BlackLib::GPIO_34, BlackLib::GPIO_35,
+    BlackLib::GPIO_36, BlackLib::GPIO_37, BlackLib::GPIO_38, BlackLib::GPIO_39,
+    BlackLib::GPIO_66, BlackLib::GPIO_67, BlackLib::GPIO_68, BlackLib::GPIO_69,
+    BlackLib::GPIO_70, BlackLib::GPIO_71, BlackLib::GPIO_72, BlackLib::GPIO_73 };
+
+// 32 software pwm channels: GPIO_66..GPIO_81 (bank 2), GPIO_32..GPIO_39 and GPIO_44..GPIO_51 (bank 1)
+const int           pwmWidth    = 32;
+const BlackLib::gpioName pwmPins[pwmWidth] = {
+    BlackLib::GPIO_66, BlackLib::GPIO_67, BlackLib::GPIO_68, BlackLib::GPIO_69,
+    BlackLib::GPIO_70, BlackLib::GPIO_71, BlackLib::GPIO_72, BlackLib::GPIO_73,
+    BlackLib::GPIO_74, BlackLib::GPIO_75, BlackLib::GPIO_76, BlackLib::GPIO_77,
+    BlackLib::GPIO_78, BlackLib::GPIO_79, BlackLib::GPIO_80, BlackLib::GPIO_81,
+    BlackLib::GPIO_32, BlackLib::GPIO_33, BlackLib::GPIO_34, BlackLib::GPIO_35,
+    BlackLib::GPIO_36, BlackLib::GPIO_37, BlackLib::GPIO_38, BlackLib::GPIO_39,
+    BlackLib::GPIO_44, BlackLib::GPIO_45, BlackLib::GPIO_46, BlackLib::GPIO_47,
+    BlackLib::GPIO_48, BlackLib::GPIO_49, BlackLib::GPIO_50, BlackLib::GPIO_51 };
+
+
+double elapsedNs(const timespec &start, const timespec &end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+}
+
+void writeStandInFile(const std::string &path, const std::string &value)
+{
+    std::ofstream file(path.c_str(), std::ios::out | std::ios::trunc);
+    file << value << std::endl;
+}
+
+void makeStandInTree()
+{
+    std::string gpioClass = benchRoot + "/sys/class/gpio/";
+
+    mkdir(benchRoot.c_str(), 0755);
+    mkdir((benchRoot + "/sys").c_str(), 0755);
+    mkdir((benchRoot + "/sys/class").c_str(), 0755);
+    mkdir(gpioClass.c_str(), 0755);
+
+    writeStandInFile(gpioClass + "export",   "");
+    writeStandInFile(gpioClass + "unexport", "");
+
+    // sparse stand-in of /dev/mem, which covers the four GPIO bank register windows
+    mkdir((benchRoot + "/dev").c_str(), 0755);
+    int memFd = open((benchRoot + "/dev/mem").c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if( memFd >= 0 )
+    {
+        if( ftruncate(memFd, 0x481AF000) != 0 )
+        {
+            perror("ftruncate");
+        }
+        close(memFd);
+    }
+
+    // gpiochip devices exist, so gpioAutoBackend selects gpiochip backend (served by FakeChipDevice)
+    for( int chip = 0 ; chip < 4 ; chip++ )
+    {
+        writeStandInFile(benchRoot + "/dev/gpiochip" + BlackLib::tostr(chip), "");
+    }
+
+    // pins are shown as already exported
+    const int pins[3] = { 60, 48, 49 };
+    for( int i = 0 ; i < 3 + portWidth + pwmWidth ; i++ )
+    {
+        int number = (i < 3) ? pins[i] : (i < 3 + portWidth) ? portPins[i - 3] : pwmPins[i - 3 - portWidth];
+        std::string pin = gpioClass + "gpio" + BlackLib::tostr(number) + "/";
+        mkdir(pin.c_str(), 0755);
+
+        writeStandInFile(pin + "value",     "0");
+        writeStandInFile(pin + "direction", "in");
+        writeStandInFile(pin + "edge",      "none");
+    }
+}
+
+// Old GPIO.h gpio_set_value() behaviour: snprintf() path, open(), write() and close() per call.
+int legacySetValue(unsigned int gpio, int value)
+{
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s/sys/class/gpio/gpio%d/value", benchRoot.c_str(), gpio);
+
+    int fd = open(buf, O_WRONLY);
+    if (fd < 0) {
+        return fd;
+    }
+
+    ssize_t written = write(fd, (value == 0) ? "0" : "1", 2);
+    close(fd);
+    return (written == 2) ? 0 : -1;
+}
+
+void benchmark_Toggle()
+{
+    timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        legacySetValue(60, i & 1);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double legacyNs = elapsedNs(start, end) / iterations;
+
+
+    BlackLib::BlackGPIO secureLed(BlackLib::GPIO_60, BlackLib::output, BlackLib::secureMode, BlackLib::gpioSysfsBackend);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        secureLed.setValue( (i & 1) ? BlackLib::high : BlackLib::low );
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double secureNs = elapsedNs(start, end) / iterations;
+
+
+    BlackLib::BlackGPIO fastLed(BlackLib::GPIO_60, BlackLib::output, BlackLib::fastMode, BlackLib::gpioSysfsBackend);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        fastLed.setValue( (i & 1) ? BlackLib::high : BlackLib::low );
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double fastNs = elapsedNs(start, end) / iterations;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        fastLed.toggleValue();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double toggleNs = elapsedNs(start, end) / iterations;
+
+    // a full period is two writes
+    std::cout << "gpio_set_value (open/write/close):  \t" << legacyNs << " ns/call, " << 1e6 / (2 * legacyNs) << " kHz" << std::endl;
+    std::cout << "BlackGPIO::setValue, secureMode:    \t" << secureNs << " ns/call, " << 1e6 / (2 * secureNs) << " kHz" << std::endl;
+    std::cout << "BlackGPIO::setValue, fastMode:      \t" << fastNs   << " ns/call, " << 1e6 / (2 * fastNs)   << " kHz" << std::endl;
+    std::cout << "BlackGPIO::toggleValue, fastMode:   \t" << toggleNs << " ns/call, " << 1e6 / (2 * toggleNs) << " kHz" << std::endl;
+    std::cout << "Error state after benchmark: \t\t" << std::boolalpha << (secureLed.fail() or fastLed.fail()) << std::endl;
+}
+
+void benchmark_Read()
+{
+    BlackLib::BlackGPIO button(BlackLib::GPIO_48, BlackLib::input, BlackLib::fastMode, BlackLib::gpioSysfsBackend);
+    volatile int sink = 0;
+    timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        sink = button.getNumericValue();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    (void)sink;
+
+    bool isRejected = ! button.setValue(BlackLib::high);
+
+    std::cout << "BlackGPIO::getNumericValue, fast:   \t" << elapsedNs(start, end) / iterations << " ns/call" << std::endl;
+    std::cout << "Input pin write rejected: \t\t" << std::boolalpha << (isRejected and button.fail(BlackLib::BlackGPIO::forcingErr)) << std::endl;
+}
+
+uint32_t readStandInRegister(uint32_t address)
+{
+    uint32_t value = 0;
+    int memFd = open((benchRoot + "/dev/mem").c_str(), O_RDONLY);
+    if( memFd >= 0 )
+    {
+        if( pread(memFd, &value, sizeof(value), address) != sizeof(value) )
+        {
+            value = 0;
+        }
+        close(memFd);
+    }
+    return value;
+}
+
+void benchmark_Register()
+{
+    const uint32_t bank1 = 0x4804C000;
+    timespec start, end;
+
+    // GPIO_49 is bank 1 bit 17, GPIO_48 is bank 1 bit 16
+    BlackLib::BlackGPIO clock(BlackLib::GPIO_49, BlackLib::output, BlackLib::fastMode, BlackLib::gpioRegisterBackend);
+    BlackLib::BlackGPIO data(BlackLib::GPIO_48, BlackLib::input, BlackLib::fastMode, BlackLib::gpioRegisterBackend);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        clock.setValue( (i & 1) ? BlackLib::high : BlackLib::low );
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double registerNs = elapsedNs(start, end) / iterations;
+
+    clock.setValue(BlackLib::high);
+    uint32_t setPattern     = readStandInRegister(bank1 + 0x194);
+    clock.setValue(BlackLib::low);
+    uint32_t clearPattern   = readStandInRegister(bank1 + 0x190);
+    uint32_t oePattern      = readStandInRegister(bank1 + 0x134);
+
+    std::cout << "BlackGPIO::setValue, register:      \t" << registerNs << " ns/call, " << 1e6 / (2 * registerNs) << " kHz" << std::endl;
+    std::printf("GPIO1 SETDATAOUT / CLEARDATAOUT:    \t0x%08x / 0x%08x (expected 0x00020000)\n", setPattern, clearPattern);
+    std::printf("GPIO1 OE:                           \t0x%08x (expected 0x00010000)\n", oePattern);
+    std::cout << "Register pins ready: \t\t\t" << std::boolalpha << (clock.isReady() and data.isReady()) << std::endl;
+}
+
+void benchmark_Port()
+{
+    const int portIterations = iterations / 16;
+    timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < portIterations ; i++ )
+    {
+        for( int bit = 0 ; bit < portWidth ; bit++ )
+        {
+            legacySetValue(portPins[bit], (i >> bit) & 1);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double legacyNs = elapsedNs(start, end) / portIterations;
+
+    BlackLib::BlackGPIOPort sysfsBus(portPins, portWidth, BlackLib::output, BlackLib::gpioSysfsBackend);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < portIterations ; i++ )
+    {
+        sysfsBus.setValues(i);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double sysfsNs = elapsedNs(start, end) / portIterations;
+
+    sysfsBus.setValues(0xA5C3);
+    bool isSysfsReadBack = ( sysfsBus.getValues() == 0xA5C3 );
+
+    BlackLib::BlackGPIOPort registerBus(portPins, portWidth, BlackLib::output, BlackLib::gpioRegisterBackend);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        registerBus.setValues(i);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double registerNs = elapsedNs(start, end) / iterations;
+
+    // mixed word is one SETDATAOUT and one CLEARDATAOUT store per bank by default
+    registerBus.setValues(0xA5C3);
+    uint32_t bank2SetMixed      = readStandInRegister(0x481AC000 + 0x194);
+    uint32_t bank2ClearMixed    = readStandInRegister(0x481AC000 + 0x190);
+
+    // same cycle write goes to DATAOUT, so stand-in file shows the levels
+    registerBus.setSameCycleWrite(true);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        registerBus.setValues(i);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double sameCycleNs = elapsedNs(start, end) / iterations;
+
+    registerBus.setValues(0xA5C3);
+    bool isRegisterReadBack = ( registerBus.getValues() == 0xA5C3 );
+    registerBus.setSameCycleWrite(false);
+    uint32_t bank1DataOut   = readStandInRegister(0x4804C000 + 0x13C);
+    uint32_t bank2DataOut   = readStandInRegister(0x481AC000 + 0x13C);
+
+    registerBus.setBits(0x0100);
+    uint32_t bank2Set       = readStandInRegister(0x481AC000 + 0x194);
+
+    std::cout << "16 x gpio_set_value:                \t" << legacyNs / 1000 << " us/word" << std::endl;
+    std::cout << "BlackGPIOPort::setValues, sysfs:    \t" << sysfsNs / 1000 << " us/word" << std::endl;
+    std::cout << "BlackGPIOPort::setValues, register: \t" << registerNs << " ns/word, same cycle write " << sameCycleNs << " ns/word" << std::endl;
+    std::printf("GPIO2 SETDATAOUT / CLEARDATAOUT:    \t0x%08x / 0x%08x (expected 0x00000294 / 0x00000168)\n", bank2SetMixed, bank2ClearMixed);
+    std::printf("GPIO1 / GPIO2 DATAOUT:              \t0x%08x / 0x%08x (expected 0x000000c3 / 0x00000294)\n", bank1DataOut, bank2DataOut);
+    std::printf("GPIO2 SETDATAOUT after setBits:     \t0x%08x (expected 0x00000004)\n", bank2Set);
+    std::cout << "Port read back: \t\t\t" << std::boolalpha << (isSysfsReadBack and isRegisterReadBack)
+              << ", errors: " << (sysfsBus.fail() or registerBus.fail()) << std::endl;
+}
+
+// Old single-fd style: every input is polled on its own with zero timeout, ready ones are read.
+int legacyScanInputs(const int *fds, int count)
+{
+    int found = 0;
+    char buffer[64];
+
+    for( int i = 0 ; i < count ; i++ )
+    {
+        pollfd request;
+        request.fd      = fds[i];
+        request.events  = POLLIN;
+
+        if( poll(&request, 1, 0) == 1 and read(fds[i], buffer, sizeof(buffer)) > 0 )
+        {
+            found++;
+        }
+    }
+
+    return found;
+}
+
+void benchmark_Events()
+{
+    const int sourceCount   = 256;
+    const int edgesPerRound = 32;
+    const int rounds        = 2000;
+
+    int readFds[sourceCount];
+    int writeFds[sourceCount];
+    for( int i = 0 ; i < sourceCount ; i++ )
+    {
+        int pipeFds[2];
+        if( pipe(pipeFds) != 0 )
+        {
+            perror("pipe");
+            return;
+        }
+        readFds[i]  = pipeFds[0];
+        writeFds[i] = pipeFds[1];
+    }
+
+    timespec start, end;
+    int legacyFound = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int round = 0 ; round < rounds ; round++ )
+    {
+        for( int i = 0 ; i < edgesPerRound ; i++ )
+        {
+            legacyFound += ( write(writeFds[(round * 7 + i * 8) % sourceCount], "1\n", 2) == 2 ) ? 0 : -1;
+        }
+        legacyFound += legacyScanInputs(readFds, sourceCount);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double legacyNs = elapsedNs(start, end) / rounds;
+
+    BlackLib::BlackGPIOEventEngine engine(sourceCount);
+    for( int i = 0 ; i < sourceCount ; i++ )
+    {
+        engine.addDescriptor(readFds[i], 1000 + i);
+    }
+
+    BlackLib::gpioEvent event;
+    int engineFound = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int round = 0 ; round < rounds ; round++ )
+    {
+        for( int i = 0 ; i < edgesPerRound ; i++ )
+        {
+            engineFound += ( write(writeFds[(round * 7 + i * 8) % sourceCount], "1\n", 2) == 2 ) ? 0 : -1;
+        }
+
+        engine.processEvents(-1);
+        while( engine.getEvent(event) )
+        {
+            engineFound++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double engineNs = elapsedNs(start, end) / rounds;
+
+    std::cout << sourceCount << " inputs, " << edgesPerRound << " edges per batch:" << std::endl;
+    std::cout << "  single-fd poll() scan:            \t" << legacyNs / 1000 << " us/batch" << std::endl;
+    std::cout << "  BlackGPIOEventEngine, queued:     \t" << engineNs / 1000 << " us/batch" << std::endl;
+    std::cout << "  events found (scan / engine):     \t" << legacyFound << " / " << engineFound
+              << " (expected " << rounds * edgesPerRound << ")" << std::endl;
+    std::cout << "  engine wake ups:                  \t" << engine.getWakeUpCount() << " (expected " << rounds << ")" << std::endl;
+
+    for( int i = 0 ; i < sourceCount ; i++ )
+    {
+        close(readFds[i]);
+        close(writeFds[i]);
+    }
+}
+
+struct captureConsumer
+{
+    BlackLib::BlackGPIOCaptureBuffer    *buffer;
+    BlackLib::captureCursor             cursor;
+    std::atomic<bool>                   *isProducing;
+    uint64_t                            received;
+    uint64_t                            orderErrors;
+};
+
+void *consumeCapture(void *argument)
+{
+    captureConsumer *consumer = static_cast<captureConsumer *>(argument);
+    BlackLib::gpioEvent record;
+    uint64_t lastTimestamp = 0;
+
+    while( true )
+    {
+        bool isProducing = *(consumer->isProducing);
+        while( consumer->buffer->pop(consumer->cursor, record) )
+        {
+            consumer->received++;
+            consumer->orderErrors += ( record.timestamp <= lastTimestamp and consumer->received > 1 ) ? 1 : 0;
+            lastTimestamp = record.timestamp;
+        }
+
+        if( ! isProducing )
+        {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+void benchmark_Capture()
+{
+    const uint64_t records = 2000000;
+    timespec start, end;
+
+    // producer against two consumers; every record is either received or counted as overrun
+    BlackLib::BlackGPIOCaptureBuffer ring(4096);
+    std::atomic<bool> isProducing(true);
+
+    captureConsumer consumers[2];
+    pthread_t threads[2];
+    for( int i = 0 ; i < 2 ; i++ )
+    {
+        consumers[i].buffer         = &ring;
+        consumers[i].cursor         = ring.getCursor();
+        consumers[i].isProducing    = &isProducing;
+        consumers[i].received       = 0;
+        consumers[i].orderErrors    = 0;
+        pthread_create(&threads[i], NULL, consumeCapture, &consumers[i]);
+    }
+
+    BlackLib::gpioEvent record;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( uint64_t i = 0 ; i < records ; i++ )
+    {
+        record.id           = 48;
+        record.value        = static_cast<int>(i & 1);
+        record.timestamp    = i + 1;
+        ring.push(record);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double pushNs = elapsedNs(start, end) / records;
+
+    isProducing = false;
+    pthread_join(threads[0], NULL);
+    pthread_join(threads[1], NULL);
+
+    // burst through the event engine, ring is smaller than the burst
+    const int burst = 3000;
+    int pipeFds[2];
+    if( pipe(pipeFds) != 0 )
+    {
+        perror("pipe");
+        return;
+    }
+
+    BlackLib::BlackGPIOCaptureBuffer smallRing(1024);
+    BlackLib::BlackGPIOEventEngine engine;
+    engine.addDescriptor(pipeFds[0], 48);
+    engine.setCaptureBuffer(&smallRing);
+
+    BlackLib::captureCursor burstCursor = smallRing.getCursor();
+    for( int i = 0 ; i < burst ; i++ )
+    {
+        if( write(pipeFds[1], (i & 1) ? "1" : "0", 1) == 1 )
+        {
+            engine.processEvents(0);
+        }
+    }
+
+    uint64_t burstReceived = 0;
+    while( smallRing.pop(burstCursor, record) )
+    {
+        burstReceived++;
+    }
+
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+
+    std::cout << "BlackGPIOCaptureBuffer::push:       \t" << pushNs << " ns/record" << std::endl;
+    for( int i = 0 ; i < 2 ; i++ )
+    {
+        std::cout << "  consumer " << i << " received / overruns: \t" << consumers[i].received << " / " << consumers[i].cursor.overruns
+                  << " (sum " << consumers[i].received + consumers[i].cursor.overruns << " of " << records
+                  << "), order errors: " << consumers[i].orderErrors << std::endl;
+    }
+    std::cout << "Engine burst of " << burst << " into 1024 slots: \t" << burstReceived << " received, "
+              << burstCursor.overruns << " overruns" << std::endl;
+}
+
+// Stand-in of the gpiochip driver. Every line request gets a pipe; its read end is the request
+// descriptor, its write end is used to inject gpio_v2_line_event records.
+class FakeChipDevice : public BlackLib::BlackGPIOChipDevice
+{
+    public:
+        struct fakeRequest
+        {
+            unsigned int    chip;
+            unsigned int    offsets[GPIO_V2_LINES_MAX];
+            unsigned int    lineCount;
+            uint64_t        flags;
+            uint64_t        values;
+            unsigned int    debouncePeriod;
+            int             writeFd;
+        };
+
+        std::map<int, fakeRequest>  requests;
+        std::map<int, unsigned int> chips;
+        uint64_t                    valueIoctls;
+
+        FakeChipDevice() : valueIoctls(0) {}
+
+        int openChip(const std::string &path)
+        {
+            int fd = eventfd(0, EFD_CLOEXEC);
+            chips[fd] = static_cast<unsigned int>(atoi(path.substr(path.rfind("gpiochip") + 8).c_str()));
+            return fd;
+        }
+
+        int lineIoctl(int fd, unsigned long request, void *argument)
+        {
+            if( request == GPIO_V2_GET_LINE_IOCTL )
+            {
+                gpio_v2_line_request *lineRequest = static_cast<gpio_v2_line_request *>(argument);
+                int pipeFds[2];
+                if( chips.count(fd) == 0 or pipe(pipeFds) != 0 )
+                {
+                    return -1;
+                }
+
+                // a line can be requested once, so an older request of the same line is already released
+                for( std::map<int, fakeRequest>::iterator it = requests.begin() ; it != requests.end() ; )
+                {
+                    bool isReleased = false;
+                    for( unsigned int i = 0 ; i < it->second.lineCount ; i++ )
+                    {
+                        for( unsigned int j = 0 ; j < lineRequest->num_lines ; j++ )
+                        {
+                            isReleased |= ( it->second.chip == chips[fd] and it->second.offsets[i] == lineRequest->offsets[j] );
+                        }
+                    }
+
+                    if( isReleased )
+                    {
+                        close(it->second.writeFd);
+                        requests.erase(it++);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+
+                fakeRequest &state  = requests[pipeFds[0]];
+                state.chip          = chips[fd];
+                state.lineCount     = lineRequest->num_lines;
+                state.flags         = lineRequest->config.flags;
+                state.values        = 0;
+                state.writeFd       = pipeFds[1];
+                state.debouncePeriod = ( lineRequest->config.num_attrs > 0 ) ? lineRequest->config.attrs[0].attr.debounce_period_us : 0;
+                for( unsigned int i = 0 ; i < state.lineCount ; i++ )
+                {
+                    state.offsets[i] = lineRequest->offsets[i];
+                }
+
+                lineRequest->fd = pipeFds[0];
+                chips.erase(fd);
+                return 0;
+            }
+
+            if( requests.count(fd) == 0 )
+            {
+                return -1;
+            }
+
+            fakeRequest &state = requests[fd];
+            if( request == GPIO_V2_LINE_SET_VALUES_IOCTL or request == GPIO_V2_LINE_GET_VALUES_IOCTL )
+            {
+                gpio_v2_line_values *values = static_cast<gpio_v2_line_values *>(argument);
+                valueIoctls++;
+
+                if( request == GPIO_V2_LINE_SET_VALUES_IOCTL )
+                {
+                    state.values = (state.values & ~values->mask) | (values->bits & values->mask);
+                }
+                else
+                {
+                    values->bits = state.values & values->mask;
+                }
+                return 0;
+            }
+
+            if( request == GPIO_V2_LINE_SET_CONFIG_IOCTL )
+            {
+                gpio_v2_line_config *config = static_cast<gpio_v2_line_config *>(argument);
+                state.debouncePeriod = ( config->num_attrs > 0 ) ? config->attrs[0].attr.debounce_period_us : 0;
+                return 0;
+            }
+
+            return -1;
+        }
+
+        const fakeRequest *findRequest(unsigned int chip, unsigned int offset)
+        {
+            for( std::map<int, fakeRequest>::iterator it = requests.begin() ; it != requests.end() ; ++it )
+            {
+                for( unsigned int i = 0 ; i < it->second.lineCount ; i++ )
+                {
+                    if( it->second.chip == chip and it->second.offsets[i] == offset )
+                    {
+                        return &(it->second);
+                    }
+                }
+            }
+            return NULL;
+        }
+
+        bool injectEdge(unsigned int chip, unsigned int offset, bool isRising, uint64_t timestamp)
+        {
+            const fakeRequest *state = findRequest(chip, offset);
+            if( state == NULL )
+            {
+                return false;
+            }
+
+            gpio_v2_line_event record;
+            memset(&record, 0, sizeof(record));
+            record.timestamp_ns = timestamp;
+            record.id           = isRising ? GPIO_V2_LINE_EVENT_RISING_EDGE : GPIO_V2_LINE_EVENT_FALLING_EDGE;
+            record.offset       = offset;
+            return ( write(state->writeFd, &record, sizeof(record)) == sizeof(record) );
+        }
+};
+
+FakeChipDevice fakeChip;
+
+void benchmark_Chip()
+{
+    timespec start, end;
+
+    BlackLib::BlackGPIO led(BlackLib::GPIO_60, BlackLib::output, BlackLib::fastMode);
+    bool isAutoChip = ( led.getBackend() == BlackLib::gpioChipBackend );
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        led.setValue( (i & 1) ? BlackLib::high : BlackLib::low );
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double singleNs = elapsedNs(start, end) / iterations;
+
+    // 16 bit bus over two banks, two requests
+    BlackLib::BlackGPIOPort bus(portPins, portWidth, BlackLib::output);
+    uint64_t ioctlsBefore = fakeChip.valueIoctls;
+    bus.setValues(0xA5C3);
+    uint64_t ioctlsPerWord = fakeChip.valueIoctls - ioctlsBefore;
+    bool isReadBack = ( bus.getValues() == 0xA5C3 );
+
+    const FakeChipDevice::fakeRequest *bank1 = fakeChip.findRequest(1, 0);
+    const FakeChipDevice::fakeRequest *bank2 = fakeChip.findRequest(2, 2);
+
+    // kernel timestamped edges through the event engine
+    BlackLib::BlackGPIOEventEngine engine;
+    engine.addPin(BlackLib::GPIO_48, BlackLib::bothEdges, NULL, NULL, 5000);
+    const FakeChipDevice::fakeRequest *button = fakeChip.findRequest(1, 16);
+
+    const int edges = 40;
+    for( int i = 0 ; i < edges ; i++ )
+    {
+        fakeChip.injectEdge(1, 16, (i & 1) == 0, 1000000 + i * 20000);       // 50 kHz edges
+    }
+
+    engine.processEvents(0);
+    BlackLib::gpioEvent event;
+    int edgeCount = 0;
+    bool isOrdered = true;
+    while( engine.getEvent(event) )
+    {
+        isOrdered &= ( event.id == 48 and event.timestamp == static_cast<uint64_t>(1000000 + edgeCount * 20000)
+                       and event.value == ((edgeCount & 1) == 0 ? 1 : 0) );
+        edgeCount++;
+    }
+
+    std::cout << "gpioAutoBackend selected gpiochip:  \t" << std::boolalpha << isAutoChip << std::endl;
+    std::cout << "BlackGPIO::setValue, gpiochip fake: \t" << singleNs << " ns/call (library side only)" << std::endl;
+    std::cout << "BlackGPIOPort::setValues, gpiochip: \t" << ioctlsPerWord << " ioctls/word, read back " << isReadBack << std::endl;
+    std::printf("Line values, bank 1 / bank 2:       \t0x%02llx / 0x%02llx (expected 0xc3 / 0xa5)\n",
+                bank1 ? static_cast<unsigned long long>(bank1->values) : 0ULL, bank2 ? static_cast<unsigned long long>(bank2->values) : 0ULL);
+    std::cout << "Engine edges, one wake up:          \t" << edgeCount << " of " << edges << ", kernel timestamps kept " << isOrdered
+              << ", debounce " << (button ? button->debouncePeriod : 0) << " us" << std::endl;
+}
+
+// Old style: one timer per pin, as application code did it.
+struct legacyDebounce
+{
+    int             level;
+    int             candidate;
+    unsigned int    count;
+};
+
+void benchmark_Debounce()
+{
+    const unsigned int inputs   = 128;
+    const unsigned int ticks    = 100000;          // 10 s at 10 kHz
+    timespec start, end;
+
+    // bouncing inputs: every lane changes every 1000 ticks, with 8 ticks of bouncing
+    std::vector<uint64_t> pattern(ticks * 2);
+    uint32_t noise = 12345;
+    for( unsigned int tick = 0 ; tick < ticks ; tick++ )
+    {
+        for( unsigned int word = 0 ; word < 2 ; word++ )
+        {
+            uint64_t bits = 0;
+            for( unsigned int bit = 0 ; bit < 64 ; bit++ )
+            {
+                unsigned int lane   = word * 64 + bit;
+                unsigned int phase  = (tick + lane * 7) % 1000;
+                int level           = ( (tick + lane * 7) / 1000 ) & 1;
+
+                noise = noise * 1103515245 + 12345;
+                if( phase < 8 and (noise >> 16) & 1 )
+                {
+                    level ^= 1;
+                }
+                bits |= static_cast<uint64_t>(level) << bit;
+            }
+            pattern[tick * 2 + word] = bits;
+        }
+    }
+
+    std::vector<legacyDebounce> legacy(inputs);
+    for( unsigned int lane = 0 ; lane < inputs ; lane++ )
+    {
+        legacy[lane].level = 0; legacy[lane].candidate = 0; legacy[lane].count = 0;
+    }
+
+    unsigned int legacyTransitions = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( unsigned int tick = 0 ; tick < ticks ; tick++ )
+    {
+        for( unsigned int lane = 0 ; lane < inputs ; lane++ )
+        {
+            int raw = static_cast<int>( (pattern[tick * 2 + lane / 64] >> (lane % 64)) & 1 );
+            legacyDebounce &state = legacy[lane];
+
+            if( raw == state.level )
+            {
+                state.count = 0;
+            }
+            else if( ++state.count >= 20 )
+            {
+                state.level = raw;
+                state.count = 0;
+                legacyTransitions++;
+            }
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double legacyNs = elapsedNs(start, end) / ticks;
+
+    BlackLib::BlackGPIODebouncer debouncer(inputs);
+    debouncer.setStableTimes(20);                   // 2 ms
+
+    unsigned int transitions = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( unsigned int tick = 0 ; tick < ticks ; tick++ )
+    {
+        transitions += debouncer.update( &pattern[tick * 2] );
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double debounceNs = elapsedNs(start, end) / ticks;
+
+    // per lane stable time: 5 ticks on lane 3, long bounce on lane 4 is filtered
+    BlackLib::BlackGPIODebouncer single(128);
+    single.setStableTimes(5);
+    single.setStableTime(4, 50);
+    single.setInputId(3, 48);
+
+    const int raw[12] = { 1, 0, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1 };
+    int risingTick = -1;
+    unsigned int lane4Transitions = 0;
+    for( int tick = 0 ; tick < 12 ; tick++ )
+    {
+        uint64_t bits[2] = { static_cast<uint64_t>(raw[tick]) << 3 | static_cast<uint64_t>(raw[tick]) << 4, 0 };
+        single.update(bits);
+
+        BlackLib::gpioEvent events[4];
+        unsigned int count = single.getTransitions(events, 4, tick);
+        for( unsigned int i = 0 ; i < count ; i++ )
+        {
+            risingTick = ( events[i].id == 48 and events[i].value == 1 ) ? tick : risingTick;
+            lane4Transitions += ( events[i].id == 4 ) ? 1 : 0;
+        }
+    }
+
+    // bits above the input count are ignored, a full word of ones gives 10 transitions
+    BlackLib::BlackGPIODebouncer partial(10);
+    uint64_t allOnes        = ~0ULL;
+    unsigned int partialTransitions = partial.update(&allOnes);
+    BlackLib::gpioEvent partialEvents[64];
+    unsigned int partialEventCount  = partial.getTransitions(partialEvents, 64, 0);
+
+    std::cout << inputs << " inputs at 10 kHz, 2 ms stable time:" << std::endl;
+    std::cout << "  per pin counters:                 \t" << legacyNs << " ns/tick, " << legacyNs / 1000 << " % cpu" << std::endl;
+    std::cout << "  BlackGPIODebouncer::update:       \t" << debounceNs << " ns/tick, " << debounceNs / 1000 << " % cpu" << std::endl;
+    std::cout << "  clean transitions (counters / sliced): \t" << legacyTransitions << " / " << transitions << std::endl;
+    std::cout << "  5 tick rise after bouncing at tick: \t" << risingTick << " (expected 9), 50 tick lane changes: " << lane4Transitions << std::endl;
+    std::cout << "  10 lanes, all ones word:          \t" << partialTransitions << " transitions, " << partialEventCount
+              << " events, level 0x" << std::hex << partial.getLevels()[0] << std::dec << " (expected 10, 10, 0x3ff)" << std::endl;
+}
+
+void runSoftPWM(BlackLib::BlackSoftPWM &softPwm, const char *label, bool isSweep = true)
+{
+    timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if( ! softPwm.start(80, false) and ! softPwm.start() )
+    {
+        std::cout << "  " << label << ": thread could not be started" << std::endl;
+        return;
+    }
+
+    // duty updates from another thread, while the schedule runs
+    for( int step = 0 ; step < 10 ; step++ )
+    {
+        usleep(100000);
+        if( isSweep )
+        {
+            softPwm.setDutyPercent(0, 10.0f * step);
+        }
+    }
+
+    BlackLib::softPwmStatistics stats = softPwm.getStatistics();
+    softPwm.stop();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double cpuPercent = stats.cpuTime * 100.0 / elapsedNs(start, end);
+    std::cout << "  " << label << ": \t" << stats.periods << " periods, " << stats.missedPeriods << " missed, "
+              << static_cast<double>(stats.writes) / (stats.periods == 0 ? 1 : stats.periods) << " writes/period, "
+              << stats.writeErrors << " errors" << std::endl;
+    std::cout << "    edge latency min/mean/max: \t" << stats.minLatency / 1000.0 << " / " << stats.meanLatency / 1000.0
+              << " / " << stats.maxLatency / 1000.0 << " us, cpu " << cpuPercent << " %" << std::endl;
+}
+
+void benchmark_SoftPWM()
+{
+    const uint64_t period = 1000000;                // 1 kHz
+
+    BlackLib::BlackSoftPWM softPwm(pwmPins, pwmWidth, period, BlackLib::gpioRegisterBackend);
+
+    // every channel has its own falling edge: 33 writes per period
+    for( unsigned int channel = 0 ; channel < softPwm.getChannelCount() ; channel++ )
+    {
+        softPwm.setDutyTime(channel, (channel + 1) * period / 34);
+    }
+
+    std::cout << pwmWidth << " software pwm channels at 1 kHz, register backend:" << std::endl;
+    runSoftPWM(softPwm, "sleep, 32 edges    ");
+
+    softPwm.setSpinTime(20000);
+    runSoftPWM(softPwm, "20 us spin, 32 edges");
+
+    // four duty groups: edges of a group are merged into one write, 5 writes per period
+    for( unsigned int channel = 0 ; channel < softPwm.getChannelCount() ; channel++ )
+    {
+        softPwm.setDutyTime(channel, (channel % 4 + 1) * period / 5 + channel * 10);
+    }
+    softPwm.setSpinTime(0);
+    runSoftPWM(softPwm, "sleep, 4 groups    ");
+
+    // last falling edge is close to the next period start, no period may be skipped
+    BlackLib::BlackSoftPWM highDuty(pwmPins, 1, period, BlackLib::gpioRegisterBackend);
+    std::cout << "1 software pwm channel at 1 kHz, high duty, 1 s (expected ~1000 periods, ~0 missed):" << std::endl;
+    highDuty.setDutyPercent(0, 95.0f);
+    runSoftPWM(highDuty, "95 % duty          ", false);
+    highDuty.setDutyPercent(0, 99.9f);
+    runSoftPWM(highDuty, "99.9 % duty        ", false);
+}
+
+// Old GPIO.h gpio_export() and gpio_set_dir() behaviour: export is written unconditionally, and
+// every call opens and closes its file.
+void legacyExport(unsigned int gpio, bool isOutput)
+{
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s/sys/class/gpio/export", benchRoot.c_str());
+
+    int fd = open(buf, O_WRONLY);
+    if (fd >= 0) {
+        int len = snprintf(buf, sizeof(buf), "%d", gpio);
+        if (write(fd, buf, len) != len) {
+            // EBUSY for an exported pin, ignored like gpio_export()
+        }
+        close(fd);
+    }
+
+    snprintf(buf, sizeof(buf), "%s/sys/class/gpio/gpio%d/direction", benchRoot.c_str(), gpio);
+    fd = open(buf, O_WRONLY);
+    if (fd >= 0) {
+        if (write(fd, isOutput ? "out" : "in", isOutput ? 4 : 3) < 0) {
+            perror("gpio/direction");
+        }
+        close(fd);
+    }
+}
+
+void benchmark_Export()
+{
+    const int rounds = 200;
+    timespec start, end;
+
+    // first 60 gpio capable header pins, from the compile time pin table
+    std::vector<BlackLib::gpioName>  pins;
+    std::vector<BlackLib::direction> directions;
+    for( int pin = 0 ; pin < BlackLib::headerPinCount and pins.size() < 60 ; pin++ )
+    {
+        int gpio = BlackLib::headerPinGpio( static_cast<BlackLib::headerPin>(pin) );
+        if( gpio < 0 )
+        {
+            continue;
+        }
+
+        pins.push_back( static_cast<BlackLib::gpioName>(gpio) );
+        directions.push_back( (pins.size() % 2) ? BlackLib::output : BlackLib::input );
+
+        std::string pinPath = benchRoot + "/sys/class/gpio/gpio" + BlackLib::tostr(gpio) + "/";
+        mkdir(pinPath.c_str(), 0755);
+        writeStandInFile(pinPath + "value",     "0");
+        writeStandInFile(pinPath + "direction", "in");
+    }
+    unsigned int count = pins.size();
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int round = 0 ; round < rounds ; round++ )
+    {
+        for( unsigned int i = 0 ; i < count ; i++ )
+        {
+            legacyExport(pins[i], directions[i] == BlackLib::output);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double legacyNs = elapsedNs(start, end) / rounds;
+
+    // pins are shown as exported, so every round exports nothing and writes 60 directions
+    bool isSuccess = true;
+    double batchNs = 0;
+    for( int round = 0 ; round < rounds ; round++ )
+    {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        isSuccess &= BlackLib::BlackCoreGPIO::exportPins(&pins[0], count, &directions[0]);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        batchNs += elapsedNs(start, end) / rounds;
+
+        if( round + 1 < rounds )
+        {
+            // clears state cache of the pins, the stand-in directories stay
+            BlackLib::BlackCoreGPIO::unexportPins(&pins[0], count);
+        }
+    }
+
+    // state cache is filled, objects skip export and direction writes
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( unsigned int i = 0 ; i < count ; i++ )
+    {
+        BlackLib::BlackGPIO pin(pins[i], directions[i], BlackLib::fastMode, BlackLib::gpioSysfsBackend);
+        isSuccess &= ! pin.fail();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double objectNs = elapsedNs(start, end);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    isSuccess &= BlackLib::BlackCoreGPIO::exportPins(&pins[0], count, &directions[0]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double cachedNs = elapsedNs(start, end);
+
+    std::cout << count << " pin startup export and direction setting:" << std::endl;
+    std::cout << "  gpio_export + gpio_set_dir:      \t" << legacyNs / 1000 << " us" << std::endl;
+    std::cout << "  BlackCoreGPIO::exportPins:       \t" << batchNs / 1000 << " us" << std::endl;
+    std::cout << "  exportPins again (cached):       \t" << cachedNs / 1000 << " us" << std::endl;
+    std::cout << "  BlackGPIO objects after batch:   \t" << objectNs / 1000 << " us, success " << isSuccess << std::endl;
+}
+
+uint64_t monotonicNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+}
+
+void benchmark_Pulse()
+{
+    const unsigned int  inputs      = 8;
+    const uint64_t      duration    = 1000000000;           // 1 s of signal
+    const uint64_t      window      = 100000000;            // 100 ms windows
+    timespec start, end;
+
+    // tachometers on GPIO_44..GPIO_51 (gpiochip1 lines 12-19): 1 kHz to 8 kHz, duty 20 % to 55 %
+    const BlackLib::gpioName tachPins[inputs] = { BlackLib::GPIO_44, BlackLib::GPIO_45, BlackLib::GPIO_46, BlackLib::GPIO_47,
+                                                  BlackLib::GPIO_48, BlackLib::GPIO_49, BlackLib::GPIO_50, BlackLib::GPIO_51 };
+
+    BlackLib::BlackGPIOEventEngine engine;
+    BlackLib::BlackGPIOPulseMeter  meter(engine, window);
+    for( unsigned int i = 0 ; i < inputs ; i++ )
+    {
+        meter.addPin(tachPins[i]);
+    }
+
+    // edges are written in 10 ms slices, because a fake line request is a pipe with limited size
+    uint64_t signalStart    = monotonicNs() - duration;
+    uint64_t edgeCount      = 0;
+    double processNs        = 0;
+
+    for( uint64_t slice = 0 ; slice < duration ; slice += 10000000 )
+    {
+        for( unsigned int i = 0 ; i < inputs ; i++ )
+        {
+            uint64_t period = 1000000 / (i + 1);
+            uint64_t high   = period * (20 + 5 * i) / 100;
+            for( uint64_t t = (slice + period - 1) / period * period ; t < slice + 10000000 ; t += period )
+            {
+                fakeChip.injectEdge(1, 12 + i, true,  signalStart + t);
+                fakeChip.injectEdge(1, 12 + i, false, signalStart + t + high);
+                edgeCount += 2;
+            }
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        while( engine.processEvents(0) > 0 )
+        {
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        processNs += elapsedNs(start, end);
+    }
+
+    double worstFrequencyError = 0, worstDutyError = 0;
+    uint64_t pulses = 0;
+    for( unsigned int i = 0 ; i < inputs ; i++ )
+    {
+        BlackLib::pulseMeasurement result;
+        meter.getMeasurement(tachPins[i], result);
+
+        double frequencyError   = std::abs(result.frequency - 1000.0 * (i + 1)) / (1000.0 * (i + 1)) * 100;
+        double dutyError        = std::abs(result.dutyCycle - (20.0 + 5 * i));
+        worstFrequencyError     = (frequencyError > worstFrequencyError) ? frequencyError : worstFrequencyError;
+        worstDutyError          = (dutyError > worstDutyError) ? dutyError : worstDutyError;
+        pulses                 += result.totalPulses;
+    }
+
+    // accumulator cost alone, edges are given without the engine
+    BlackLib::BlackGPIOEventEngine  directEngine;
+    BlackLib::BlackGPIOPulseMeter   directMeter(directEngine, window);
+    int pipeFds[2];
+    if( pipe(pipeFds) != 0 )
+    {
+        return;
+    }
+    directMeter.addDescriptor(pipeFds[0], 1000);
+
+    const int directEdges = 2000000;
+    BlackLib::gpioEvent event;
+    event.id = 1000;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < directEdges ; i++ )
+    {
+        event.value     = (i + 1) & 1;
+        event.timestamp = signalStart + static_cast<uint64_t>(i) * 50000;          // 10 kHz, 50 % duty
+        directMeter.handleEvent(event);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double directNs = elapsedNs(start, end) / directEdges;
+
+    BlackLib::pulseMeasurement direct;
+    directMeter.getMeasurement(1000, direct);
+
+    // signal which stopped long ago while it was high
+    directMeter.addDescriptor(pipeFds[1], 1001);
+    event.id = 1001;
+    for( int i = 0 ; i < 41 ; i++ )
+    {
+        event.value     = (i + 1) & 1;
+        event.timestamp = 1000000000ULL + static_cast<uint64_t>(i) * 10000000;    // 50 Hz, then held high
+        directMeter.handleEvent(event);
+    }
+
+    BlackLib::pulseMeasurement stalled;
+    directMeter.getMeasurement(1001, stalled);
+
+    std::cout << inputs << " tachometers, 1-8 kHz, 100 ms windows, gpiochip fake, one engine:" << std::endl;
+    std::cout << "  edges / pulses of closed windows: \t" << edgeCount << " / " << pulses << std::endl;
+    std::cout << "  worst frequency / duty error:     \t" << worstFrequencyError << " % / " << worstDutyError << " %" << std::endl;
+    std::cout << "  engine + meter cpu for 1 s signal:\t" << processNs * 100 / duration << " % (" << processNs / edgeCount << " ns/edge)" << std::endl;
+    std::cout << "  BlackGPIOPulseMeter::handleEvent: \t" << directNs << " ns/edge, 10 kHz read as " << direct.frequency
+              << " Hz, " << direct.dutyCycle << " % duty" << std::endl;
+    std::cout << "  stalled high signal:              \t" << stalled.frequency << " Hz, " << stalled.dutyCycle
+              << " % duty (expected 0 Hz, 100 % duty)" << std::endl;
+
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+}
+
+// Injects quadrature edges of an encoder on gpiochip3 lines 16 (A) and 17 (B). Step 0-3 is the
+// position at the A-leads-B cycle; every step is one edge.
+void injectQuadrature(int &step, int direction, uint64_t timestamp, unsigned int bankB = 3, unsigned int lineB = 17)
+{
+    const int levelA[4] = { 1, 1, 0, 0 };
+    const int levelB[4] = { 0, 1, 1, 0 };
+
+    int next = (step + direction + 4) % 4;
+    if( levelA[next] != levelA[step] )
+    {
+        fakeChip.injectEdge(3, 16, levelA[next] == 1, timestamp);
+    }
+    else
+    {
+        fakeChip.injectEdge(bankB, lineB, levelB[next] == 1, timestamp);
+    }
+    step = next;
+}
+
+void benchmark_Encoder()
+{
+    const uint64_t  edgeTime    = 20000;                // 50 kHz edges
+    const int       forward     = 100000;               // 2 s forward
+    const int       reverse     = 20000;                // 0.4 s reverse
+    timespec start, end;
+
+    BlackLib::BlackGPIOEventEngine  engine;
+    BlackLib::BlackGPIOEncoder      encoder(engine, BlackLib::GPIO_112, BlackLib::GPIO_113, 0, 250000000);
+
+    // edges are written in 10 ms slices, because a fake line request is a pipe with limited size. Forward
+    // edges end at the current time, so velocity isn't read as stopped after the forward slices.
+    uint64_t signalStart    = monotonicNs() - forward * edgeTime;
+    uint64_t timestamp      = signalStart;
+    int step                = 3;
+    double processNs        = 0;
+    double forwardVelocity  = 0;
+
+    // initial levels of both channels: A = 0, B = 0
+    fakeChip.injectEdge(3, 16, false, timestamp);
+    fakeChip.injectEdge(3, 17, false, timestamp);
+
+    for( int edge = 0 ; edge < forward + reverse ; edge += 500 )
+    {
+        for( int i = edge ; i < edge + 500 ; i++ )
+        {
+            timestamp += edgeTime;
+            injectQuadrature(step, (i < forward) ? 1 : -1, timestamp);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        while( engine.processEvents(0) > 0 )
+        {
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        processNs += elapsedNs(start, end);
+
+        if( edge + 500 == forward )
+        {
+            forwardVelocity = encoder.getVelocity();
+        }
+    }
+
+    int64_t position        = encoder.getPosition();
+    double reverseVelocity  = encoder.getVelocity();
+
+    // a lost edge pair: channel A reports the same level again
+    fakeChip.injectEdge(3, 16, step < 2, timestamp + edgeTime);
+    engine.processEvents(0);
+
+    std::cout << "Quadrature encoder, 50 kHz edges, gpiochip fake:" << std::endl;
+    std::cout << "  position after " << forward << " forward / " << reverse << " reverse edges: \t" << position
+              << " (expected " << forward - reverse << ")" << std::endl;
+    std::cout << "  velocity forward / reverse:        \t" << forwardVelocity << " / " << reverseVelocity << " counts/s (expected +/-50000)" << std::endl;
+    std::cout << "  illegal transitions:               \t" << encoder.getErrorCount() << " (expected 1)" << std::endl;
+    std::cout << "  engine + decoder cpu at 50 kHz:    \t" << processNs * 100 / ((forward + reverse) * edgeTime)
+              << " % (" << processNs / (forward + reverse) << " ns/edge)" << std::endl;
+
+    // channels at different banks are two line requests, all edges are read at one wake up
+    BlackLib::BlackGPIOEventEngine  crossEngine;
+    BlackLib::BlackGPIOEncoder      crossEncoder(crossEngine, BlackLib::GPIO_112, BlackLib::GPIO_48);
+
+    timestamp   = monotonicNs();
+    step        = 3;
+    fakeChip.injectEdge(3, 16, false, timestamp);
+    fakeChip.injectEdge(1, 16, false, timestamp);
+    for( int i = 0 ; i < 400 ; i++ )
+    {
+        timestamp += edgeTime;
+        injectQuadrature(step, 1, timestamp, 1, 16);
+    }
+    crossEngine.processEvents(0);
+
+    std::cout << "  cross bank pair, 400 edges at one wake up: \t" << crossEncoder.getPosition()
+              << " counts, " << crossEncoder.getErrorCount() << " errors (expected 400, 0)" << std::endl;
+}
+
+int main()
+{
+    makeStandInTree();
+    BlackLib::BlackCore::setFilesystemRoot(benchRoot);
+    BlackLib::BlackGPIOChipDevice::setDevice(&fakeChip);
+
+    benchmark_Toggle();
+    benchmark_Read();
+    benchmark_Register();
+    benchmark_Port();
+    benchmark_Events();
+    benchmark_Capture();
+    benchmark_Chip();
+    benchmark_Debounce();
+    benchmark_SoftPWM();
+    benchmark_Export();
+    benchmark_Pulse();
+    benchmark_Encoder();
+    return 0;
+}
@@ -0,0 +1,679 @@
+
+#include "BlackPWM.h"
+#include "BlackPWMStream.h"
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <cmath>
+#include <time.h>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Benchmarks of BlackPWM against a stand-in sysfs tree. The tree is created on tmpfs
+// (/dev/shm) with the same layout as the pwm_test driver and pwmchip class directory,
+// so it can run off-board.
+
+const std::string   benchRoot   = "/dev/shm/blacklib_pwmbench";
+const int           iterations  = 100000;
+
+
+double elapsedNs(const timespec &start, const timespec &end)
+{
+    return (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+}
+
+void writeStandInFile(const std::string &path, const std::string &value)
+{
+    std::ofstream file(path.c_str(), std::ios::out | std::ios::trunc);
+    file << value << std::endl;
+}
+
+void makeStandInTree()
+{
+    std::string devices = benchRoot + "/sys/devices/";
+
+    mkdir(benchRoot.c_str(), 0755);
+    mkdir((benchRoot + "/sys").c_str(), 0755);
+    mkdir(devices.c_str(), 0755);
+    mkdir((devices + "bone_capemgr.9").c_str(), 0755);
+    mkdir((devices + "ocp.3").c_str(), 0755);
+
+    writeStandInFile(devices + "bone_capemgr.9/slots",
+                     " 0: 54:PF--- \n"
+                     " 1: 55:PF--- \n"
+                     " 2: 56:PF--- \n"
+                     " 3: 57:PF--- \n"
+                     " 4: ff:P-O-L Bone-LT-eMMC-2G,00A0,Texas Instrument,BB-BONE-EMMC-2G\n"
+                     " 5: ff:P-O-- Bone-Black-HDMI,00A0,Texas Instrument,BB-BONELT-HDMI");
+
+    // sparse stand-in of /dev/mem, which covers PWMSS0, PWMSS1 and PWMSS2 register windows.
+    mkdir((benchRoot + "/dev").c_str(), 0755);
+    int memFd = open((benchRoot + "/dev/mem").c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    ftruncate(memFd, 0x48305000);
+    close(memFd);
+
+    for( int i = 0 ; i < 7 ; i++ )
+    {
+        std::string pwmTest = devices + "ocp.3/pwm_test_" + BlackLib::pwmNameMap[i] + "." + BlackLib::tostr(15 + i) + "/";
+        mkdir(pwmTest.c_str(), 0755);
+
+        writeStandInFile(pwmTest + "period",   "500000");
+        writeStandInFile(pwmTest + "duty",     "250000");
+        writeStandInFile(pwmTest + "run",      "1");
+        writeStandInFile(pwmTest + "polarity", "0");
+    }
+
+    // pwmchip links of /sys/class/pwm, channels are shown as already exported
+    const char *chipDevices[4]  = { "48300000.epwmss/48300100.ecap", "48300000.epwmss/48300200.pwm",
+                                    "48302000.epwmss/48302200.pwm",  "48304000.epwmss/48304200.pwm" };
+    const int   chipChannels[4] = { 1, 2, 2, 2 };
+
+    mkdir((benchRoot + "/sys/class").c_str(), 0755);
+    mkdir((benchRoot + "/sys/class/pwm").c_str(), 0755);
+    mkdir((devices + "platform").c_str(), 0755);
+    mkdir((devices + "platform/ocp").c_str(), 0755);
+
+    for( int i = 0 ; i < 4 ; i++ )
+    {
+        std::string device  = chipDevices[i];
+        std::string chip    = "pwmchip" + BlackLib::tostr(2 * i);
+        std::string subPath = "platform/ocp/" + device.substr(0, device.find('/'));
+
+        mkdir((devices + subPath).c_str(), 0755);
+        subPath = "platform/ocp/" + device;
+        mkdir((devices + subPath).c_str(), 0755);
+        mkdir((devices + subPath + "/pwm").c_str(), 0755);
+        subPath += "/pwm/" + chip;
+        mkdir((devices + subPath).c_str(), 0755);
+
+        std::string link = benchRoot + "/sys/class/pwm/" + chip;
+        unlink(link.c_str());
+        symlink(("../../devices/" + subPath).c_str(), link.c_str());
+
+        writeStandInFile(devices + subPath + "/npwm",   BlackLib::tostr(chipChannels[i]));
+        writeStandInFile(devices + subPath + "/export", "");
+
+        for( int j = 0 ; j < chipChannels[i] ; j++ )
+        {
+            std::string channel = devices + subPath + "/pwm" + BlackLib::tostr(j) + "/";
+            mkdir(channel.c_str(), 0755);
+
+            writeStandInFile(channel + "period",     "500000");
+            writeStandInFile(channel + "duty_cycle", "250000");
+            writeStandInFile(channel + "enable",     "1");
+            writeStandInFile(channel + "polarity",   "inversed");
+        }
+    }
+
+    mkdir((benchRoot + "/proc").c_str(), 0755);
+    mkdir((benchRoot + "/proc/sys").c_str(), 0755);
+    mkdir((benchRoot + "/proc/sys/kernel").c_str(), 0755);
+    mkdir((benchRoot + "/proc/sys/kernel/random").c_str(), 0755);
+    writeStandInFile(benchRoot + "/proc/sys/kernel/random/boot_id", "0f1e2d3c-4b5a-6978-8796-a5b4c3d2e1f0");
+
+    // unrelated device directories, like a board with many peripherals
+    for( int i = 0 ; i < 2000 ; i++ )
+    {
+        mkdir((devices + "platform_device." + BlackLib::tostr(i)).c_str(), 0755);
+        mkdir((devices + "ocp.3/device_" + BlackLib::tostr(i) + ".bus").c_str(), 0755);
+    }
+}
+
+void benchmark_BringUp()
+{
+    BlackLib::pwmName names[7] = { BlackLib::P8_13, BlackLib::P8_19, BlackLib::P9_14, BlackLib::P9_16,
+                                   BlackLib::P9_21, BlackLib::P9_22, BlackLib::P9_42 };
+    timespec start, end;
+
+    // first bring-up parses slots file and loads missing overlays, second one finds all of them loaded
+    for( int round = 0 ; round < 2 ; round++ )
+    {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        BlackLib::BlackPWMGroup group(names, 7, BlackLib::sysfsBackend);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        std::cout << ((round == 0) ? "7 channel bring-up, first:          \t" : "7 channel bring-up, again:          \t")
+                  << elapsedNs(start, end) / 1000 << " us" << std::endl;
+    }
+}
+
+// Runs in a new process: seven channel bring-up of a fresh process, with or without discovery cache file.
+int startupChild(const std::string &cacheFile)
+{
+    BlackLib::pwmName names[7] = { BlackLib::P8_13, BlackLib::P8_19, BlackLib::P9_14, BlackLib::P9_16,
+                                   BlackLib::P9_21, BlackLib::P9_22, BlackLib::P9_42 };
+    timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    BlackLib::BlackCore::setFilesystemRoot(benchRoot);
+    if( ! cacheFile.empty() )
+    {
+        BlackLib::BlackCore::setDiscoveryCacheFile(cacheFile);
+    }
+    BlackLib::BlackPWMGroup group(names, 7, BlackLib::sysfsBackend);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    std::cout << elapsedNs(start, end) / 1000 << " us" << std::endl;
+    return group.fail() ? 1 : 0;
+}
+
+// Fresh process which finds every path at valid cache file, then the overlay is loaded again with
+// another driver instance number while the watcher runs.
+int watchChild(const std::string &cacheFile)
+{
+    std::string ocp     = benchRoot + "/sys/devices/ocp.3/";
+    std::string oldName = ocp + "pwm_test_P8_19.16";
+    std::string newName = ocp + "pwm_test_P8_19.31";
+
+    BlackLib::BlackCore::setFilesystemRoot(benchRoot);
+    BlackLib::BlackCore::setDiscoveryCacheFile(cacheFile);
+    BlackLib::BlackCore::startDiscoveryWatcher();
+    BlackLib::BlackPWM  pwm(BlackLib::P8_19, BlackLib::sysfsBackend);
+
+    uint64_t generation = BlackLib::BlackDiscoveryIndex::instance().getGeneration();
+    rename(oldName.c_str(), newName.c_str());
+    for( int i = 0 ; i < 100000 and BlackLib::BlackDiscoveryIndex::instance().getGeneration() == generation ; i++ )
+    {
+        usleep(10);
+    }
+    bool isRefreshed = ( BlackLib::BlackDiscoveryIndex::instance().getGeneration() != generation );
+
+    pwm.setDutyPercent(40.0);
+    std::ifstream dutyFile((newName + "/duty").c_str());
+    int64_t duty = -1;
+    dutyFile >> duty;
+
+    BlackLib::BlackCore::stopDiscoveryWatcher();
+    rename(newName.c_str(), oldName.c_str());
+
+    std::cout << duty << " (" << std::boolalpha << pwm.fail() << "), refreshed by watcher " << isRefreshed << std::endl;
+    return 0;
+}
+
+void benchmark_Startup()
+{
+    std::string cacheFile   = benchRoot + "/discovery.cache";
+    const char *titles[3]   = { "fresh process startup, no cache:    \t",
+                                "fresh process startup, cache build: \t",
+                                "fresh process startup, cache valid: \t" };
+
+    unlink(cacheFile.c_str());
+    for( int i = 0 ; i < 3 ; i++ )
+    {
+        std::cout << titles[i] << std::flush;
+
+        pid_t child = fork();
+        if( child == 0 )
+        {
+            execl("/proc/self/exe", "pwmbench", "startup", (i == 0) ? "" : cacheFile.c_str(), (char *)NULL);
+            _exit(127);
+        }
+
+        int status = 0;
+        waitpid(child, &status, 0);
+    }
+}
+
+// Old discovery of a BlackPWM object: capemgr and ocp scans of devices directory, pwm_test scan of ocp directory.
+std::string legacySearchDirectory(const std::string &searchIn, const std::string &searchThis)
+{
+    std::string result = BlackLib::SEARCH_DIR_NOT_FOUND;
+    DIR *path = opendir(searchIn.c_str());
+    dirent *entry;
+
+    while( path != NULL and (entry = readdir(path)) != NULL )
+    {
+        if( entry->d_name[0] != '.' and strstr(entry->d_name, searchThis.c_str()) != NULL )
+        {
+            result = entry->d_name;
+            break;
+        }
+    }
+
+    if( path != NULL ) { closedir(path); }
+    return result;
+}
+
+void benchmark_Construction()
+{
+    const int objectCount = iterations / 100;
+    std::string devices = benchRoot + "/sys/devices/";
+    timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < objectCount ; i++ )
+    {
+        legacySearchDirectory(devices, "bone_capemgr.");
+        legacySearchDirectory(devices, "ocp.");
+        legacySearchDirectory(devices + "ocp.3/", "pwm_test_P8_19.");
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double scanNs = elapsedNs(start, end) / objectCount;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < objectCount ; i++ )
+    {
+        BlackLib::BlackPWM pwm(BlackLib::P8_19, BlackLib::sysfsBackend);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double constructNs = elapsedNs(start, end) / objectCount;
+
+    std::cout << "discovery scans of one object (old):\t" << scanNs << " ns" << std::endl;
+    std::cout << "BlackPWM construction (indexed):    \t" << constructNs << " ns" << std::endl;
+}
+
+// Old BlackPWM::setDutyPercent() behaviour: one ifstream for the period and one ofstream for the duty.
+bool legacySetDutyPercent(const std::string &pwmTest, float percentage)
+{
+    int64_t period = -1;
+
+    std::ifstream periodFile((pwmTest + "period").c_str(), std::ios::in);
+    if( periodFile.fail() ) { return false; }
+    periodFile >> period;
+    periodFile.close();
+
+    std::ofstream dutyFile((pwmTest + "duty").c_str(), std::ios::out);
+    if( dutyFile.fail() ) { return false; }
+    dutyFile << static_cast<int64_t>(round(period * (1.0 - (percentage/100))));
+    dutyFile.close();
+    return true;
+}
+
+void benchmark_DutyUpdate()
+{
+    std::string pwmTest = benchRoot + "/sys/devices/ocp.3/pwm_test_P8_19.16/";
+    timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        legacySetDutyPercent(pwmTest, static_cast<float>(i % 100));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double legacyNs = elapsedNs(start, end) / iterations;
+
+
+    BlackLib::BlackPWM  pwm(BlackLib::P8_19);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        pwm.setDutyPercent(static_cast<float>(i % 100));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double currentNs = elapsedNs(start, end) / iterations;
+
+    std::cout << "setDutyPercent (ifstream/ofstream):  \t" << legacyNs  << " ns/call" << std::endl;
+    std::cout << "setDutyPercent (cached descriptor):  \t" << currentNs << " ns/call" << std::endl;
+    std::cout << "Error state after benchmark: \t\t" << std::boolalpha << pwm.fail() << std::endl;
+}
+
+void benchmark_ShadowReads()
+{
+    BlackLib::BlackPWM  pwm(BlackLib::P8_19);
+    timespec start, end;
+    volatile int64_t sink = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        pwm.setDutyPercent(42.0);
+        sink = pwm.getNumericPeriodValue() + pwm.isRunning();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double shadowNs = elapsedNs(start, end) / iterations;
+    (void)sink;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        pwm.resync();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double resyncNs = elapsedNs(start, end) / iterations;
+
+    std::cout << "unchanged duty + period/run reads:  \t" << shadowNs << " ns/call" << std::endl;
+    std::cout << "resync of four attributes:          \t" << resyncNs << " ns/call" << std::endl;
+}
+
+void benchmark_Retune()
+{
+    BlackLib::BlackPWM  pwm(BlackLib::P8_19);
+    timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        if( i % 2 == 0 )    { pwm.setPeriodAndDuty(500000, 400000); }
+        else                { pwm.setPeriodAndDuty(100000,  25000); }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    std::cout << "setPeriodAndDuty retune:            \t" << elapsedNs(start, end) / iterations << " ns/call" << std::endl;
+    std::cout << "Period/duty after retune: \t\t" << pwm.getPeriodValue() << "/" << pwm.getDutyValue() << std::endl;
+}
+
+void benchmark_Group()
+{
+    const int tickCount = iterations / 10;
+    BlackLib::pwmName names[7] = { BlackLib::P8_13, BlackLib::P8_19, BlackLib::P9_14, BlackLib::P9_16,
+                                   BlackLib::P9_21, BlackLib::P9_22, BlackLib::P9_42 };
+    uint64_t periods[7];
+    uint64_t duties[7];
+    timespec start, end;
+
+    BlackLib::BlackPWM *independent[7];
+    for( int i = 0 ; i < 7 ; i++ )
+    {
+        independent[i] = new BlackLib::BlackPWM(names[i]);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int tick = 0 ; tick < tickCount ; tick++ )
+    {
+        for( int i = 0 ; i < 7 ; i++ )
+        {
+            independent[i]->setPeriodTime(500000);
+            independent[i]->setSpaceRatioTime(1000 * ((tick + i) % 400));
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double independentNs = elapsedNs(start, end) / tickCount;
+
+    for( int i = 0 ; i < 7 ; i++ )
+    {
+        delete independent[i];
+    }
+
+
+    BlackLib::BlackPWMGroup group(names, 7);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int tick = 0 ; tick < tickCount ; tick++ )
+    {
+        for( int i = 0 ; i < 7 ; i++ )
+        {
+            periods[i] = 500000;
+            duties[i]  = 1000 * ((tick + i) % 400);
+        }
+        group.setPeriodsAndDuties(periods, duties);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double groupNs = elapsedNs(start, end) / tickCount;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int tick = 0 ; tick < tickCount ; tick++ )
+    {
+        duties[tick % 7] = 1000 * (tick % 400);
+        group.setPeriodsAndDuties(periods, duties);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double sparseNs = elapsedNs(start, end) / tickCount;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    group.startSynchronized();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    std::cout << "7 independent objects, full tick:   \t" << independentNs << " ns/tick" << std::endl;
+    std::cout << "BlackPWMGroup, full tick:           \t" << groupNs << " ns/tick" << std::endl;
+    std::cout << "BlackPWMGroup, one channel changed: \t" << sparseNs << " ns/tick" << std::endl;
+    std::cout << "BlackPWMGroup, synchronized start:  \t" << elapsedNs(start, end) << " ns" << std::endl;
+    std::cout << "Group error state: \t\t\t" << std::boolalpha << group.fail() << std::endl;
+}
+
+void benchmark_Stream()
+{
+    BlackLib::BlackPWM          pwm(BlackLib::P8_19);
+    BlackLib::BlackPWMStream    stream(pwm, 1000000, 1024);
+
+    for( int i = 0 ; i < 1000 ; i++ )
+    {
+        stream.push( static_cast<float>(50.0 + 50.0 * sin(i * 0.00628)) );
+    }
+
+    // 1000 samples at 1 kHz, the last 200 ms of the run are underruns.
+    stream.start();
+    usleep(1200000);
+    stream.stop();
+
+    BlackLib::streamStatistics stats = stream.getStatistics();
+    std::cout << "Stream ticks/underruns/missed:      \t" << stats.ticks << "/" << stats.underruns << "/" << stats.missedTicks << std::endl;
+    std::cout << "Stream latency min/mean/max:        \t" << stats.minLatency << "/" << stats.meanLatency << "/" << stats.maxLatency << " ns" << std::endl;
+}
+
+void benchmark_Conversion()
+{
+    const BlackLib::timeType types[4] = { BlackLib::picosecond, BlackLib::nanosecond, BlackLib::microsecond, BlackLib::milisecond };
+    volatile uint64_t sink = 0;
+    timespec start, end;
+
+    // old conversion of BlackPWM setters
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        BlackLib::timeType tType = types[i % 4];
+        sink = static_cast<uint64_t>(static_cast<uint64_t>(i) * static_cast<double>(pow( 10, static_cast<int>(tType)+9) ));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double powNs = elapsedNs(start, end) / iterations;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        uint64_t result = 0;
+        BlackLib::convertToNanosecond(static_cast<uint64_t>(i), types[i % 4], result);
+        sink = result;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double integerNs = elapsedNs(start, end) / iterations;
+
+    // old duty calculation of setDutyPercent() against parts per million calculation
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        float percentage = static_cast<float>(i % 10000) / 100;
+        sink = static_cast<int64_t>(round(500000 * (1.0 - (percentage/100))));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double floatDutyNs = elapsedNs(start, end) / iterations;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        float percentage = static_cast<float>(i % 10000) / 100;
+        uint64_t loadPpm = static_cast<uint64_t>(percentage * 10000.0f + 0.5f);
+        sink = 500000 - (500000 * loadPpm + 500000) / 1000000;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double integerDutyNs = elapsedNs(start, end) / iterations;
+    (void)sink;
+
+    uint64_t picoResult;
+    BlackLib::convertToNanosecond(300000000, BlackLib::picosecond, picoResult);
+
+    std::cout << "time conversion, pow():             \t" << powNs << " ns/call" << std::endl;
+    std::cout << "time conversion, integer table:     \t" << integerNs << " ns/call" << std::endl;
+    std::cout << "duty from percent, float/round():   \t" << floatDutyNs << " ns/call" << std::endl;
+    std::cout << "duty from percent, integer ppm:     \t" << integerDutyNs << " ns/call" << std::endl;
+    std::cout << "300000000 ps, pow()/integer:        \t"
+              << static_cast<uint64_t>(300000000 * static_cast<double>(pow( 10, static_cast<int>(BlackLib::picosecond)+9) ))
+              << "/" << picoResult << " ns" << std::endl;
+}
+
+void benchmark_RegisterBackend()
+{
+    BlackLib::BlackPWM  pwm(BlackLib::P9_14, BlackLib::registerBackend);
+    timespec start, end;
+
+    pwm.setPeriodAndDuty(500000, 400000);
+    pwm.setRunState(BlackLib::run);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        pwm.setDutyPercent(static_cast<float>(i % 100));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    pwm.setDutyPercent(20.0);
+
+    // EHRPWM1 registers of the stand-in window: PWMSS1 + 0x200
+    int memFd = open((benchRoot + "/dev/mem").c_str(), O_RDONLY);
+    uint8_t *pwmss1 = static_cast<uint8_t *>(mmap(NULL, 0x1000, PROT_READ, MAP_SHARED, memFd, 0x48302000));
+    close(memFd);
+
+    std::cout << "setDutyPercent (register backend):  \t" << elapsedNs(start, end) / iterations << " ns/call" << std::endl;
+    std::cout << "TBCTL/TBPRD/CMPA/AQCTLA:            \t" << std::hex
+              << *reinterpret_cast<uint16_t *>(pwmss1 + 0x200) << "/"
+              << *reinterpret_cast<uint16_t *>(pwmss1 + 0x20A) << "/"
+              << *reinterpret_cast<uint16_t *>(pwmss1 + 0x212) << "/"
+              << *reinterpret_cast<uint16_t *>(pwmss1 + 0x216) << std::dec << std::endl;
+    std::cout << "Period/duty read back:              \t" << pwm.getPeriodValue() << "/" << pwm.getDutyValue()
+              << " (" << pwm.getValue() << "%)" << std::endl;
+
+    munmap(pwmss1, 0x1000);
+
+    // counters of the stand-in window are left at non zero values, synchronized start must reset them
+    BlackLib::pwmName names[3] = { BlackLib::P8_19, BlackLib::P9_14, BlackLib::P9_42 };
+    BlackLib::BlackPWMGroup group(names, 3, BlackLib::registerBackend);
+    uint16_t tbcnt = 0x1234;
+    uint32_t tsctr = 0x5678;
+    memFd = open((benchRoot + "/dev/mem").c_str(), O_RDWR);
+    pwrite(memFd, &tbcnt, sizeof(tbcnt), 0x48304208);
+    pwrite(memFd, &tbcnt, sizeof(tbcnt), 0x48302208);
+    pwrite(memFd, &tsctr, sizeof(tsctr), 0x48300100);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool isStarted = group.startSynchronized();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    uint16_t tbcnt2, tbcnt1;
+    pread(memFd, &tbcnt2, sizeof(tbcnt2), 0x48304208);
+    pread(memFd, &tbcnt1, sizeof(tbcnt1), 0x48302208);
+    pread(memFd, &tsctr, sizeof(tsctr), 0x48300100);
+    close(memFd);
+
+    std::cout << "startSynchronized (register backend):\t" << elapsedNs(start, end) << " ns, " << std::boolalpha << isStarted << std::endl;
+    std::cout << "PWMSS2/PWMSS1 TBCNT, PWMSS0 TSCTR:  \t" << tbcnt2 << "/" << tbcnt1 << ", " << tsctr << " (expected 0/0, 0)" << std::endl;
+}
+
+void benchmark_PwmChip()
+{
+    BlackLib::pwmName names[7] = { BlackLib::P8_13, BlackLib::P8_19, BlackLib::P9_14, BlackLib::P9_16,
+                                   BlackLib::P9_21, BlackLib::P9_22, BlackLib::P9_42 };
+    timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    BlackLib::BlackPWMGroup group(names, 7, BlackLib::pwmchipBackend);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double groupSetupNs = elapsedNs(start, end);
+
+    BlackLib::BlackPWM &pwm = group.getChannel(2);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        pwm.setDutyPercent(static_cast<float>(i % 100));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    pwm.setRunState(BlackLib::stop);
+    pwm.setPolarity(BlackLib::reverse);
+    pwm.setPolarity(BlackLib::straight);
+    pwm.setDutyPercent(20.0);
+    pwm.resync();
+
+    std::cout << "pwmchip group setup (7 channels):   \t" << groupSetupNs << " ns" << std::endl;
+    std::cout << "setDutyPercent (pwmchip backend):   \t" << elapsedNs(start, end) / iterations << " ns/call" << std::endl;
+    std::cout << "Period/duty/polarity after resync:  \t" << pwm.getPeriodValue() << "/" << pwm.getDutyValue()
+              << "/" << pwm.getPolarityValue() << " (" << pwm.getValue() << "%)" << std::endl;
+    std::cout << "pwmchip group error state: \t\t" << std::boolalpha << group.fail() << std::endl;
+}
+
+void benchmark_Watcher()
+{
+    std::string ocp     = benchRoot + "/sys/devices/ocp.3/";
+    std::string oldName = ocp + "pwm_test_P8_19.16";
+    std::string newName = ocp + "pwm_test_P8_19.30";
+    timespec start, end;
+
+    BlackLib::BlackCore::startDiscoveryWatcher();
+    BlackLib::BlackPWM  pwm(BlackLib::P8_19, BlackLib::sysfsBackend);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for( int i = 0 ; i < iterations ; i++ )
+    {
+        pwm.setDutyPercent(static_cast<float>(i % 100));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double hotPathNs = elapsedNs(start, end) / iterations;
+
+    // overlay is loaded again with another driver instance number
+    uint64_t generation = BlackLib::BlackDiscoveryIndex::instance().getGeneration();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    rename(oldName.c_str(), newName.c_str());
+    for( int i = 0 ; i < 1000000 and BlackLib::BlackDiscoveryIndex::instance().getGeneration() == generation ; i++ )
+    {
+        usleep(10);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    pwm.setDutyPercent(30.0);
+    std::ifstream dutyFile((newName + "/duty").c_str());
+    int64_t duty = -1;
+    dutyFile >> duty;
+
+    BlackLib::BlackCore::stopDiscoveryWatcher();
+    rename(newName.c_str(), oldName.c_str());
+    BlackLib::BlackDiscoveryIndex::instance().invalidate(ocp);
+
+    std::cout << "setDutyPercent with watcher running:\t" << hotPathNs << " ns/call" << std::endl;
+    std::cout << "watcher refresh after rename:       \t" << elapsedNs(start, end) / 1000 << " us" << std::endl;
+    std::cout << "duty at new pwm_test directory:     \t" << duty << " (" << std::boolalpha << pwm.fail() << ")" << std::endl;
+
+    std::cout << "same, process started from cache:   \t" << std::flush;
+    pid_t child = fork();
+    if( child == 0 )
+    {
+        execl("/proc/self/exe", "pwmbench", "watch", (benchRoot + "/discovery.cache").c_str(), (char *)NULL);
+        _exit(127);
+    }
+
+    int status = 0;
+    waitpid(child, &status, 0);
+}
+
+int main(int argc, char *argv[])
+{
+    if( argc == 3 and std::string(argv[1]) == "startup" )
+    {
+        return startupChild(argv[2]);
+    }
+    if( argc == 3 and std::string(argv[1]) == "watch" )
+    {
+        return watchChild(argv[2]);
+    }
+
+    makeStandInTree();
+    benchmark_Startup();
+
+    BlackLib::BlackCore::setFilesystemRoot(benchRoot);
+
+    benchmark_BringUp();
+    benchmark_Construction();
+    benchmark_DutyUpdate();
+    benchmark_ShadowReads();
+    benchmark_Retune();
+    benchmark_Group();
+    benchmark_Stream();
+    benchmark_Conversion();
+    benchmark_RegisterBackend();
+    benchmark_PwmChip();
+    benchmark_Watcher();
+    return 0;
+}
@@ -19,13 +19,8 @@ void example_PWM()
 
     BlackLib::BlackPWM    pwmLed(BlackLib::EHRPWM2A);
 
-    // if new period value is less than the current duty value, the new period value setting
-    // operation couldn't execute. So firstly duty value is set to zero for safe steps.
-    pwmLed.setDutyPercent(0.0);
-    pwmLed.setPeriodTime(100000);
-    sleep(1);
-
-    pwmLed.setSpaceRatioTime(67, BlackLib::microsecond);
+    // period and duty are changed together, in a legal order for the current duty value.
+    pwmLed.setPeriodAndDuty(100000, 67000);
 
     std::cout << "DUTY after setting space time: \t\t" << pwmLed.getDutyValue() << std::endl;
 